@@ -9,6 +9,18 @@ bool ep00_Extractor::verify(
   return VerifyEpicsConnectionInfoBuffer(Verifier);
 }
 
+bool ep00_Extractor::verifyPacketInfo(
+    FileWriter::FlatbufferMessage const &Message) const {
+  flatbuffers::Verifier Verifier(
+      reinterpret_cast<const uint8_t *>(Message.data()), Message.size());
+  auto const Root = GetEpicsConnectionInfo(Message.data());
+  return Root->VerifyTableStart(Verifier) and
+         Root->VerifyField<uint64_t>(Verifier,
+                                     EpicsConnectionInfo::VT_TIMESTAMP) and
+         Root->VerifyOffset(Verifier, EpicsConnectionInfo::VT_SOURCE_NAME) and
+         Verifier.VerifyString(Root->source_name());
+}
+
 std::string ep00_Extractor::source_name(
     FileWriter::FlatbufferMessage const &Message) const {
   auto FBuffer = GetEpicsConnectionInfo(Message.data());
@@ -17,6 +17,7 @@ using FlatbufferMessage = FileWriter::FlatbufferMessage;
 class ep00_Extractor : public FileWriter::FlatbufferReader {
 public:
   bool verify(FlatbufferMessage const &Message) const override;
+  bool verifyPacketInfo(FlatbufferMessage const &Message) const override;
   std::string source_name(FlatbufferMessage const &Message) const override;
   uint64_t timestamp(FlatbufferMessage const &Message) const override;
 };
@@ -18,6 +18,17 @@ bool ev42_Extractor::verify(FlatbufferMessage const &Message) const {
   return VerifyEventMessageBuffer(VerifierInstance);
 }
 
+bool ev42_Extractor::verifyPacketInfo(FlatbufferMessage const &Message) const {
+  flatbuffers::Verifier VerifierInstance(
+      reinterpret_cast<const uint8_t *>(Message.data()), Message.size());
+  auto const Root = GetEventMessage(Message.data());
+  return Root->VerifyTableStart(VerifierInstance) and
+         Root->VerifyField<uint64_t>(VerifierInstance,
+                                     EventMessage::VT_PULSE_TIME) and
+         Root->VerifyOffset(VerifierInstance, EventMessage::VT_SOURCE_NAME) and
+         VerifierInstance.VerifyString(Root->source_name());
+}
+
 std::string
 ev42_Extractor::source_name(FlatbufferMessage const &Message) const {
   auto fbuf = GetEventMessage(Message.data());
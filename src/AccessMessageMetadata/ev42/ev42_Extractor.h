@@ -16,6 +16,7 @@ public:
   ev42_Extractor() = default;
   ~ev42_Extractor() = default;
   bool verify(FlatbufferMessage const &Message) const override;
+  bool verifyPacketInfo(FlatbufferMessage const &Message) const override;
   std::string source_name(FlatbufferMessage const &Message) const override;
   uint64_t timestamp(FlatbufferMessage const &Message) const override;
 
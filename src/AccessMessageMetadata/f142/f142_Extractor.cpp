@@ -18,6 +18,16 @@ bool f142_Extractor::verify(FlatbufferMessage const &Message) const {
   return VerifyLogDataBuffer(Verifier);
 }
 
+bool f142_Extractor::verifyPacketInfo(FlatbufferMessage const &Message) const {
+  flatbuffers::Verifier Verifier(
+      reinterpret_cast<const uint8_t *>(Message.data()), Message.size());
+  auto const Root = GetLogData(Message.data());
+  return Root->VerifyTableStart(Verifier) and
+         Root->VerifyField<uint64_t>(Verifier, LogData::VT_TIMESTAMP) and
+         Root->VerifyOffset(Verifier, LogData::VT_SOURCE_NAME) and
+         Verifier.VerifyString(Root->source_name());
+}
+
 /// Extract name of source from the message
 std::string
 f142_Extractor::source_name(FlatbufferMessage const &Message) const {
@@ -17,6 +17,16 @@ bool hs00_Extractor::verify(FlatbufferMessage const &Message) const {
   return VerifyEventHistogramBuffer(Verifier);
 }
 
+bool hs00_Extractor::verifyPacketInfo(FlatbufferMessage const &Message) const {
+  flatbuffers::Verifier Verifier(
+      reinterpret_cast<const uint8_t *>(Message.data()), Message.size());
+  auto const Root = GetEventHistogram(Message.data());
+  return Root->VerifyTableStart(Verifier) and
+         Root->VerifyField<uint64_t>(Verifier, EventHistogram::VT_TIMESTAMP) and
+         Root->VerifyOffset(Verifier, EventHistogram::VT_SOURCE) and
+         Verifier.VerifyString(Root->source());
+}
+
 std::string
 hs00_Extractor::source_name(FlatbufferMessage const &Message) const {
   auto Buffer = GetEventHistogram(Message.data());
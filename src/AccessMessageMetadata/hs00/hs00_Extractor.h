@@ -15,6 +15,7 @@ namespace AccessMessageMetadata {
 using FlatbufferMessage = FileWriter::FlatbufferMessage;
 class hs00_Extractor : public FileWriter::FlatbufferReader {
   bool verify(FlatbufferMessage const &Message) const override;
+  bool verifyPacketInfo(FlatbufferMessage const &Message) const override;
   std::string source_name(FlatbufferMessage const &Message) const override;
   uint64_t timestamp(FlatbufferMessage const &Message) const override;
 };
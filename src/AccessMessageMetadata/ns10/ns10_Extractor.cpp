@@ -24,6 +24,17 @@ bool ns10_Extractor::verify(
   return VerifyCacheEntryBuffer(Verifier);
 }
 
+bool ns10_Extractor::verifyPacketInfo(
+    FileWriter::FlatbufferMessage const &Message) const {
+  flatbuffers::Verifier Verifier(
+      reinterpret_cast<const uint8_t *>(Message.data()), Message.size());
+  auto const Root = GetCacheEntry(Message.data());
+  return Root->VerifyTableStart(Verifier) and
+         Root->VerifyField<double>(Verifier, CacheEntry::VT_TIME) and
+         Root->VerifyOffset(Verifier, CacheEntry::VT_KEY) and
+         Verifier.VerifyString(Root->key());
+}
+
 std::string ns10_Extractor::source_name(
     FileWriter::FlatbufferMessage const &Message) const {
   auto Entry = GetCacheEntry(Message.data());
@@ -21,6 +21,7 @@ using FlatbufferMessage = FileWriter::FlatbufferMessage;
 class ns10_Extractor : public FileWriter::FlatbufferReader {
 public:
   bool verify(FlatbufferMessage const &Message) const override;
+  bool verifyPacketInfo(FlatbufferMessage const &Message) const override;
 
   std::string source_name(FlatbufferMessage const &Message) const override;
 
@@ -27,6 +27,17 @@ bool senv_Extractor::verify(FlatbufferMessage const &Message) const {
   return VerifySampleEnvironmentDataBuffer(Verifier);
 }
 
+bool senv_Extractor::verifyPacketInfo(FlatbufferMessage const &Message) const {
+  flatbuffers::Verifier Verifier(
+      reinterpret_cast<const uint8_t *>(Message.data()), Message.size());
+  auto const Root = GetSampleEnvironmentData(Message.data());
+  return Root->VerifyTableStart(Verifier) and
+         Root->VerifyField<uint64_t>(
+             Verifier, SampleEnvironmentData::VT_PACKETTIMESTAMP) and
+         Root->VerifyOffset(Verifier, SampleEnvironmentData::VT_NAME) and
+         Verifier.VerifyString(Root->Name());
+}
+
 uint64_t senv_Extractor::timestamp(FlatbufferMessage const &Message) const {
   auto FbPointer = GetSampleEnvironmentData(Message.data());
   return FbPointer->PacketTimestamp();
@@ -24,6 +24,7 @@ using FBReaderBase = FileWriter::FlatbufferReader;
 class senv_Extractor : public FBReaderBase {
 public:
   bool verify(FlatbufferMessage const &Message) const override;
+  bool verifyPacketInfo(FlatbufferMessage const &Message) const override;
   std::string source_name(FlatbufferMessage const &Message) const override;
   uint64_t timestamp(FlatbufferMessage const &Message) const override;
 };
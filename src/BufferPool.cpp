@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "BufferPool.h"
+#include "MemoryAccountant.h"
+#include "Metrics/Registrar.h"
+
+namespace FileWriter {
+
+void PooledBufferDeleter::operator()(std::uint8_t *Buffer) const {
+  if (Pool == nullptr) {
+    delete[] Buffer;
+    return;
+  }
+  Pool->release(Buffer, SizeClass, Bytes);
+}
+
+BufferPool::~BufferPool() { clear(); }
+
+BufferPool &BufferPool::getInstance() {
+  static BufferPool Instance;
+  return Instance;
+}
+
+size_t BufferPool::getSizeClass(size_t Size) {
+  size_t SizeClass{0};
+  while (SizeClass < NrOfSizeClasses and
+         getSizeClassCapacity(SizeClass) < Size) {
+    ++SizeClass;
+  }
+  return SizeClass;
+}
+
+PooledBuffer BufferPool::allocate(size_t Size) {
+  auto SizeClass = getSizeClass(Size);
+  if (SizeClass == NrOfSizeClasses) {
+    PoolMisses++;
+    MemoryAccountant::getInstance().add(Size);
+    return PooledBuffer(
+        new std::uint8_t[Size],
+        PooledBufferDeleter{this, PooledBufferDeleter::NotPooled, Size});
+  }
+  auto Capacity = getSizeClassCapacity(SizeClass);
+  MemoryAccountant::getInstance().add(Size);
+  std::uint8_t *Buffer{nullptr};
+  if (FreeBuffers[SizeClass].try_dequeue(Buffer)) {
+    BytesHeld -= Capacity;
+    PooledBytes -= Capacity;
+    PoolHits++;
+  } else {
+    Buffer = new std::uint8_t[Capacity];
+    PoolMisses++;
+  }
+  return PooledBuffer(Buffer, PooledBufferDeleter{this, SizeClass, Size});
+}
+
+void BufferPool::release(std::uint8_t *Buffer, size_t SizeClass,
+                         size_t Bytes) {
+  MemoryAccountant::getInstance().remove(Bytes);
+  if (SizeClass == PooledBufferDeleter::NotPooled) {
+    delete[] Buffer;
+    return;
+  }
+  auto Capacity = getSizeClassCapacity(SizeClass);
+  if (BytesHeld.fetch_add(Capacity) + Capacity > MaxBytesHeld.load() or
+      not FreeBuffers[SizeClass].enqueue(Buffer)) {
+    BytesHeld -= Capacity;
+    delete[] Buffer;
+    return;
+  }
+  PooledBytes += Capacity;
+}
+
+void BufferPool::clear() {
+  for (size_t SizeClass = 0; SizeClass < NrOfSizeClasses; ++SizeClass) {
+    std::uint8_t *Buffer{nullptr};
+    while (FreeBuffers[SizeClass].try_dequeue(Buffer)) {
+      BytesHeld -= getSizeClassCapacity(SizeClass);
+      PooledBytes -= getSizeClassCapacity(SizeClass);
+      delete[] Buffer;
+    }
+  }
+}
+
+void BufferPool::registerMetrics(Metrics::Registrar const &Registrar) {
+  auto UsedRegistrar = Registrar;
+  UsedRegistrar.registerMetric(PoolHits, {Metrics::LogTo::CARBON});
+  UsedRegistrar.registerMetric(PoolMisses, {Metrics::LogTo::CARBON});
+  UsedRegistrar.registerMetric(PooledBytes, {Metrics::LogTo::CARBON});
+}
+
+} // namespace FileWriter
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#pragma once
+
+#include "Metrics/Metric.h"
+#include <array>
+#include <atomic>
+#include <concurrentqueue/concurrentqueue.h>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+namespace Metrics {
+class Registrar;
+}
+
+namespace FileWriter {
+
+class BufferPool;
+
+/// \brief Returns a buffer to the pool it was taken from (or deletes it if it
+/// was not taken from a pool).
+struct PooledBufferDeleter {
+  static constexpr size_t NotPooled{std::numeric_limits<size_t>::max()};
+  BufferPool *Pool{nullptr};
+  size_t SizeClass{NotPooled};
+  /// The requested size, as reported to the MemoryAccountant.
+  size_t Bytes{0};
+  void operator()(std::uint8_t *Buffer) const;
+};
+
+using PooledBuffer = std::unique_ptr<std::uint8_t[], PooledBufferDeleter>;
+
+/// \brief Size-classed pool of message buffers.
+///
+/// Message buffers are allocated on the consumer threads and (mostly) released
+/// on the writer thread. Recycling them here instead of going through the
+/// heap every time avoids allocator contention between those threads. Each
+/// size class (powers of two) has its own lock free free-list.
+///
+/// The amount of memory held by unused buffers is capped. Buffers that are
+/// larger than the largest size class are not pooled. All buffers handed out
+/// are reported to the MemoryAccountant.
+class BufferPool {
+public:
+  static constexpr size_t MinSizeClassLog2{6};  // 64 bytes
+  static constexpr size_t MaxSizeClassLog2{26}; // 64 MiB
+  static constexpr size_t NrOfSizeClasses{MaxSizeClassLog2 -
+                                          MinSizeClassLog2 + 1};
+  static constexpr size_t DefaultMaxBytesHeld{256 * 1024 * 1024};
+
+  explicit BufferPool(size_t MaxBytesInPool = DefaultMaxBytesHeld)
+      : MaxBytesHeld(MaxBytesInPool) {}
+  BufferPool(BufferPool const &) = delete;
+  BufferPool &operator=(BufferPool const &) = delete;
+  ~BufferPool();
+
+  /// \brief The pool used for Kafka and flatbuffer messages.
+  static BufferPool &getInstance();
+
+  /// \brief Get a buffer of (at least) the requested size.
+  PooledBuffer allocate(size_t Size);
+
+  /// \brief Return a buffer to the pool. Called by PooledBufferDeleter.
+  void release(std::uint8_t *Buffer, size_t SizeClass, size_t Bytes);
+
+  /// \brief Free all unused buffers held by the pool.
+  void clear();
+
+  void registerMetrics(Metrics::Registrar const &Registrar);
+  void setMaxBytesHeld(size_t MaxBytes) { MaxBytesHeld = MaxBytes; }
+  size_t getBytesHeld() const { return BytesHeld.load(); }
+  auto nrOfHits() const { return int64_t(PoolHits); }
+  auto nrOfMisses() const { return int64_t(PoolMisses); }
+
+  /// \brief Get the index of the smallest size class that will fit the
+  /// requested size.
+  ///
+  /// \return Returns NrOfSizeClasses if the size is too large to be pooled.
+  static size_t getSizeClass(size_t Size);
+  static size_t getSizeClassCapacity(size_t SizeClass) {
+    return size_t(1) << (MinSizeClassLog2 + SizeClass);
+  }
+
+private:
+  std::array<moodycamel::ConcurrentQueue<std::uint8_t *>, NrOfSizeClasses>
+      FreeBuffers;
+  std::atomic<size_t> BytesHeld{0};
+  std::atomic<size_t> MaxBytesHeld;
+  Metrics::Metric PoolHits{"hits",
+                           "Number of message buffers re-used from the pool."};
+  Metrics::Metric PoolMisses{
+      "misses", "Number of message buffers that had to be allocated."};
+  Metrics::Gauge PooledBytes{
+      "bytes_held", "Number of bytes held by the pool in unused buffers."};
+};
+
+} // namespace FileWriter
@@ -173,8 +173,16 @@ void setCLIOptions(CLI::App &App, MainOpt &MainOptions) {
                  "<absolute/or/relative/directory> Directory which gets "
                  "prepended to the HDF output filenames in the file write "
                  "commands");
+  App.add_option("--scratch-directory", MainOptions.ScratchDirectory,
+                 "<local/directory> Write the HDF files in this directory "
+                 "(preferably on fast local storage) and move them to the "
+                 "output directory (--hdf-output-prefix) in the background "
+                 "when they have been written. Disabled if not set.");
   App.add_option("--log-file", MainOptions.LogFilename,
                  "Specify file to log to");
+  App.add_flag("--log-async", MainOptions.AsyncLogging,
+               "Write log messages from a background thread. If the logging "
+               "falls behind, the oldest messages are dropped.");
   App.add_option(
       "--service-id", MainOptions.ServiceID,
       "Used as the service identifier in status messages and as an"
@@ -211,10 +219,85 @@ void setCLIOptions(CLI::App &App, MainOpt &MainOptions) {
       MainOptions.StreamerConfiguration.DataFlushInterval,
       "(Max) amount of time between flushing of data to file, in seconds.",
       true);
+  App.add_option(
+      "--flatbuffer-verify-first-n",
+      MainOptions.StreamerConfiguration.FlatbufferVerification
+          .FullyVerifiedMessages,
+      "Number of messages at the start of every topic partition that are "
+      "always fully verified. Only used if the sample interval is > 1.",
+      true);
+  App.add_option(
+      "--flatbuffer-verify-sample-interval",
+      MainOptions.StreamerConfiguration.FlatbufferVerification.SampleInterval,
+      "Only fully verify 1 in N flatbuffers (after the initial messages), "
+      "the rest get a cheap bounds check. Only use with trusted producers. "
+      "Reverts to full verification on the first bad message.",
+      true);
+  App.add_option(
+      "--spool-directory",
+      MainOptions.StreamerConfiguration.MessageSpooling.Directory,
+      "<local/directory> Spool messages to memory mapped files in this "
+      "directory (preferably on fast local storage) before writing them to "
+      "file. Decouples consumption of data from Kafka from the speed of the "
+      "file writing. Disabled if not set.");
+  App.add_option(
+      "--spool-segment-size",
+      MainOptions.StreamerConfiguration.MessageSpooling.SegmentSize,
+      "Size in bytes of the message spool segment files.", true);
+  App.add_option(
+      "--record", MainOptions.StreamerConfiguration.RecordDirectory,
+      "<directory> Record all consumed (command and data) messages to this "
+      "directory so that they can be replayed with --replay.");
+  App.add_option(
+      "--replay", MainOptions.StreamerConfiguration.ReplayDirectory,
+      "<directory> Replay messages recorded with --record instead of "
+      "consuming them from Kafka. Exits when the (first) replayed file "
+      "writing job is done.");
+  App.add_option("--max-buffered-bytes", MainOptions.MaxBufferedBytes,
+                 "Ceiling for the memory used by all in-flight messages. "
+                 "Consumption of data is throttled (highest data rate "
+                 "first) when it is reached. Set to 0 for no ceiling.",
+                 true);
   addKafkaOption(
       App, "-X,--kafka-config",
       MainOptions.StreamerConfiguration.BrokerSettings.KafkaConfiguration,
       "LibRDKafka options");
+  App.add_option(
+      "--trace-file", MainOptions.TraceFilename,
+      "<file> Write the most recent trace spans of the hot path (as Chrome "
+      "trace event JSON) to this file when receiving SIGUSR1 and on exit. "
+      "Requires a build with ENABLE_TRACING.");
+  App.add_option("--file-access-profile", MainOptions.FileAccessProfileName,
+                 "HDF5 file access profile for new files: \"default\" or "
+                 "\"parallel_filesystem\" (large aligned blocks and a large "
+                 "metadata cache, for e.g. Lustre and GPFS).",
+                 true);
+  App.add_option(
+      "--file-access-settings", MainOptions.FileAccessSettings,
+      "<json> HDF5 file access settings applied on top of the profile, e.g. "
+      "'{\"alignment\": 4194304, \"metadata_cache_max_size\": 33554432}'. "
+      "See the documentation for the available settings.");
+  App.add_option(
+      "--skeleton-cache-directory", MainOptions.SkeletonCacheDirectory,
+      "<local/directory> Cache \"skeleton\" files (files with the HDF "
+      "structure but no data) in this directory and create new files with "
+      "an already seen NeXus structure by copying the skeleton file. "
+      "Disabled if not set.");
+  App.add_option(
+      "--skeleton-volatile-attributes", MainOptions.SkeletonVolatileAttributes,
+      "Names of attributes (e.g. title) that do not change the structure of "
+      "a file. They are ignored when looking up a skeleton file and are "
+      "written to each file created from it.");
+  App.add_option(
+      "--skeleton-volatile-datasets", MainOptions.SkeletonVolatileDatasets,
+      "Paths of datasets (e.g. /entry/title /entry/start_time) that do not "
+      "change the structure of a file. They are left out of skeleton files "
+      "and are written to each file created from one.");
+  App.add_option("--skeleton-cache-max-size", MainOptions.SkeletonCacheMaxSize,
+                 "<bytes> Maximum total size of the skeleton files, the least "
+                 "recently used ones are removed when it is exceeded. 0 means "
+                 "no limit.",
+                 true);
   App.add_option("--abort-on-uninitialised-stream",
                  MainOptions.AbortOnUninitialisedStream,
                  "Writer aborts the whole job if one or more streams are "
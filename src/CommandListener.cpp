@@ -8,6 +8,8 @@
 // Screaming Udder!                              https://esss.se
 
 #include <Kafka/ConsumerFactory.h>
+#include <Kafka/RecordingConsumer.h>
+#include <Kafka/ReplayConsumer.h>
 
 #include "CommandListener.h"
 #include "Kafka/PollStatus.h"
@@ -23,7 +25,17 @@ void CommandListener::start() {
   Kafka::BrokerSettings BrokerSettings =
       config.StreamerConfiguration.BrokerSettings;
   BrokerSettings.Address = config.CommandBrokerURI.HostPort;
-  Consumer = Kafka::createConsumer(BrokerSettings, BrokerSettings.Address);
+  auto const &ReplayDirectory = config.StreamerConfiguration.ReplayDirectory;
+  auto const &RecordDirectory = config.StreamerConfiguration.RecordDirectory;
+  if (not ReplayDirectory.empty()) {
+    Consumer = std::make_unique<Kafka::ReplayConsumer>(ReplayDirectory);
+  } else {
+    Consumer = Kafka::createConsumer(BrokerSettings, BrokerSettings.Address);
+    if (not RecordDirectory.empty()) {
+      Consumer = std::make_unique<Kafka::RecordingConsumer>(
+          std::move(Consumer), RecordDirectory);
+    }
+  }
   Consumer->addTopic(config.CommandBrokerURI.Topic);
 }
 
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "FileAccessProfile.h"
+#include <algorithm>
+#include <fmt/format.h>
+#include <stdexcept>
+
+namespace FileWriter {
+
+namespace {
+void throwOnError(herr_t Result, char const *Setting) {
+  if (Result < 0) {
+    throw std::runtime_error(fmt::format(
+        "Unable to set the {} of the file access property list.", Setting));
+  }
+}
+
+H5F_libver_t getLibraryVersion(std::string const &Version) {
+  if (Version == "latest") {
+    return H5F_LIBVER_LATEST;
+  }
+  if (Version == "v110") {
+#if H5_VERSION_GE(1, 10, 2)
+    return H5F_LIBVER_V110;
+#else
+    return H5F_LIBVER_LATEST;
+#endif
+  }
+  throw std::runtime_error(fmt::format(
+      "Unknown library version \"{}\", use \"v110\" or \"latest\".", Version));
+}
+void checkDriver(std::string const &Driver) {
+  if (Driver != "sec2" and Driver != "core") {
+    throw std::runtime_error(fmt::format(
+        "Unknown file driver \"{}\", use \"sec2\" or \"core\".", Driver));
+  }
+}
+} // namespace
+
+hdf5::property::FileAccessList
+FileAccessProfile::createFileAccessList() const {
+  hdf5::property::FileAccessList AccessList;
+  auto Id = static_cast<hid_t>(AccessList);
+  throwOnError(H5Pset_libver_bounds(Id,
+                                    getLibraryVersion(LibraryVersionLowBound),
+                                    H5F_LIBVER_LATEST),
+               "library version bounds");
+  if (Alignment > 0) {
+    throwOnError(H5Pset_alignment(Id, AlignmentThreshold, Alignment),
+                 "alignment");
+  }
+  if (MetaBlockSize > 0) {
+    throwOnError(H5Pset_meta_block_size(Id, MetaBlockSize), "meta block size");
+  }
+  if (SieveBufferSize > 0) {
+    throwOnError(H5Pset_sieve_buf_size(Id, SieveBufferSize),
+                 "sieve buffer size");
+  }
+  if (MetadataCacheInitialSize > 0 or MetadataCacheMaxSize > 0) {
+    H5AC_cache_config_t CacheConfig;
+    CacheConfig.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+    throwOnError(H5Pget_mdc_config(Id, &CacheConfig), "metadata cache");
+    if (MetadataCacheInitialSize > 0) {
+      CacheConfig.set_initial_size = true;
+      CacheConfig.initial_size = MetadataCacheInitialSize;
+    }
+    if (MetadataCacheMaxSize > 0) {
+      CacheConfig.max_size = MetadataCacheMaxSize;
+    }
+    // HDF5 requires min_size <= initial_size <= max_size.
+    CacheConfig.max_size =
+        std::max(CacheConfig.max_size, CacheConfig.initial_size);
+    CacheConfig.min_size =
+        std::min(CacheConfig.min_size, CacheConfig.initial_size);
+    throwOnError(H5Pset_mdc_config(Id, &CacheConfig), "metadata cache");
+  }
+  checkDriver(Driver);
+  if (inMemory()) {
+    throwOnError(H5Pset_fapl_core(Id, CoreIncrement, true), "core driver");
+    if (CorePageSize > 0) {
+      throwOnError(H5Pset_core_write_tracking(Id, true, CorePageSize),
+                   "core driver write tracking");
+    }
+    // Close all objects of the file when closing it, so that it can be
+    // re-opened with the sec2 driver (see HDFFile::switchToDefaultDriver()).
+    throwOnError(H5Pset_fclose_degree(Id, H5F_CLOSE_STRONG), "close degree");
+  }
+  return AccessList;
+}
+
+FileAccessProfile getFileAccessProfile(std::string const &Name) {
+  if (Name == "default") {
+    return {};
+  }
+  if (Name == "parallel_filesystem") {
+    FileAccessProfile Profile;
+    Profile.AlignmentThreshold = 1024 * 1024;
+    Profile.Alignment = 1024 * 1024;
+    Profile.MetaBlockSize = 1024 * 1024;
+    Profile.SieveBufferSize = 4 * 1024 * 1024;
+    Profile.MetadataCacheInitialSize = 16 * 1024 * 1024;
+    Profile.MetadataCacheMaxSize = 64 * 1024 * 1024;
+    return Profile;
+  }
+  if (Name == "in_memory") {
+    FileAccessProfile Profile;
+    Profile.Driver = "core";
+    Profile.CorePageSize = 4 * 1024 * 1024;
+    Profile.CoreMemoryLimit = std::size_t{1024} * 1024 * 1024;
+    return Profile;
+  }
+  throw std::runtime_error(fmt::format(
+      "Unknown file access profile \"{}\", use \"default\", "
+      "\"parallel_filesystem\" or \"in_memory\".",
+      Name));
+}
+
+FileAccessProfile applyFileAccessSettings(nlohmann::json const &Settings,
+                                          FileAccessProfile Profile) {
+  if (not Settings.is_object()) {
+    throw std::runtime_error("The file access settings must be a JSON object.");
+  }
+  try {
+    if (auto Name = find<std::string>("profile", Settings)) {
+      Profile = getFileAccessProfile(*Name);
+    }
+    for (auto It = Settings.cbegin(); It != Settings.cend(); ++It) {
+      auto const &Key = It.key();
+      auto const &Value = It.value();
+      if (Key == "profile") {
+        continue;
+      } else if (Key == "alignment_threshold") {
+        Profile.AlignmentThreshold = Value.get<hsize_t>();
+      } else if (Key == "alignment") {
+        Profile.Alignment = Value.get<hsize_t>();
+      } else if (Key == "meta_block_size") {
+        Profile.MetaBlockSize = Value.get<hsize_t>();
+      } else if (Key == "sieve_buffer_size") {
+        Profile.SieveBufferSize = Value.get<std::size_t>();
+      } else if (Key == "metadata_cache_initial_size") {
+        Profile.MetadataCacheInitialSize = Value.get<std::size_t>();
+      } else if (Key == "metadata_cache_max_size") {
+        Profile.MetadataCacheMaxSize = Value.get<std::size_t>();
+      } else if (Key == "library_version_low_bound") {
+        Profile.LibraryVersionLowBound = Value.get<std::string>();
+        // Throws if the version is not known.
+        getLibraryVersion(Profile.LibraryVersionLowBound);
+      } else if (Key == "driver") {
+        Profile.Driver = Value.get<std::string>();
+        checkDriver(Profile.Driver);
+      } else if (Key == "core_increment") {
+        Profile.CoreIncrement = Value.get<std::size_t>();
+      } else if (Key == "core_page_size") {
+        Profile.CorePageSize = Value.get<std::size_t>();
+      } else if (Key == "core_memory_limit") {
+        Profile.CoreMemoryLimit = Value.get<std::size_t>();
+      } else {
+        throw std::runtime_error(
+            fmt::format("Unknown file access setting \"{}\".", Key));
+      }
+    }
+  } catch (nlohmann::json::exception const &E) {
+    throw std::runtime_error(
+        fmt::format("Invalid file access settings: {}", E.what()));
+  }
+  return Profile;
+}
+
+} // namespace FileWriter
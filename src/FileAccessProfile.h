@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#pragma once
+
+#include "json.h"
+#include <cstddef>
+#include <h5cpp/hdf5.hpp>
+#include <string>
+
+namespace FileWriter {
+
+/// \brief HDF5 file access settings used when creating and opening files.
+///
+/// A size of 0 means that the HDF5 default is used.
+struct FileAccessProfile {
+  /// Objects (e.g. dataset chunks) of at least this size (in bytes) are
+  /// aligned to Alignment.
+  hsize_t AlignmentThreshold{1};
+  hsize_t Alignment{0};
+  /// Minimum size of the blocks allocated for metadata.
+  hsize_t MetaBlockSize{0};
+  /// Size of the buffer used for data sieving of contiguous datasets.
+  std::size_t SieveBufferSize{0};
+  std::size_t MetadataCacheInitialSize{0};
+  std::size_t MetadataCacheMaxSize{0};
+  /// The oldest file format version that may be used, "v110" or "latest".
+  /// SWMR requires at least "v110".
+  std::string LibraryVersionLowBound{"latest"};
+  /// The HDF5 file driver, "sec2" (the HDF5 default) or "core". The core
+  /// driver keeps the whole file in memory and writes it to disk when it is
+  /// flushed or closed.
+  std::string Driver{"sec2"};
+  /// Size of the blocks by which the memory of a file of the core driver
+  /// grows.
+  std::size_t CoreIncrement{64 * 1024 * 1024};
+  /// If > 0, only the changed parts of a file of the core driver are written
+  /// to disk when it is flushed, in blocks of this size. Otherwise the file
+  /// is only written to disk when it is closed.
+  std::size_t CorePageSize{0};
+  /// Maximum size of a file of the core driver. The file is switched to the
+  /// sec2 driver if it would be exceeded. 0 means no limit.
+  std::size_t CoreMemoryLimit{0};
+
+  bool inMemory() const { return Driver == "core"; }
+
+  hdf5::property::FileAccessList createFileAccessList() const;
+};
+
+/// \brief Get a predefined file access profile.
+///
+/// \param Name "default" (HDF5 defaults), "parallel_filesystem" (large
+/// aligned blocks and a large metadata cache, for e.g. Lustre and GPFS) or
+/// "in_memory" (the core driver, for short runs with high data rates).
+/// \return The profile, throws std::runtime_error if there is no profile with
+/// the name.
+FileAccessProfile getFileAccessProfile(std::string const &Name);
+
+/// \brief Apply file access settings given as a JSON object to a profile.
+///
+/// The object can have the keys "profile" (the name of a predefined profile to
+/// start from), "alignment_threshold", "alignment", "meta_block_size",
+/// "sieve_buffer_size", "metadata_cache_initial_size",
+/// "metadata_cache_max_size", "library_version_low_bound", "driver",
+/// "core_increment", "core_page_size" and "core_memory_limit". Throws
+/// std::runtime_error on unknown keys or invalid values.
+///
+/// \param Settings The settings.
+/// \param Profile The profile to apply the settings to.
+/// \return The resulting profile.
+FileAccessProfile applyFileAccessSettings(nlohmann::json const &Settings,
+                                          FileAccessProfile Profile);
+
+} // namespace FileWriter
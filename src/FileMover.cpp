@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "FileMover.h"
+#include "Filesystem.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace FileWriter {
+
+namespace {
+std::size_t const BufferSize{4 * 1024 * 1024};
+
+class FileDescriptor {
+public:
+  FileDescriptor(std::string const &FileName, int Flags)
+      : Descriptor(open(FileName.c_str(), Flags, 0666)) {
+    if (Descriptor == -1) {
+      throw std::runtime_error(fmt::format("Unable to open the file \"{}\": {}",
+                                           FileName, std::strerror(errno)));
+    }
+  }
+  ~FileDescriptor() { close(Descriptor); }
+  FileDescriptor(FileDescriptor const &) = delete;
+  FileDescriptor &operator=(FileDescriptor const &) = delete;
+
+  std::size_t read(char *Buffer, std::size_t Size) {
+    ssize_t Result;
+    do {
+      Result = ::read(Descriptor, Buffer, Size);
+    } while (Result == -1 and errno == EINTR);
+    if (Result == -1) {
+      throw std::runtime_error(
+          fmt::format("Read failed: {}", std::strerror(errno)));
+    }
+    return static_cast<std::size_t>(Result);
+  }
+
+  void write(char const *Buffer, std::size_t Size) {
+    while (Size > 0) {
+      auto Result = ::write(Descriptor, Buffer, Size);
+      if (Result == -1) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw std::runtime_error(
+            fmt::format("Write failed: {}", std::strerror(errno)));
+      }
+      Buffer += Result;
+      Size -= static_cast<std::size_t>(Result);
+    }
+  }
+
+  void sync() {
+    if (fsync(Descriptor) == -1) {
+      throw std::runtime_error(
+          fmt::format("Sync failed: {}", std::strerror(errno)));
+    }
+  }
+
+private:
+  int Descriptor;
+};
+
+std::uint64_t const ChecksumOffsetBasis{0xcbf29ce484222325ULL};
+
+void updateChecksum(std::uint64_t &Checksum, char const *Buffer,
+                    std::size_t Size) {
+  for (std::size_t i = 0; i < Size; ++i) {
+    Checksum ^= static_cast<unsigned char>(Buffer[i]);
+    Checksum *= 0x100000001b3ULL;
+  }
+}
+} // namespace
+
+std::uint64_t calculateFileChecksum(std::string const &FileName) {
+  FileDescriptor File(FileName, O_RDONLY);
+  std::vector<char> Buffer(BufferSize);
+  auto Checksum = ChecksumOffsetBasis;
+  while (auto Size = File.read(Buffer.data(), Buffer.size())) {
+    updateChecksum(Checksum, Buffer.data(), Size);
+  }
+  return Checksum;
+}
+
+FileMover::FileMover(std::size_t MaxFinishedMoves)
+    : MaxFinished(MaxFinishedMoves) {}
+
+void FileMover::moveFile(std::string const &Source,
+                         std::string const &Destination) {
+  std::size_t MoveId;
+  {
+    std::lock_guard<std::mutex> Lock(MovesMutex);
+    MoveId = NextMoveId++;
+    Status::FileMoveInfo Info;
+    Info.Source = Source;
+    Info.Destination = Destination;
+    Info.State = "queued";
+    Moves.push_back({MoveId, std::move(Info)});
+  }
+  Logger->info("Queued move of the file \"{}\" to \"{}\".", Source,
+               Destination);
+  Executor.sendWork([this, MoveId]() { doMove(MoveId); });
+}
+
+std::vector<Status::FileMoveInfo> FileMover::getMoveInfo() const {
+  std::lock_guard<std::mutex> Lock(MovesMutex);
+  std::vector<Status::FileMoveInfo> Result;
+  Result.reserve(Moves.size());
+  for (auto const &CurrentMove : Moves) {
+    Result.push_back(CurrentMove.Info);
+  }
+  return Result;
+}
+
+std::deque<FileMover::Move>::iterator FileMover::findMove(std::size_t MoveId) {
+  return std::find_if(Moves.begin(), Moves.end(), [MoveId](auto const &Item) {
+    return Item.Id == MoveId;
+  });
+}
+
+void FileMover::updateMove(std::size_t MoveId, std::string const &State,
+                           std::uintmax_t BytesMoved,
+                           std::string const &Error) {
+  std::lock_guard<std::mutex> Lock(MovesMutex);
+  auto MoveIt = findMove(MoveId);
+  if (MoveIt == Moves.end()) {
+    return;
+  }
+  MoveIt->Info.State = State;
+  MoveIt->Info.BytesMoved = BytesMoved;
+  MoveIt->Info.Error = Error;
+  auto IsFinished = [](auto const &Item) {
+    return Item.Info.State == "done" or Item.Info.State == "failed";
+  };
+  if (not IsFinished(*MoveIt)) {
+    return;
+  }
+  auto NrOfFinished = static_cast<std::size_t>(
+      std::count_if(Moves.begin(), Moves.end(), IsFinished));
+  for (; NrOfFinished > MaxFinished; --NrOfFinished) {
+    Moves.erase(std::find_if(Moves.begin(), Moves.end(), IsFinished));
+  }
+}
+
+std::uintmax_t FileMover::copyFile(std::size_t MoveId,
+                                   std::string const &Source,
+                                   std::string const &Destination) {
+  FileDescriptor SourceFile(Source, O_RDONLY);
+  FileDescriptor DestinationFile(Destination, O_WRONLY | O_CREAT | O_TRUNC);
+  std::vector<char> Buffer(BufferSize);
+  auto SourceChecksum = ChecksumOffsetBasis;
+  std::uintmax_t BytesMoved{0};
+  while (auto Size = SourceFile.read(Buffer.data(), Buffer.size())) {
+    updateChecksum(SourceChecksum, Buffer.data(), Size);
+    DestinationFile.write(Buffer.data(), Size);
+    BytesMoved += Size;
+    updateMove(MoveId, "moving", BytesMoved);
+  }
+  DestinationFile.sync();
+  auto DestinationChecksum = calculateFileChecksum(Destination);
+  if (DestinationChecksum != SourceChecksum) {
+    throw std::runtime_error(fmt::format(
+        "The checksum of the copy ({:016x}) does not match the checksum of the "
+        "source file ({:016x}).",
+        DestinationChecksum, SourceChecksum));
+  }
+  return BytesMoved;
+}
+
+void FileMover::doMove(std::size_t MoveId) {
+  Status::FileMoveInfo Info;
+  {
+    std::lock_guard<std::mutex> Lock(MovesMutex);
+    auto MoveIt = findMove(MoveId);
+    if (MoveIt == Moves.end()) {
+      return;
+    }
+    Info = MoveIt->Info;
+  }
+  auto const TemporaryDestination = Info.Destination + ".part";
+  try {
+    // As when writing directly to the final location, existing files are
+    // not overwritten. Checked before copying (possibly many GB) and again
+    // before renaming.
+    if (fs::exists(Info.Destination)) {
+      throw std::runtime_error("The destination file already exists.");
+    }
+    auto const Size = fs::file_size(Info.Source);
+    {
+      std::lock_guard<std::mutex> Lock(MovesMutex);
+      findMove(MoveId)->Info.Size = Size;
+    }
+    updateMove(MoveId, "moving");
+    auto BytesMoved = copyFile(MoveId, Info.Source, TemporaryDestination);
+    // The destination might have been created while copying.
+    if (fs::exists(Info.Destination)) {
+      throw std::runtime_error("The destination file already exists.");
+    }
+    fs::rename(TemporaryDestination, Info.Destination);
+    fs::remove(Info.Source);
+    updateMove(MoveId, "done", BytesMoved);
+    Logger->info("Moved the file \"{}\" to \"{}\".", Info.Source,
+                 Info.Destination);
+  } catch (std::exception const &E) {
+    std::error_code IgnoredError;
+    fs::remove(TemporaryDestination, IgnoredError);
+    updateMove(MoveId, "failed", 0, E.what());
+    Logger->error("Unable to move the file \"{}\" to \"{}\", it is left in "
+                  "the scratch directory. The error was: {}",
+                  Info.Source, Info.Destination, E.what());
+  }
+}
+
+} // namespace FileWriter
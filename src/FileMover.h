@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#pragma once
+
+#include "Status/StatusInfo.h"
+#include "ThreadedExecutor.h"
+#include "logger.h"
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace FileWriter {
+
+/// \brief Moves finished files from the (fast, local) scratch directory to
+/// their final location in a background thread.
+///
+/// A file is copied to "<destination>.part", the copy is verified by
+/// comparing its checksum with the checksum of the source file, after which
+/// it is renamed to the destination and the source file is removed. If the
+/// move fails, the source file is left in the scratch directory.
+///
+/// The destructor blocks until all queued moves are done.
+class FileMover {
+public:
+  /// \param MaxFinishedMoves The number of finished (done or failed) moves to
+  /// keep in the move information.
+  explicit FileMover(std::size_t MaxFinishedMoves = 10);
+
+  /// \brief Queue a file to be moved.
+  void moveFile(std::string const &Source, std::string const &Destination);
+
+  /// \brief Get the progress of the queued, ongoing and the most recently
+  /// finished moves.
+  std::vector<Status::FileMoveInfo> getMoveInfo() const;
+
+private:
+  struct Move {
+    std::size_t Id;
+    Status::FileMoveInfo Info;
+  };
+
+  void doMove(std::size_t MoveId);
+  /// \return The number of bytes copied.
+  std::uintmax_t copyFile(std::size_t MoveId, std::string const &Source,
+                          std::string const &Destination);
+  /// Must be called with MovesMutex locked.
+  std::deque<Move>::iterator findMove(std::size_t MoveId);
+  void updateMove(std::size_t MoveId, std::string const &State,
+                  std::uintmax_t BytesMoved = 0,
+                  std::string const &Error = "");
+  std::size_t const MaxFinished;
+  std::size_t NextMoveId{0};
+  std::deque<Move> Moves;
+  mutable std::mutex MovesMutex;
+  SharedLogger Logger = getLogger();
+  // Must be the last member so that the worker thread has exited before the
+  // other members are destroyed.
+  ThreadedExecutor Executor;
+};
+
+/// \brief Calculate the checksum (64 bit FNV-1a) of a file.
+std::uint64_t calculateFileChecksum(std::string const &FileName);
+
+} // namespace FileWriter
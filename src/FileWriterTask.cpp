@@ -9,50 +9,34 @@
 
 #include "FileWriterTask.h"
 #include "HDFFile.h"
+#include "HDFOperations.h"
 #include "Source.h"
+#include "Tracing.h"
 #include "helper.h"
 #include "logger.h"
 #include <atomic>
+#include <limits>
 
 namespace FileWriter {
 
-namespace {
-
-using nlohmann::json;
-
-json hdf_parse(std::string const &Structure, SharedLogger const &Logger) {
-  try {
-    auto StructureDocument = json::parse(Structure);
-    return StructureDocument;
-  } catch (...) {
-    Logger->error("Parse Error: ", Structure);
-    throw FileWriter::ParseError(Structure);
-  }
-}
-} // namespace
-
 std::vector<Source> &FileWriterTask::sources() { return SourceToModuleMap; }
 
 void FileWriterTask::setFilename(std::string const &Prefix,
                                  std::string const &Name) {
-  if (Prefix.empty()) {
-    Filename = Name;
-  } else {
-    Filename = Prefix + "/" + Name;
-  }
+  Filename = prefixPath(Prefix, Name);
 }
 
 void FileWriterTask::addSource(Source &&Source) {
   SourceToModuleMap.push_back(std::move(Source));
 }
 
-void FileWriterTask::InitialiseHdf(std::string const &NexusStructure,
+void FileWriterTask::InitialiseHdf(nlohmann::json NexusStructure,
                                    std::vector<StreamHDFInfo> &HdfInfo) {
-  auto NexusStructureJson = hdf_parse(NexusStructure, Logger);
-
   try {
     Logger->info("Creating HDF file {}", Filename);
-    File = std::make_unique<HDFFile>(Filename, NexusStructureJson, HdfInfo);
+    File = std::make_unique<HDFFile>(Filename, std::move(NexusStructure),
+                                     HdfInfo, AccessProfile);
+    FileInMemory = File->inMemory();
   } catch (std::exception const &E) {
     LOG_ERROR("Failed to initialize HDF file \"{}\". Error was: {}", Filename,
               E.what());
@@ -61,6 +45,28 @@ void FileWriterTask::InitialiseHdf(std::string const &NexusStructure,
   }
 }
 
+void FileWriterTask::InitialiseHdfFromSkeleton(
+    nlohmann::json NexusStructure, std::vector<StreamHDFInfo> &HdfInfo) {
+  try {
+    Logger->info("Opening HDF file {} (created from a skeleton file)",
+                 Filename);
+    File = std::make_unique<HDFFile>(Filename, std::move(NexusStructure),
+                                     HdfInfo, AccessProfile, true);
+    FileInMemory = File->inMemory();
+  } catch (std::exception const &E) {
+    LOG_ERROR("Failed to open HDF file \"{}\". Error was: {}", Filename,
+              E.what());
+    std::throw_with_nested(std::runtime_error(
+        fmt::format("can not open hdf file {}", Filename)));
+  }
+}
+
+void FileWriterTask::startSWMRWrite() { File->startSWMRWrite(); }
+
+void FileWriterTask::setFileAccessProfile(FileAccessProfile Profile) {
+  AccessProfile = std::move(Profile);
+}
+
 std::string FileWriterTask::jobID() const { return JobId; }
 
 hdf5::node::Group FileWriterTask::hdfGroup() const { return File->hdfGroup(); }
@@ -70,8 +76,59 @@ void FileWriterTask::setJobId(std::string const &Id) { JobId = Id; }
 std::string FileWriterTask::filename() const { return Filename; }
 
 void FileWriterTask::flushDataToFile() {
+  TRACE_SPAN("hdf_flush");
   if (File != nullptr) {
     File->flush();
+    checkMemoryLimit();
+  }
+}
+
+std::size_t FileWriterTask::checkMemoryLimit() {
+  if (File == nullptr or not File->inMemory()) {
+    return std::numeric_limits<std::size_t>::max();
+  }
+  if (File->wouldExceedMemoryLimit()) {
+    switchToDefaultDriver();
+    FileInMemory = false;
+    return std::numeric_limits<std::size_t>::max();
+  }
+  FileSizeInMemory = File->fileSize();
+  // Leave a margin for the metadata that is written with the data.
+  return File->memoryHeadroom() / 2;
+}
+
+bool FileWriterTask::inMemory() const {
+  return File != nullptr and File->inMemory();
+}
+
+std::optional<std::uintmax_t> FileWriterTask::sizeInMemory() const {
+  if (not FileInMemory) {
+    return {};
+  }
+  return FileSizeInMemory.load();
+}
+
+void FileWriterTask::switchToDefaultDriver() {
+  File->switchToDefaultDriver();
+  auto RootGroup = File->hdfGroup();
+  for (auto &CurrentSource : SourceToModuleMap) {
+    auto Writer = CurrentSource.getWriterPtr();
+    try {
+      auto StreamGroup =
+          hdf5::node::get_group(RootGroup, CurrentSource.hdfParentName());
+      if (Writer->reopen(StreamGroup) != WriterModule::InitResult::OK) {
+        throw std::runtime_error("The writer module failed to re-open.");
+      }
+      Writer->setDatasetsToFlush(HDFOperations::findDatasets(StreamGroup));
+    } catch (std::exception const &E) {
+      Logger->error("Unable to re-open the datasets of the source \"{}\" "
+                    "after switching the file driver, its data can not be "
+                    "written. The error was: {}",
+                    CurrentSource.sourcename(), E.what());
+      // The datasets to flush were closed with the file, the whole file is
+      // flushed instead.
+      Writer->setDatasetsToFlush({});
+    }
   }
 }
 
@@ -9,10 +9,14 @@
 
 #pragma once
 
+#include "FileAccessProfile.h"
 #include "Source.h"
 #include "json.h"
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -42,12 +46,25 @@ public:
 
   /// Initialise the HDF file.
   ///
-  /// \param NexusStructure The structure of the NeXus file.
+  /// \param NexusStructure The structure of the NeXus file. Is kept by the
+  /// file (for adding links when closing it), pass it as an rvalue to avoid
+  /// a copy.
   /// \param HdfInfo The HDF information for the stream.
-  /// \param UseSwmr Whether to use SWMR.
-  void InitialiseHdf(std::string const &NexusStructure,
+  void InitialiseHdf(nlohmann::json NexusStructure,
                      std::vector<StreamHDFInfo> &HdfInfo);
 
+  /// Open a file that has been created from a skeleton file.
+  ///
+  /// \param NexusStructure The structure of the NeXus file.
+  /// \param HdfInfo The HDF information for the stream.
+  void InitialiseHdfFromSkeleton(nlohmann::json NexusStructure,
+                                 std::vector<StreamHDFInfo> &HdfInfo);
+
+  /// \brief Add the links and switch the file to SWMR mode.
+  ///
+  /// Call after the writer modules have created their datasets.
+  void startSWMRWrite();
+
   /// \brief  Set the `JobID`.
   ///
   /// \param Id The Id value to use.
@@ -64,6 +81,10 @@ public:
   /// \param Name The filename (can include path).
   void setFilename(std::string const &Prefix, std::string const &Name);
 
+  /// \brief Set the file access settings used when creating or opening the
+  /// file.
+  void setFileAccessProfile(FileAccessProfile Profile);
+
   /// \brief Get the list of demuxers.
   ///
   /// \return The demux topics.
@@ -84,14 +105,43 @@ public:
   /// \return The group.
   hdf5::node::Group hdfGroup() const;
 
+  /// \brief Flush the file.
+  ///
+  /// A file kept in memory is switched to the default driver if it would
+  /// reach its memory limit, see checkMemoryLimit().
   void flushDataToFile();
 
+  /// \brief Switch a file kept in memory to the default driver (see
+  /// switchToDefaultDriver()) if it would reach its memory limit.
+  ///
+  /// Call from the thread that writes to the file.
+  /// \return The number of bytes that can be written to the file before it
+  /// has to be checked again.
+  std::size_t checkMemoryLimit();
+
+  /// \brief Whether the file is kept in memory (the core driver).
+  bool inMemory() const;
+
+  /// \brief The size of the memory of a file kept in memory, as of the last
+  /// check of the memory limit.
+  ///
+  /// Can be called from any thread.
+  /// \return Nothing if the file is not kept in memory.
+  std::optional<std::uintmax_t> sizeInMemory() const;
+
 private:
+  /// Write the file to disk, re-open it with the default driver and re-open
+  /// the datasets of the writer modules.
+  void switchToDefaultDriver();
+
   std::string Filename;
   std::vector<Source> SourceToModuleMap;
   std::string JobId;
   std::string ServiceId;
+  FileAccessProfile AccessProfile;
   std::unique_ptr<HDFFile> File;
+  std::atomic_bool FileInMemory{false};
+  std::atomic<std::uintmax_t> FileSizeInMemory{0};
   SharedLogger Logger;
 };
 
@@ -9,26 +9,81 @@
 
 #include "FlatbufferMessage.h"
 #include "FlatbufferReader.h"
+#include <flatbuffers/flatbuffers.h>
+
+namespace {
+/// \brief Cheap structural check of a flatbuffer.
+///
+/// Only checks that the root table, its vtable and the fields referenced by
+/// the vtable are located inside the buffer. Nested tables, vectors and strings
+/// are not checked here, the fields read when extracting the source name and
+/// timestamp are checked by FlatbufferReader::verifyPacketInfo().
+/// \note Assumes that the buffer is at least 8 bytes.
+bool rootTableIsWithinBuffer(uint8_t const *Buffer, size_t Size) {
+  using flatbuffers::ReadScalar;
+  using flatbuffers::soffset_t;
+  using flatbuffers::uoffset_t;
+  using flatbuffers::voffset_t;
+  auto const BufferSize = static_cast<int64_t>(Size);
+  auto const RootOffset = static_cast<int64_t>(ReadScalar<uoffset_t>(Buffer));
+  if (RootOffset < 8 or RootOffset + int64_t(sizeof(soffset_t)) > BufferSize) {
+    return false;
+  }
+  auto const VTableOffset =
+      RootOffset - ReadScalar<soffset_t>(Buffer + RootOffset);
+  if (VTableOffset < 0 or
+      VTableOffset + 2 * int64_t(sizeof(voffset_t)) > BufferSize) {
+    return false;
+  }
+  auto const VTableSize = ReadScalar<voffset_t>(Buffer + VTableOffset);
+  auto const TableSize =
+      ReadScalar<voffset_t>(Buffer + VTableOffset + sizeof(voffset_t));
+  if (VTableSize < 2 * sizeof(voffset_t) or
+      VTableSize % sizeof(voffset_t) != 0 or
+      VTableOffset + VTableSize > BufferSize or
+      RootOffset + TableSize > BufferSize) {
+    return false;
+  }
+  for (auto FieldEntry = 2 * sizeof(voffset_t); FieldEntry < VTableSize;
+       FieldEntry += sizeof(voffset_t)) {
+    if (ReadScalar<voffset_t>(Buffer + VTableOffset + FieldEntry) >=
+        TableSize) {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
 
 namespace FileWriter {
 
-FlatbufferMessage::FlatbufferMessage(uint8_t const *BufferPtr, size_t Size)
-    : DataPtr(std::make_unique<uint8_t[]>(Size)), DataSize(Size) {
+FlatbufferMessage::FlatbufferMessage(uint8_t const *BufferPtr, size_t Size,
+                                     VerificationLevel Level,
+                                     std::chrono::milliseconds KafkaTime)
+    : DataPtr(BufferPool::getInstance().allocate(Size)), DataSize(Size),
+      KafkaTimestamp(KafkaTime) {
   std::memcpy(DataPtr.get(), BufferPtr, DataSize);
-  extractPacketInfo();
+  extractPacketInfo(Level);
 }
 
-FlatbufferMessage::FlatbufferMessage(FileWriter::Msg const &KafkaMessage)
-    : DataPtr(std::make_unique<uint8_t[]>(KafkaMessage.size())),
-      DataSize(KafkaMessage.size()) {
+FlatbufferMessage::FlatbufferMessage(FileWriter::Msg const &KafkaMessage,
+                                     VerificationLevel Level)
+    : DataPtr(BufferPool::getInstance().allocate(KafkaMessage.size())),
+      DataSize(KafkaMessage.size()),
+      PollTime(KafkaMessage.getMetaData().PollTime) {
+  if (KafkaMessage.getMetaData().TimestampType !=
+      RdKafka::MessageTimestamp::MSG_TIMESTAMP_NOT_AVAILABLE) {
+    KafkaTimestamp = KafkaMessage.getMetaData().Timestamp;
+  }
   std::memcpy(DataPtr.get(), KafkaMessage.data(), DataSize);
-  extractPacketInfo();
+  extractPacketInfo(Level);
 }
 
 FlatbufferMessage::FlatbufferMessage(FlatbufferMessage const &Other)
-    : DataPtr(std::make_unique<uint8_t[]>(Other.size())),
+    : DataPtr(BufferPool::getInstance().allocate(Other.size())),
       DataSize(Other.size()), SourceNameIDHash(Other.SourceNameIDHash),
       Sourcename(Other.Sourcename), ID(Other.ID), Timestamp(Other.Timestamp),
+      KafkaTimestamp(Other.KafkaTimestamp), PollTime(Other.PollTime),
       Valid(Other.Valid) {
   std::memcpy(DataPtr.get(), Other.data(), DataSize);
 }
@@ -38,7 +93,7 @@ FlatbufferMessage::SrcHash calcSourceHash(std::string const &ID,
   return std::hash<std::string>{}(ID + Name);
 }
 
-void FlatbufferMessage::extractPacketInfo() {
+void FlatbufferMessage::extractPacketInfo(VerificationLevel Level) {
   if (DataSize < 8) {
     Valid = false;
     throw BufferTooSmallError(fmt::format(
@@ -47,7 +102,14 @@ void FlatbufferMessage::extractPacketInfo() {
   std::string FlatbufferID(reinterpret_cast<char const *>(data()) + 4, 4);
   try {
     auto &Reader = FlatbufferReaderRegistry::find(FlatbufferID);
-    if (not Reader->verify(*this)) {
+    auto IsVerified{true};
+    if (Level == VerificationLevel::FULL) {
+      IsVerified = Reader->verify(*this);
+    } else if (Level == VerificationLevel::BOUNDS_ONLY) {
+      IsVerified = rootTableIsWithinBuffer(data(), DataSize) and
+                   Reader->verifyPacketInfo(*this);
+    }
+    if (not IsVerified) {
       throw NotValidFlatbuffer(
           fmt::format("Buffer which has flatbuffer ID \"{}\" is not a valid "
                       "flatbuffer of this type.",
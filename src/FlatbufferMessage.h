@@ -43,6 +43,15 @@ public:
       : FlatbufferError(what){};
 };
 
+/// \brief How thoroughly a flatbuffer is checked before its metadata is
+/// extracted.
+enum class VerificationLevel {
+  FULL,        ///< Run the flatbuffers verifier of the matching reader.
+  BOUNDS_ONLY, ///< Only check that the root table and the fields read by
+               ///< the reader are within the buffer.
+  NONE         ///< No checks, for buffers that have already been verified.
+};
+
 /// \brief A wrapper around a databuffer which holds a flatbuffer.
 ///
 /// Used to simplify passing around flatbuffers and the most important pieces of
@@ -63,16 +72,24 @@ public:
   ///
   /// \param BufferPtr Pointer to memory containing the data.
   /// \param Size Number of bytes in message.
+  /// \param Level The type of verification to run on the flatbuffer.
   /// \note Will make a copy of the data in the Kafka message.
-  FlatbufferMessage(uint8_t const *BufferPtr, size_t Size);
+  /// \param KafkaTime Timestamp of the Kafka message that the data came
+  /// from, if known.
+  FlatbufferMessage(uint8_t const *BufferPtr, size_t Size,
+                    VerificationLevel Level = VerificationLevel::FULL,
+                    std::chrono::milliseconds KafkaTime = {});
 
   /// \brief Creates a flatbuffer message, verifies the message and extracts
   /// metadata.
   ///
   /// \param KafkaMessage The Kafka message used to create the Flatbuffer
   /// message.
+  /// \param Level The type of verification to run on the flatbuffer.
   /// \note Will make a copy of the data in the Kafka message.
-  explicit FlatbufferMessage(FileWriter::Msg const &KafkaMessage);
+  explicit FlatbufferMessage(
+      FileWriter::Msg const &KafkaMessage,
+      VerificationLevel Level = VerificationLevel::FULL);
 
   /// \brief Creates a flatbuffer message, verifies the message and extracts
   /// metadata. Copy constructor version.
@@ -85,13 +102,15 @@ public:
   ~FlatbufferMessage() = default;
 
   FlatbufferMessage &operator=(FlatbufferMessage const &Other) {
-    DataPtr = std::make_unique<uint8_t[]>(Other.DataSize);
+    DataPtr = BufferPool::getInstance().allocate(Other.DataSize);
     std::memcpy(DataPtr.get(), Other.DataPtr.get(), Other.DataSize);
     DataSize = Other.DataSize;
     SourceNameIDHash = Other.SourceNameIDHash;
     Sourcename = Other.Sourcename;
     ID = Other.ID;
     Timestamp = Other.Timestamp;
+    KafkaTimestamp = Other.KafkaTimestamp;
+    PollTime = Other.PollTime;
     Valid = Other.Valid;
     return *this;
   }
@@ -116,6 +135,17 @@ public:
   /// \return The timestamp if flatbuffer is valid, 0 if it is not.
   auto getTimestamp() const { return Timestamp; };
 
+  /// \brief Timestamp of the Kafka message, zero if not available.
+  std::chrono::milliseconds getKafkaTimestamp() const {
+    return KafkaTimestamp;
+  };
+
+  /// \brief Time at which the Kafka message was polled, if set by the
+  /// consumer (see MessageMetaData::PollTime).
+  std::chrono::system_clock::time_point getPollTime() const {
+    return PollTime;
+  };
+
   /// \brief Get the hash from a combination of the flatbuffer type and source
   /// name.
   ///
@@ -142,13 +172,15 @@ public:
   size_t size() const { return DataSize; };
 
 private:
-  void extractPacketInfo();
-  std::unique_ptr<uint8_t[]> DataPtr;
+  void extractPacketInfo(VerificationLevel Level);
+  PooledBuffer DataPtr;
   size_t DataSize{0};
   SrcHash SourceNameIDHash{0};
   std::string Sourcename;
   std::string ID;
   std::int64_t Timestamp{0};
+  std::chrono::milliseconds KafkaTimestamp{0};
+  std::chrono::system_clock::time_point PollTime{};
   bool Valid{false};
 };
 
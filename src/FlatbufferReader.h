@@ -31,6 +31,15 @@ public:
   /// Run the flatbuffer verification and return the result.
   virtual bool verify(FlatbufferMessage const &Message) const = 0;
 
+  /// \brief Check that the fields read by source_name() and timestamp() are
+  /// located inside the buffer.
+  ///
+  /// Used instead of verify() when only the bounds of a message are checked.
+  /// Falls back to the full verification if not overridden.
+  virtual bool verifyPacketInfo(FlatbufferMessage const &Message) const {
+    return verify(Message);
+  }
+
   /// Extract the 'source_name' from the flatbuffer message.
   virtual std::string source_name(FlatbufferMessage const &Message) const = 0;
 
@@ -13,6 +13,7 @@
 #include "HDFVersionCheck.h"
 #include "Version.h"
 #include "json.h"
+#include <limits>
 
 namespace FileWriter {
 using HDFOperations::createHDFStructures;
@@ -20,25 +21,32 @@ using HDFOperations::writeAttributesIfPresent;
 using HDFOperations::writeHDFISO8601AttributeCurrentTime;
 using HDFOperations::writeStringAttribute;
 
-HDFFile::HDFFile(std::string const &FileName,
-                 nlohmann::json const &NexusStructure,
-                 std::vector<StreamHDFInfo> &StreamHDFInfo)
-    : H5FileName(FileName) {
+HDFFile::HDFFile(std::string const &FileName, nlohmann::json NexusStructure,
+                 std::vector<StreamHDFInfo> &StreamHDFInfo,
+                 FileAccessProfile AccessProfile, bool FromSkeleton)
+    : H5FileName(FileName), StoredNexusStructure(std::move(NexusStructure)),
+      AccessProfile(std::move(AccessProfile)) {
   if (FileName.empty()) {
     throw std::runtime_error("HDF file name must not be empty.");
   }
+  if (FromSkeleton) {
+    // The links were created when closing the skeleton file.
+    HasLinks = true;
+    openFileInRegularMode();
+    HDFOperations::findStreams(StoredNexusStructure, StreamHDFInfo, "");
+    return;
+  }
   createFileInRegularMode();
-  init(NexusStructure, StreamHDFInfo);
-  StoredNexusStructure = NexusStructure;
-  closeFile();
-  openFileInSWMRMode();
+  init(StoredNexusStructure, StreamHDFInfo);
 }
 
 HDFFile::~HDFFile() {
   try {
+    if (not HasLinks) {
+      // SWMR mode was never started, e.g. because the job was aborted.
+      addLinks();
+    }
     closeFile();
-    openFileInRegularMode();
-    addLinks();
   } catch (std::exception const &E) {
     LOG_ERROR("Unable to finish file \"{}\". Error message was: {}", H5FileName,
               E.what());
@@ -46,10 +54,8 @@ HDFFile::~HDFFile() {
 }
 
 void HDFFile::createFileInRegularMode() {
-  hdfFile() = hdf5::file::create(H5FileName,
-                                 hdf5::file::AccessFlags::EXCLUSIVE |
-                                     hdf5::file::AccessFlags::SWMR_WRITE,
-                                 {}, {});
+  hdfFile() = hdf5::file::create(H5FileName, hdf5::file::AccessFlags::EXCLUSIVE,
+                                 {}, AccessProfile.createFileAccessList());
 }
 
 void HDFFileBase::init(const std::string &NexusStructure,
@@ -75,14 +81,11 @@ void HDFFileBase::init(const nlohmann::json &NexusStructure,
 
     std::deque<std::string> path;
     if (NexusStructure.is_object()) {
-      auto value = &NexusStructure;
-      if (auto ChildrenMaybe = find<nlohmann::json>("children", *value)) {
-        auto Children = *ChildrenMaybe;
-        if (Children.is_array()) {
-          for (auto &Child : Children) {
-            createHDFStructures(&Child, RootGroup, 0, lcpl, var_string,
-                                StreamHDFInfo, path, Logger);
-          }
+      if (auto Children = NexusStructure.find("children");
+          Children != NexusStructure.end() and Children->is_array()) {
+        for (auto const &Child : *Children) {
+          createHDFStructures(&Child, RootGroup, 0, lcpl, var_string,
+                              StreamHDFInfo, path, Logger);
         }
       }
     }
@@ -123,11 +126,70 @@ void HDFFile::closeFile() {
   }
 }
 
-void HDFFile::openFileInSWMRMode() {
-  hdfFile() = hdf5::file::open(H5FileName,
-                               hdf5::file::AccessFlags::READWRITE |
-                                   hdf5::file::AccessFlags::SWMR_WRITE,
-                               {});
+void HDFFile::startSWMRWrite() {
+  if (not HasLinks) {
+    addLinks();
+    HasLinks = true;
+  }
+  if (AccessProfile.inMemory()) {
+    if (wouldExceedMemoryLimit()) {
+      switchToDefaultDriver();
+    } else {
+      Logger->info("The file \"{}\" is kept in memory and is not switched "
+                   "to SWMR mode.",
+                   H5FileName);
+    }
+    return;
+  }
+  startSWMRWriteOfOpenFile();
+}
+
+void HDFFile::startSWMRWriteOfOpenFile() {
+  // Switching the open file to SWMR mode keeps the metadata cache, unlike
+  // closing the file and re-opening it in SWMR mode.
+  if (H5Fstart_swmr_write(static_cast<hid_t>(hdfFile())) < 0) {
+    throw std::runtime_error(fmt::format(
+        "Unable to switch the file \"{}\" to SWMR mode.", H5FileName));
+  }
+}
+
+std::uintmax_t HDFFile::fileSize() {
+  hsize_t FileSize{0};
+  if (H5Fget_filesize(static_cast<hid_t>(hdfFile()), &FileSize) < 0) {
+    throw std::runtime_error(
+        fmt::format("Unable to get the size of the file \"{}\".", H5FileName));
+  }
+  return FileSize;
+}
+
+std::size_t HDFFile::memoryHeadroom() {
+  if (not AccessProfile.inMemory() or AccessProfile.CoreMemoryLimit == 0) {
+    return std::numeric_limits<std::size_t>::max();
+  }
+  // The memory of the file grows by CoreIncrement at a time.
+  auto const NextSize = fileSize() + AccessProfile.CoreIncrement;
+  auto const Limit = AccessProfile.CoreMemoryLimit;
+  return NextSize < Limit ? Limit - NextSize : 0;
+}
+
+bool HDFFile::wouldExceedMemoryLimit() { return memoryHeadroom() == 0; }
+
+void HDFFile::switchToDefaultDriver() {
+  Logger->warn("The file \"{}\" would reach the memory limit of {} bytes, "
+               "switching it from the core driver to the default driver.",
+               H5FileName, AccessProfile.CoreMemoryLimit);
+  // Writes the file to disk and closes all of its objects.
+  closeFile();
+  AccessProfile.Driver = "sec2";
+  openFileInRegularMode();
+  startSWMRWriteOfOpenFile();
+}
+
+void HDFFile::flush() {
+  if (AccessProfile.inMemory() and AccessProfile.CorePageSize == 0) {
+    return;
+  }
+  HDFFileBase::flush();
 }
 
 void HDFFileBase::flush() {
@@ -144,8 +206,8 @@ void HDFFileBase::flush() {
 }
 
 void HDFFile::openFileInRegularMode() {
-  hdfFile() =
-      hdf5::file::open(H5FileName, hdf5::file::AccessFlags::READWRITE, {});
+  hdfFile() = hdf5::file::open(H5FileName, hdf5::file::AccessFlags::READWRITE,
+                               AccessProfile.createFileAccessList());
 }
 
 void HDFFile::addLinks() {
@@ -9,11 +9,13 @@
 
 #pragma once
 
+#include "FileAccessProfile.h"
 #include "StreamHDFInfo.h"
 #include "json.h"
 #include "logger.h"
 #include <H5Ipublic.h>
 #include <chrono>
+#include <cstdint>
 #include <deque>
 #include <h5cpp/hdf5.hpp>
 #include <string>
@@ -44,19 +46,68 @@ private:
 
 class HDFFile : public HDFFileBase {
 public:
-  HDFFile(std::string const &FileName, nlohmann::json const &NexusStructure,
-          std::vector<StreamHDFInfo> &StreamHDFInfo);
+  /// \brief Create the file and its HDF structure.
+  ///
+  /// The file is left in regular (non-SWMR) mode so that the writer modules
+  /// can create their datasets, call startSWMRWrite() when done.
+  ///
+  /// \param AccessProfile The file access settings.
+  /// \param FromSkeleton If true, the file has already been created from a
+  /// skeleton file (see SkeletonCache) and is only opened. The HDF structure
+  /// and the links of the skeleton file are used as is.
+  HDFFile(std::string const &FileName, nlohmann::json NexusStructure,
+          std::vector<StreamHDFInfo> &StreamHDFInfo,
+          FileAccessProfile AccessProfile = {}, bool FromSkeleton = false);
   virtual ~HDFFile();
 
+  /// \brief Add the links and switch the open file to SWMR mode.
+  ///
+  /// No objects can be added to the file after this. Files of the core
+  /// driver (see FileAccessProfile) can not be read by SWMR readers and stay
+  /// in regular mode, unless they are switched to the default driver because
+  /// of the memory limit.
+  void startSWMRWrite();
+
+  /// \brief Flush the file.
+  ///
+  /// Files of the core driver without write tracking are only written to
+  /// disk when closed and are not flushed.
+  void flush() override;
+
+  bool inMemory() const { return AccessProfile.inMemory(); }
+
+  /// \brief Check if a file of the core driver would reach the memory limit
+  /// if it grew further.
+  bool wouldExceedMemoryLimit();
+
+  /// \brief The number of bytes that can be added to a file of the core
+  /// driver before its next block of memory could reach the memory limit.
+  ///
+  /// The maximum value of std::size_t if there is no limit.
+  std::size_t memoryHeadroom();
+
+  /// \brief The size of the file, for a file of the core driver the size of
+  /// its memory.
+  std::uintmax_t fileSize();
+
+  /// \brief Write a file of the core driver to disk, re-open it with the
+  /// default (sec2) driver and switch it to SWMR mode.
+  ///
+  /// All objects of the file, e.g. the datasets of the writer modules, are
+  /// closed and have to be re-opened.
+  void switchToDefaultDriver();
+
 private:
   void createFileInRegularMode();
   void openFileInRegularMode();
-  void openFileInSWMRMode();
   void closeFile();
   void addLinks();
+  void startSWMRWriteOfOpenFile();
 
   std::string H5FileName;
   nlohmann::json StoredNexusStructure;
+  FileAccessProfile AccessProfile;
+  bool HasLinks{false};
 };
 
 } // namespace FileWriter
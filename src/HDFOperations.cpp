@@ -9,8 +9,10 @@
 
 #include "HDFOperations.h"
 #include "json.h"
+#include <algorithm>
 #include <date/date.h>
 #include <date/tz.h>
+#include <iterator>
 #include <stack>
 #include <string>
 
@@ -24,21 +26,6 @@ static size_t const MAX_DIMENSIONS_OF_ARRAY = 10;
 /// write
 static size_t const MAX_ALLOWED_STRING_LENGTH = 4 * 1024 * 1024;
 
-template <typename DT>
-static void appendValue(nlohmann::json const &Value, std::vector<DT> &Buffer) {
-  if (Value.is_number_integer()) {
-    Buffer.push_back(Value.get<int64_t>());
-  } else if (Value.is_number_unsigned()) {
-    Buffer.push_back(Value.get<uint64_t>());
-  } else if (Value.is_number_float()) {
-    Buffer.push_back(Value.get<double>());
-  } else {
-    auto What = fmt::format("Expect a numeric value but got: {}",
-                            Value.dump().substr(0, 256));
-    std::throw_with_nested(std::runtime_error(What));
-  }
-}
-
 template <typename T>
 static void writeAttribute(hdf5::node::Node const &Node,
                            const std::string &Name, T Value) {
@@ -60,7 +47,22 @@ public:
   using DataType = _DataType;
   static void append(std::vector<DataType> &Buffer, nlohmann::json const &Value,
                      size_t const) {
-    appendValue(Value.get<DataType>(), Buffer);
+    switch (Value.type()) {
+    case json::value_t::number_integer:
+      Buffer.push_back(static_cast<DataType>(
+          Value.get_ref<json::number_integer_t const &>()));
+      break;
+    case json::value_t::number_unsigned:
+      Buffer.push_back(static_cast<DataType>(
+          Value.get_ref<json::number_unsigned_t const &>()));
+      break;
+    case json::value_t::number_float:
+      Buffer.push_back(static_cast<DataType>(
+          Value.get_ref<json::number_float_t const &>()));
+      break;
+    default:
+      Buffer.push_back(Value.get<DataType>());
+    }
   }
 };
 
@@ -96,23 +98,38 @@ public:
 class StackItem {
 public:
   explicit StackItem(nlohmann::json const &Value)
-      : Value(Value), Size(Value.size()) {}
+      : Array(Value.get_ref<json::array_t const &>()) {}
   void inc() { ++Index; }
-  nlohmann::json const &value() { return Value.at(Index); }
-  bool exhausted() const { return Index >= Size; }
+  nlohmann::json const &value() const { return Array[Index]; }
+  bool exhausted() const { return Index >= Array.size(); }
 
 private:
-  nlohmann::json const &Value;
+  json::array_t const &Array;
   size_t Index = 0;
-  size_t Size = 0;
 };
 
+/// The number of (innermost) elements of a JSON value, a value that is not an
+/// array is one element.
+static size_t countElements(nlohmann::json const &Value) {
+  if (not Value.is_array()) {
+    return 1;
+  }
+  size_t Count{0};
+  for (auto const &Element : Value) {
+    Count += countElements(Element);
+  }
+  return Count;
+}
+
 template <typename DataHandler>
 static std::vector<typename DataHandler::DataType>
 populateBlob(nlohmann::json const &ValueJson, size_t const GoalSize,
              size_t const ItemLength = 0) {
   using DataType = typename DataHandler::DataType;
   std::vector<DataType> Buffer;
+  // The goal size comes from the (user given) size of the dataset, do not
+  // allocate more than the values can fill.
+  Buffer.reserve(std::min(GoalSize, countElements(ValueJson)));
   if (ValueJson.is_array()) {
     std::stack<StackItem> Stack;
     Stack.emplace(ValueJson);
@@ -120,18 +137,19 @@ populateBlob(nlohmann::json const &ValueJson, size_t const GoalSize,
       if (Stack.size() > MAX_DIMENSIONS_OF_ARRAY) {
         break;
       }
-      if (Stack.top().exhausted()) {
+      auto &Top = Stack.top();
+      // Convert the (innermost) elements that are not arrays in one go.
+      while (not Top.exhausted() and not Top.value().is_array()) {
+        DataHandler::append(Buffer, Top.value(), ItemLength);
+        Top.inc();
+      }
+      if (Top.exhausted()) {
         Stack.pop();
         continue;
       }
-      auto const &Value = Stack.top().value();
-      if (Value.is_array()) {
-        Stack.top().inc();
-        Stack.emplace(Value);
-      } else {
-        Stack.top().inc();
-        DataHandler::append(Buffer, Value, ItemLength);
-      }
+      auto const &Value = Top.value();
+      Top.inc();
+      Stack.emplace(Value);
     }
   } else {
     DataHandler::append(Buffer, ValueJson, ItemLength);
@@ -243,9 +261,10 @@ void writeArrayOfAttributes(hdf5::node::Node const &Node,
       } else {
         continue;
       }
-      if (auto const &ValuesMaybe = find<json>("values", Attribute)) {
+      if (auto ValuesIter = Attribute.find("values");
+          ValuesIter != Attribute.end()) {
         std::string DType{"double"};
-        auto const &Values = *ValuesMaybe;
+        auto const &Values = *ValuesIter;
         uint32_t StringSize = 0;
         if (auto StringSizeMaybe = find<uint32_t>("string_size", Attribute)) {
           StringSize = *StringSizeMaybe;
@@ -284,7 +303,7 @@ void writeArrayOfAttributes(hdf5::node::Node const &Node,
   }
 }
 
-bool findType(const nlohmann::basic_json<> Attribute, std::string &DType) {
+bool findType(nlohmann::json const &Attribute, std::string &DType) {
   auto AttrType = find<std::string>("type", Attribute);
   if (AttrType) {
     DType = *AttrType;
@@ -449,9 +468,9 @@ void writeScalarAttribute(hdf5::node::Node const &Node, std::string const &Name,
 void writeAttributesIfPresent(hdf5::node::Node const &Node,
                               nlohmann::json const &Values,
                               SharedLogger const &Logger) {
-  if (auto AttributesMaybe = find<json>("attributes", Values)) {
-    auto const Attributes = *AttributesMaybe;
-    writeAttributes(Node, &Attributes, Logger);
+  if (auto AttributesIter = Values.find("attributes");
+      AttributesIter != Values.end()) {
+    writeAttributes(Node, &*AttributesIter, Logger);
   }
 }
 
@@ -555,6 +574,32 @@ void writeFixedSizeStringDataset(
   }
 }
 
+using NumericDatasetWriter = void (*)(
+    hdf5::node::Group const &, const std::string &,
+    hdf5::property::DatasetCreationList const &,
+    hdf5::dataspace::Dataspace const &, const nlohmann::json *);
+
+static NumericDatasetWriter
+findNumericDatasetWriter(std::string const &DataType) {
+  static std::map<std::string, NumericDatasetWriter> const Writers{
+      {"uint8", &writeNumericDataset<uint8_t>},
+      {"uint16", &writeNumericDataset<uint16_t>},
+      {"uint32", &writeNumericDataset<uint32_t>},
+      {"uint64", &writeNumericDataset<uint64_t>},
+      {"int8", &writeNumericDataset<int8_t>},
+      {"int16", &writeNumericDataset<int16_t>},
+      {"int32", &writeNumericDataset<int32_t>},
+      {"int64", &writeNumericDataset<int64_t>},
+      {"float", &writeNumericDataset<float>},
+      {"double", &writeNumericDataset<double>}};
+  auto Writer = Writers.find(DataType);
+  if (Writer == Writers.end()) {
+    throw std::runtime_error(
+        fmt::format("Unknown dataset type \"{}\".", DataType));
+  }
+  return Writer->second;
+}
+
 void writeGenericDataset(const std::string &DataType,
                          hdf5::node::Group const &Parent,
                          const std::string &Name,
@@ -572,70 +617,18 @@ void writeGenericDataset(const std::string &DataType,
         DatasetCreationList.chunk(Sizes);
       }
     }
-    std::map<std::string, std::function<void()>> WriteDatasetMap{
-        {"uint8",
-         [&]() {
-           writeNumericDataset<uint8_t>(Parent, Name, DatasetCreationList,
-                                        Dataspace, Values);
-         }},
-        {"uint16",
-         [&]() {
-           writeNumericDataset<uint16_t>(Parent, Name, DatasetCreationList,
-                                         Dataspace, Values);
-         }},
-        {"uint32",
-         [&]() {
-           writeNumericDataset<uint32_t>(Parent, Name, DatasetCreationList,
-                                         Dataspace, Values);
-         }},
-        {"uint64",
-         [&]() {
-           writeNumericDataset<uint64_t>(Parent, Name, DatasetCreationList,
+    if (DataType == "string") {
+      if (ElementSize == H5T_VARIABLE) {
+        writeStringDataset(Parent, Name, DatasetCreationList, Dataspace,
+                           *Values);
+      } else {
+        writeFixedSizeStringDataset(Parent, Name, DatasetCreationList,
+                                    Dataspace, ElementSize, Values, Logger);
+      }
+    } else {
+      findNumericDatasetWriter(DataType)(Parent, Name, DatasetCreationList,
                                          Dataspace, Values);
-         }},
-        {"int8",
-         [&]() {
-           writeNumericDataset<int8_t>(Parent, Name, DatasetCreationList,
-                                       Dataspace, Values);
-         }},
-        {"int16",
-         [&]() {
-           writeNumericDataset<int16_t>(Parent, Name, DatasetCreationList,
-                                        Dataspace, Values);
-         }},
-        {"int32",
-         [&]() {
-           writeNumericDataset<int32_t>(Parent, Name, DatasetCreationList,
-                                        Dataspace, Values);
-         }},
-        {"int64",
-         [&]() {
-           writeNumericDataset<int64_t>(Parent, Name, DatasetCreationList,
-                                        Dataspace, Values);
-         }},
-        {"float",
-         [&]() {
-           writeNumericDataset<float>(Parent, Name, DatasetCreationList,
-                                      Dataspace, Values);
-         }},
-        {"double",
-         [&]() {
-           writeNumericDataset<double>(Parent, Name, DatasetCreationList,
-                                       Dataspace, Values);
-         }},
-        {"string",
-         [&]() {
-           if (ElementSize == H5T_VARIABLE) {
-             writeStringDataset(Parent, Name, DatasetCreationList, Dataspace,
-                                *Values);
-           } else {
-             writeFixedSizeStringDataset(Parent, Name, DatasetCreationList,
-                                         Dataspace, ElementSize, Values,
-                                         Logger);
-           }
-         }},
-    };
-    WriteDatasetMap.at(DataType)();
+    }
   } catch (std::exception const &) {
     std::stringstream ss;
     ss << "Failed dataset write in ";
@@ -667,8 +660,9 @@ void writeDataset(hdf5::node::Group const &Parent, const nlohmann::json *Values,
   hsize_t ElementSize = H5T_VARIABLE;
 
   std::vector<hsize_t> Sizes;
-  if (auto DatasetJSONObject = find<json>("dataset", *Values)) {
-    auto DatasetInnerObject = *DatasetJSONObject;
+  if (auto DatasetJSONObject = Values->find("dataset");
+      DatasetJSONObject != Values->end()) {
+    auto const &DatasetInnerObject = *DatasetJSONObject;
     if (auto DataSpaceObject = find<std::string>("space", DatasetInnerObject)) {
       if (*DataSpaceObject != "simple") {
         Logger->warn("sorry, can only handle simple data spaces");
@@ -701,11 +695,11 @@ void writeDataset(hdf5::node::Group const &Parent, const nlohmann::json *Values,
     }
   }
 
-  auto DatasetValuesObject = find<json>("values", *Values);
-  if (!DatasetValuesObject) {
+  auto DatasetValuesObject = Values->find("values");
+  if (DatasetValuesObject == Values->end()) {
     return;
   }
-  auto DatasetValuesInnerObject = *DatasetValuesObject;
+  auto const &DatasetValuesInnerObject = *DatasetValuesObject;
 
   if (DatasetValuesInnerObject.is_number_float()) {
     DataType = "double";
@@ -729,6 +723,30 @@ void writeDataset(hdf5::node::Group const &Parent, const nlohmann::json *Values,
   writeAttributesIfPresent(dset, *Values, Logger);
 }
 
+void copyFromTemplateFile(
+    hdf5::node::Group const &Parent, nlohmann::json const &Value,
+    hdf5::property::LinkCreationList const &LinkCreationPropertyList) {
+  auto SourceFileName = find<std::string>("source_file", Value);
+  auto SourcePath = find<std::string>("source_path", Value);
+  if (not SourceFileName or not SourcePath) {
+    throw std::runtime_error("A \"copy\" node must have a \"source_file\" and "
+                             "a \"source_path\".");
+  }
+  auto Name = find<std::string>("name", Value)
+                  .value_or(SourcePath->substr(SourcePath->rfind('/') + 1));
+  auto SourceFile =
+      hdf5::file::open(*SourceFileName, hdf5::file::AccessFlags::READONLY);
+  auto SourceRoot = SourceFile.root();
+  if (0 > H5Ocopy(static_cast<hid_t>(SourceRoot), SourcePath->c_str(),
+                  static_cast<hid_t>(Parent), Name.c_str(), H5P_DEFAULT,
+                  static_cast<hid_t>(LinkCreationPropertyList))) {
+    throw std::runtime_error(
+        fmt::format("Unable to copy \"{}\" from the file \"{}\" to \"{}\".",
+                    *SourcePath, *SourceFileName,
+                    std::string(Parent.link().path())));
+  }
+}
+
 void createHDFStructures(
     const nlohmann::json *Value, hdf5::node::Group const &Parent,
     uint16_t Level,
@@ -761,34 +779,75 @@ void createHDFStructures(
           pathstr += "/" + x;
         }
 
-        HDFStreamInfo.push_back(StreamHDFInfo{pathstr, Value->dump()});
+        HDFStreamInfo.push_back(StreamHDFInfo{pathstr, *Value});
       }
       if (Type == "dataset") {
         writeDataset(Parent, Value, Logger);
       }
+      if (Type == "copy") {
+        copyFromTemplateFile(Parent, *Value, LinkCreationPropertyList);
+      }
     }
 
     // If the current level in the HDF can act as a parent, then continue the
     // recursion with the (optional) "children" array.
     if (hdf_this.is_valid()) {
       writeAttributesIfPresent(hdf_this, *Value, Logger);
-      if (auto ChildrenMaybe = find<json>("children", *Value)) {
-        auto Children = *ChildrenMaybe;
-        if (Children.is_array()) {
-          for (auto &Child : Children) {
-            createHDFStructures(&Child, hdf_this, Level + 1,
-                                LinkCreationPropertyList, FixedStringHDFType,
-                                HDFStreamInfo, Path, Logger);
-          }
+      if (auto Children = Value->find("children");
+          Children != Value->end() and Children->is_array()) {
+        for (auto const &Child : *Children) {
+          createHDFStructures(&Child, hdf_this, Level + 1,
+                              LinkCreationPropertyList, FixedStringHDFType,
+                              HDFStreamInfo, Path, Logger);
         }
       }
       Path.pop_back();
     }
   } catch (const std::exception &e) {
     // Don't throw here as the file should continue writing
-    Logger->error("Failed to create structure  parent={} level={}",
-                  std::string(Parent.link().path()), Level);
+    Logger->error("Failed to create structure  parent={} level={}  error: {}",
+                  std::string(Parent.link().path()), Level, e.what());
+  }
+}
+
+void findStreams(nlohmann::json const &Value,
+                 std::vector<StreamHDFInfo> &HDFStreamInfo,
+                 std::string const &Path) {
+  auto Children = Value.find("children");
+  if (Children == Value.end() or not Children->is_array()) {
+    return;
+  }
+  for (auto const &Child : *Children) {
+    std::string Type;
+    if (not findType(Child, Type)) {
+      continue;
+    }
+    if (Type == "stream") {
+      HDFStreamInfo.push_back(StreamHDFInfo{Path, Child});
+    } else if (Type == "group") {
+      if (auto Name = find<std::string>("name", Child)) {
+        findStreams(Child, HDFStreamInfo, Path + "/" + *Name);
+      }
+    }
+  }
+}
+
+std::vector<hdf5::node::Dataset> findDatasets(hdf5::node::Group const &Group) {
+  std::vector<hdf5::node::Dataset> Datasets;
+  for (auto const &Link : Group.links) {
+    if (Link.type() != hdf5::node::LinkType::HARD) {
+      continue;
+    }
+    auto Node = *Link;
+    if (Node.type() == hdf5::node::Type::DATASET) {
+      Datasets.emplace_back(Node);
+    } else if (Node.type() == hdf5::node::Type::GROUP) {
+      auto SubGroupDatasets = findDatasets(hdf5::node::Group(Node));
+      std::move(SubGroupDatasets.begin(), SubGroupDatasets.end(),
+                std::back_inserter(Datasets));
+    }
   }
+  return Datasets;
 }
 
 void addLinks(hdf5::node::Group const &Group, nlohmann::json const &Json,
@@ -18,7 +18,7 @@
 
 namespace HDFOperations {
 
-bool findType(nlohmann::basic_json<> Attribute, std::string &DType);
+bool findType(nlohmann::json const &Attribute, std::string &DType);
 
 void writeAttributes(hdf5::node::Node const &Node, nlohmann::json const *Value,
                      SharedLogger const &Logger);
@@ -34,6 +34,20 @@ void createHDFStructures(
     std::vector<StreamHDFInfo> &HDFStreamInfo, std::deque<std::string> &Path,
     SharedLogger const &Logger);
 
+/// \brief Find the streams of a NeXus structure without creating the HDF
+/// structure.
+///
+/// The paths of the streams are the same as those found by
+/// createHDFStructures().
+void findStreams(nlohmann::json const &Value,
+                 std::vector<StreamHDFInfo> &HDFStreamInfo,
+                 std::string const &Path);
+
+/// \brief Get the datasets in a group and (recursively) its sub-groups.
+///
+/// Only hard links are followed.
+std::vector<hdf5::node::Dataset> findDatasets(hdf5::node::Group const &Group);
+
 void writeHDFISO8601AttributeCurrentTime(hdf5::node::Node const &Node,
                                          const std::string &Name,
                                          SharedLogger const &Logger);
@@ -64,6 +78,17 @@ void writeGenericDataset(const std::string &DataType,
 void writeDataset(hdf5::node::Group const &Parent, const nlohmann::json *Values,
                   SharedLogger const &Logger);
 
+/// \brief Copy a group or dataset (including its attributes and children)
+/// from another HDF file.
+///
+/// \param Parent The group to copy the object into.
+/// \param Value JSON object with the keys "source_file" and "source_path" and
+/// optionally "name" (defaults to the name of the source object).
+/// \throws std::runtime_error If the object can not be copied.
+void copyFromTemplateFile(
+    hdf5::node::Group const &Parent, nlohmann::json const &Value,
+    hdf5::property::LinkCreationList const &LinkCreationPropertyList);
+
 void writeObjectOfAttributes(hdf5::node::Node const &Node,
                              const nlohmann::json &Values);
 
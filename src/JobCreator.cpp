@@ -11,14 +11,19 @@
 
 #include "JobCreator.h"
 #include "CommandParser.h"
+#include "FileAccessProfile.h"
 #include "FileWriterTask.h"
+#include "Filesystem.h"
 #include "HDFOperations.h"
 #include "Msg.h"
+#include "SkeletonCache.h"
 #include "StreamController.h"
 #include "WriterModuleBase.h"
 #include "WriterRegistrar.h"
+#include "helper.h"
 #include "json.h"
 #include <algorithm>
+#include <optional>
 
 using std::vector;
 
@@ -26,30 +31,32 @@ namespace FileWriter {
 
 using nlohmann::json;
 
-std::vector<StreamHDFInfo>
-JobCreator::initializeHDF(FileWriterTask &Task,
-                          std::string const &NexusStructureString) {
+static json parseNexusStructure(std::string const &NexusStructureString) {
   try {
-    json const NexusStructure = json::parse(NexusStructureString);
-    std::vector<StreamHDFInfo> StreamHDFInfoList;
-    Task.InitialiseHdf(NexusStructure.dump(), StreamHDFInfoList);
-    return StreamHDFInfoList;
+    return json::parse(NexusStructureString);
   } catch (nlohmann::detail::exception const &Error) {
     throw std::runtime_error(
         fmt::format("Could not parse NeXus structure JSON '{}'", Error.what()));
   }
 }
 
+std::vector<StreamHDFInfo> JobCreator::initializeHDF(FileWriterTask &Task,
+                                                     json NexusStructure) {
+  std::vector<StreamHDFInfo> StreamHDFInfoList;
+  Task.InitialiseHdf(std::move(NexusStructure), StreamHDFInfoList);
+  return StreamHDFInfoList;
+}
+
 StreamSettings
 extractStreamInformationFromJsonForSource(StreamHDFInfo const &StreamInfo) {
   StreamSettings StreamSettings;
   StreamSettings.StreamHDFInfoObj = StreamInfo;
 
-  json ConfigStream = json::parse(StreamSettings.StreamHDFInfoObj.ConfigStream);
+  auto const &ConfigStream = StreamInfo.ConfigStream;
 
-  auto ConfigStreamInner =
+  StreamSettings.ConfigStreamJson =
       CommandParser::getRequiredValue<json>("stream", ConfigStream);
-  StreamSettings.ConfigStreamJson = ConfigStreamInner.dump();
+  auto const &ConfigStreamInner = StreamSettings.ConfigStreamJson;
   StreamSettings.Topic =
       CommandParser::getRequiredValue<std::string>("topic", ConfigStreamInner);
   StreamSettings.Source =
@@ -57,14 +64,13 @@ extractStreamInformationFromJsonForSource(StreamHDFInfo const &StreamInfo) {
   StreamSettings.Module = CommandParser::getRequiredValue<std::string>(
       "writer_module", ConfigStreamInner);
   StreamSettings.Attributes =
-      CommandParser::getOptionalValue<json>("attributes", ConfigStream, "")
-          .dump();
+      CommandParser::getOptionalValue<json>("attributes", ConfigStream, "");
 
   return StreamSettings;
 }
 
-void setUpHdfStructure(StreamSettings const &StreamSettings,
-                       std::unique_ptr<FileWriterTask> const &Task) {
+/// Instantiate and configure the writer module of a stream.
+static void createWriterModule(StreamSettings &StreamSettings) {
   WriterModule::Registry::FactoryAndID ModuleFactory;
   try {
     ModuleFactory = WriterModule::Registry::find(StreamSettings.Module);
@@ -82,7 +88,6 @@ void setUpHdfStructure(StreamSettings const &StreamSettings,
                     StreamSettings.Module));
   }
 
-  auto RootGroup = Task->hdfGroup();
   try {
     HDFWriterModule->parse_config(StreamSettings.ConfigStreamJson);
   } catch (std::exception const &E) {
@@ -91,7 +96,16 @@ void setUpHdfStructure(StreamSettings const &StreamSettings,
         " source: {}  error message: {}",
         StreamSettings.Module, StreamSettings.Source, E.what())));
   }
+  StreamSettings.HDFWriterModule = std::move(HDFWriterModule);
+  StreamSettings.FlatbufferID = ModuleFactory.second;
+}
 
+void setUpHdfStructure(StreamSettings &StreamSettings,
+                       std::unique_ptr<FileWriterTask> const &Task) {
+  createWriterModule(StreamSettings);
+  auto &HDFWriterModule = StreamSettings.HDFWriterModule;
+
+  auto RootGroup = Task->hdfGroup();
   auto StreamGroup = hdf5::node::get_group(
       RootGroup, StreamSettings.StreamHDFInfoObj.HDFParentName);
 
@@ -115,17 +129,21 @@ void setUpHdfStructure(StreamSettings const &StreamSettings,
        {"topic", StreamSettings.Topic},
        {"source", StreamSettings.Source}});
 
-  auto AttributesJson = nlohmann::json::parse(StreamSettings.Attributes);
-  HDFOperations::writeAttributes(StreamGroup, &AttributesJson, SharedLogger());
+  HDFOperations::writeAttributes(StreamGroup, &StreamSettings.Attributes,
+                                 SharedLogger());
 
   HDFWriterModule->init_hdf({StreamGroup});
 }
 
 /// Helper to extract information about the provided streams.
+/// \param CreateHdfStructure If false, the HDF structure of the streams
+/// already exists (the file was created from a skeleton file) and the writer
+/// modules are only instantiated and configured.
 /// \param Logger Pointer to spdlog instance to be used for logging.
 static vector<StreamSettings>
 extractStreamInformationFromJson(std::unique_ptr<FileWriterTask> const &Task,
                                  std::vector<StreamHDFInfo> &StreamHDFInfoList,
+                                 bool CreateHdfStructure,
                                  SharedLogger const &Logger) {
   Logger->info("Command contains {} streams", StreamHDFInfoList.size());
   std::vector<StreamSettings> StreamSettingsList;
@@ -134,40 +152,169 @@ extractStreamInformationFromJson(std::unique_ptr<FileWriterTask> const &Task,
       StreamSettingsList.push_back(
           extractStreamInformationFromJsonForSource(StreamHDFInfo));
       Logger->info("Adding stream: {}",
-                   StreamSettingsList.back().ConfigStreamJson);
-      setUpHdfStructure(StreamSettingsList.back(), Task);
+                   StreamSettingsList.back().ConfigStreamJson.dump());
+      if (CreateHdfStructure) {
+        setUpHdfStructure(StreamSettingsList.back(), Task);
+      } else {
+        createWriterModule(StreamSettingsList.back());
+      }
       StreamHDFInfo.InitialisedOk = true;
-    } catch (json::parse_error const &E) {
-      Logger->warn("Invalid json: {}", StreamHDFInfo.ConfigStream);
+    } catch (json::exception const &E) {
+      Logger->warn("Invalid json: {}", StreamHDFInfo.ConfigStream.dump());
       continue;
     } catch (std::runtime_error const &E) {
       Logger->warn("Exception while initialising writer module  what: {}  "
                    "parent: {}  json: {}",
                    E.what(), StreamHDFInfo.HDFParentName,
-                   StreamHDFInfo.ConfigStream);
+                   StreamHDFInfo.ConfigStream.dump());
       continue;
     } catch (...) {
       Logger->error("Unknown error caught while trying to initialise stream  "
                     "parent: {}  json: {}",
-                    StreamHDFInfo.HDFParentName, StreamHDFInfo.ConfigStream);
+                    StreamHDFInfo.HDFParentName,
+                    StreamHDFInfo.ConfigStream.dump());
     }
   }
   return StreamSettingsList;
 }
 
+/// \brief Get the file access settings of a job.
+///
+/// These are the settings given on the command line with the settings of the
+/// (optional) "file_access" object of the NeXus structure applied on top.
+static FileAccessProfile
+getJobFileAccessProfile(MainOpt const &Settings, json const &NexusStructure) {
+  auto Profile = getFileAccessProfile(Settings.FileAccessProfileName);
+  if (not Settings.FileAccessSettings.empty()) {
+    json CommandLineSettings;
+    try {
+      CommandLineSettings = json::parse(Settings.FileAccessSettings);
+    } catch (json::exception const &Error) {
+      throw std::runtime_error(fmt::format(
+          "Could not parse the file access settings '{}'", Error.what()));
+    }
+    Profile = applyFileAccessSettings(CommandLineSettings, Profile);
+  }
+  if (auto JobSettings = NexusStructure.find("file_access");
+      JobSettings != NexusStructure.end()) {
+    Profile = applyFileAccessSettings(*JobSettings, Profile);
+  }
+  return Profile;
+}
+
+/// \brief Create a skeleton file for a NeXus structure in the cache.
+///
+/// The skeleton file is first written to a temporary file which is renamed
+/// when done, so that other jobs never use a partially written skeleton.
+///
+/// \return False if one or more streams could not be initialised, in which
+/// case no skeleton file is created.
+static bool createSkeleton(SkeletonCache const &Cache, std::string const &Key,
+                           json const &NexusStructure,
+                           FileAccessProfile const &AccessProfile,
+                           std::string const &ServiceID,
+                           SharedLogger const &Logger) {
+  auto SkeletonPath = Cache.getSkeletonPath(Key);
+  auto TemporaryPath = fmt::format("{}.{}.tmp", SkeletonPath, ServiceID);
+  fs::remove(TemporaryPath);
+  bool AllStreamsInitialised{false};
+  {
+    auto SkeletonTask = std::make_unique<FileWriterTask>(ServiceID);
+    SkeletonTask->setFilename("", TemporaryPath);
+    SkeletonTask->setFileAccessProfile(AccessProfile);
+    std::vector<StreamHDFInfo> StreamHDFInfoList;
+    SkeletonTask->InitialiseHdf(Cache.getSkeletonStructure(NexusStructure),
+                                StreamHDFInfoList);
+    extractStreamInformationFromJson(SkeletonTask, StreamHDFInfoList, true,
+                                     Logger);
+    AllStreamsInitialised = std::all_of(
+        StreamHDFInfoList.begin(), StreamHDFInfoList.end(),
+        [](auto const &Item) { return Item.InitialisedOk; });
+  }
+  if (not AllStreamsInitialised) {
+    Logger->warn("Not creating a skeleton file as one or more streams could "
+                 "not be initialised.");
+    fs::remove(TemporaryPath);
+    return false;
+  }
+  fs::rename(TemporaryPath, SkeletonPath);
+  Logger->info("Created skeleton file {}", SkeletonPath);
+  Cache.removeLeastRecentlyUsed(Key);
+  return true;
+}
+
+/// \brief Create the file of a job from a skeleton file, creating the
+/// skeleton file first if it is not in the cache.
+///
+/// \param NexusStructure Moved from if the file was created.
+/// \return The stream information, or nothing if the file could not be
+/// created from a skeleton file.
+static std::optional<std::vector<StreamHDFInfo>>
+initializeHDFFromSkeleton(FileWriterTask &Task, json &NexusStructure,
+                          MainOpt const &Settings,
+                          FileAccessProfile const &AccessProfile,
+                          SharedLogger const &Logger) {
+  SkeletonCache Cache(
+      Settings.SkeletonCacheDirectory, Settings.SkeletonVolatileAttributes,
+      Settings.SkeletonVolatileDatasets, Settings.SkeletonCacheMaxSize);
+  try {
+    auto Key = Cache.getKey(NexusStructure, AccessProfile);
+    if (not Cache.hasSkeleton(Key)) {
+      Logger->info("No skeleton file with key {} in the cache", Key);
+      if (not createSkeleton(Cache, Key, NexusStructure, AccessProfile,
+                             Settings.ServiceID, Logger)) {
+        return {};
+      }
+    }
+    Cache.createFileFromSkeleton(Key, Task.filename(), NexusStructure);
+  } catch (std::exception const &E) {
+    Logger->warn("Unable to create the file from a skeleton file, creating it "
+                 "from the NeXus structure instead. The error was: {}",
+                 E.what());
+    return {};
+  }
+  std::vector<StreamHDFInfo> StreamHDFInfoList;
+  Task.InitialiseHdfFromSkeleton(std::move(NexusStructure), StreamHDFInfoList);
+  return StreamHDFInfoList;
+}
+
 std::unique_ptr<IStreamController>
 JobCreator::createFileWritingJob(StartCommandInfo const &StartInfo,
                                  MainOpt &Settings, SharedLogger const &Logger,
                                  Metrics::Registrar Registrar) {
   auto Task = std::make_unique<FileWriterTask>(Settings.ServiceID);
   Task->setJobId(StartInfo.JobID);
-  Task->setFilename(Settings.HDFOutputPrefix, StartInfo.Filename);
+  if (Settings.ScratchDirectory.empty()) {
+    Task->setFilename(Settings.HDFOutputPrefix, StartInfo.Filename);
+  } else {
+    // The file is moved to the output directory when it has been written
+    // (see FileMover), check early that it can be.
+    auto const OutputFileName =
+        prefixPath(Settings.HDFOutputPrefix, StartInfo.Filename);
+    if (fs::exists(OutputFileName)) {
+      throw std::runtime_error(
+          fmt::format("The file \"{}\" already exists.", OutputFileName));
+    }
+    Task->setFilename(Settings.ScratchDirectory, StartInfo.Filename);
+  }
 
+  auto NexusStructure = parseNexusStructure(StartInfo.NexusStructure);
+  auto AccessProfile = getJobFileAccessProfile(Settings, NexusStructure);
+  Task->setFileAccessProfile(AccessProfile);
+  std::optional<std::vector<StreamHDFInfo>> SkeletonStreamHDFInfoList;
+  if (not Settings.SkeletonCacheDirectory.empty()) {
+    SkeletonStreamHDFInfoList =
+        initializeHDFFromSkeleton(*Task, NexusStructure, Settings,
+                                  AccessProfile, Logger);
+  }
+  bool const FromSkeleton = SkeletonStreamHDFInfoList.has_value();
   std::vector<StreamHDFInfo> StreamHDFInfoList =
-      initializeHDF(*Task, StartInfo.NexusStructure);
+      FromSkeleton ? std::move(*SkeletonStreamHDFInfoList)
+                   : initializeHDF(*Task, std::move(NexusStructure));
 
   std::vector<StreamSettings> StreamSettingsList =
-      extractStreamInformationFromJson(Task, StreamHDFInfoList, Logger);
+      extractStreamInformationFromJson(Task, StreamHDFInfoList,
+                                       not FromSkeleton, Logger);
 
   if (Settings.AbortOnUninitialisedStream) {
     for (auto const &Item : StreamHDFInfoList) {
@@ -175,11 +322,12 @@ JobCreator::createFileWritingJob(StartCommandInfo const &StartInfo,
       if (!Item.InitialisedOk) {
         throw std::runtime_error(fmt::format("Could not initialise {}  {}",
                                              Item.HDFParentName,
-                                             Item.ConfigStream));
+                                             Item.ConfigStream.dump()));
       }
     }
   }
 
+  Task->startSWMRWrite();
   addStreamSourceToWriterModule(StreamSettingsList, Task);
 
   Settings.StreamerConfiguration.StartTimestamp = StartInfo.StartTime;
@@ -194,60 +342,46 @@ JobCreator::createFileWritingJob(StartCommandInfo const &StartInfo,
 }
 
 void JobCreator::addStreamSourceToWriterModule(
-    vector<StreamSettings> const &StreamSettingsList,
+    vector<StreamSettings> &StreamSettingsList,
     std::unique_ptr<FileWriterTask> &Task) {
   auto Logger = getLogger();
 
-  for (auto const &StreamSettings : StreamSettingsList) {
+  for (auto &StreamSettings : StreamSettingsList) {
     Logger->trace("Add Source: {}", StreamSettings.Topic);
-    WriterModule::Registry::FactoryAndID ModuleFactory;
-
-    try {
-      ModuleFactory = WriterModule::Registry::find(StreamSettings.Module);
-    } catch (std::exception const &E) {
-      Logger->info("WriterModule '{}' is not available, error {}",
-                   StreamSettings.Module, E.what());
-      continue;
-    }
-
-    auto AcceptedFlatbufferID = ModuleFactory.second;
-    auto HDFWriterModule = ModuleFactory.first();
-    if (!HDFWriterModule) {
-      Logger->info("Can not create a writer module for '{}'",
-                   StreamSettings.Module);
+    auto &HDFWriterModule = StreamSettings.HDFWriterModule;
+    if (HDFWriterModule == nullptr) {
+      // The HDF structure of the stream could not be set up.
       continue;
     }
 
     try {
-      // Reopen the previously created HDF dataset.
-      HDFWriterModule->parse_config(StreamSettings.ConfigStreamJson);
-      try {
-        auto RootGroup = Task->hdfGroup();
-        auto StreamGroup = hdf5::node::get_group(
-            RootGroup, StreamSettings.StreamHDFInfoObj.HDFParentName);
-        auto Err = HDFWriterModule->reopen({StreamGroup});
-        if (Err != WriterModule::InitResult::OK) {
-          Logger->error("can not reopen HDF file for stream {}",
-                        StreamSettings.StreamHDFInfoObj.HDFParentName);
-          continue;
-        }
-      } catch (std::runtime_error const &e) {
-        Logger->error("Exception on WriterModule::Base->reopen(): {}",
-                      e.what());
+      // Re-bind the writer module to the datasets created by init_hdf().
+      auto RootGroup = Task->hdfGroup();
+      auto StreamGroup = hdf5::node::get_group(
+          RootGroup, StreamSettings.StreamHDFInfoObj.HDFParentName);
+      auto Err = HDFWriterModule->reopen({StreamGroup});
+      if (Err != WriterModule::InitResult::OK) {
+        Logger->error("can not reopen HDF file for stream {}",
+                      StreamSettings.StreamHDFInfoObj.HDFParentName);
         continue;
       }
-
-      // Create a Source instance for the stream and add to the task.
-      Source ThisSource(StreamSettings.Source, AcceptedFlatbufferID,
-                        StreamSettings.Module, StreamSettings.Topic,
-                        move(HDFWriterModule));
-      Task->addSource(std::move(ThisSource));
-    } catch (std::runtime_error const &E) {
-      Logger->warn(
-          "Exception while initializing writer module {} for source {}: {}",
-          StreamSettings.Module, StreamSettings.Source, E.what());
+      // Files kept in memory are flushed as a whole, which also checks the
+      // memory limit (see FileWriterTask::flushDataToFile()).
+      if (not Task->inMemory()) {
+        HDFWriterModule->setDatasetsToFlush(
+            HDFOperations::findDatasets(StreamGroup));
+      }
+    } catch (std::runtime_error const &e) {
+      Logger->error("Exception on WriterModule::Base->reopen(): {}", e.what());
       continue;
     }
+
+    // Create a Source instance for the stream and add to the task.
+    Source ThisSource(StreamSettings.Source, StreamSettings.FlatbufferID,
+                      StreamSettings.Module, StreamSettings.Topic,
+                      std::move(HDFWriterModule),
+                      StreamSettings.StreamHDFInfoObj.HDFParentName);
+    Task->addSource(std::move(ThisSource));
   }
 }
 } // namespace FileWriter
@@ -15,6 +15,7 @@
 #include "Metrics/Registrar.h"
 #include "States.h"
 #include "StreamController.h"
+#include "WriterModuleBase.h"
 #include "json.h"
 #include <memory>
 
@@ -26,8 +27,12 @@ struct StreamSettings {
   std::string Topic;
   std::string Module;
   std::string Source;
-  std::string ConfigStreamJson;
-  std::string Attributes;
+  nlohmann::json ConfigStreamJson;
+  nlohmann::json Attributes;
+  /// The writer module that was used to create the HDF structure of the
+  /// stream, re-used for writing.
+  std::unique_ptr<WriterModule::Base> HDFWriterModule;
+  std::string FlatbufferID;
 };
 
 class IJobCreator {
@@ -53,13 +58,17 @@ public:
                        SharedLogger const &Logger,
                        Metrics::Registrar Registrar) override;
 
-private:
+  /// \brief Re-open the writer modules created by setUpHdfStructure() and add
+  /// them, as sources, to the task.
+  ///
+  /// Streams without a writer module are skipped.
   static void addStreamSourceToWriterModule(
-      std::vector<StreamSettings> const &StreamSettingsList,
+      std::vector<StreamSettings> &StreamSettingsList,
       std::unique_ptr<FileWriterTask> &Task);
 
+private:
   static std::vector<StreamHDFInfo>
-  initializeHDF(FileWriterTask &Task, std::string const &NexusStructureString);
+  initializeHDF(FileWriterTask &Task, nlohmann::json NexusStructure);
 };
 
 /// \brief Extract information about the stream.
@@ -69,4 +78,12 @@ private:
 StreamSettings
 extractStreamInformationFromJsonForSource(StreamHDFInfo const &StreamInfo);
 
+/// \brief Create, configure and initialise the writer module of a stream,
+/// which is stored in the stream settings to be re-used for writing.
+///
+/// \param StreamSettings The settings of the stream.
+/// \param Task The task of the file in which the HDF structure is created.
+void setUpHdfStructure(StreamSettings &StreamSettings,
+                       std::unique_ptr<FileWriterTask> const &Task);
+
 } // namespace FileWriter
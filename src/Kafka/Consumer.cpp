@@ -9,6 +9,7 @@
 
 #include "Consumer.h"
 #include "MetadataException.h"
+#include "Tracing.h"
 #include <algorithm>
 #include <atomic>
 #include <chrono>
@@ -188,6 +189,7 @@ std::unique_ptr<RdKafka::Metadata> Consumer::metadataCall() {
 }
 
 std::pair<PollStatus, FileWriter::Msg> Consumer::poll() {
+  TRACE_SPAN("consumer_poll");
   auto KafkaMsg = std::unique_ptr<RdKafka::Message>(
       KafkaConsumer->consume(ConsumerBrokerSettings.PollTimeoutMS));
   switch (KafkaMsg->err()) {
@@ -209,4 +211,16 @@ std::pair<PollStatus, FileWriter::Msg> Consumer::poll() {
     return {PollStatus::Error, FileWriter::Msg()};
   }
 }
+
+std::optional<int64_t> Consumer::getHighWatermark(std::string const &Topic,
+                                                  int PartitionId) {
+  int64_t Low, High;
+  auto ErrorCode =
+      KafkaConsumer->get_watermark_offsets(Topic, PartitionId, &Low, &High);
+  if (ErrorCode != RdKafka::ERR_NO_ERROR or
+      High == RdKafka::Topic::OFFSET_INVALID) {
+    return std::nullopt;
+  }
+  return High;
+}
 } // namespace Kafka
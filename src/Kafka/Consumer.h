@@ -17,6 +17,7 @@
 #include <chrono>
 #include <librdkafka/rdkafkacpp.h>
 #include <memory>
+#include <optional>
 
 namespace FileWriter {
 struct Msg;
@@ -34,6 +35,16 @@ public:
   queryTopicPartitions(const std::string &TopicName) = 0;
   virtual void addPartitionAtOffset(std::string const &Topic, int PartitionId,
                                     int64_t Offset) = 0;
+
+  /// Get the (locally cached) high watermark offset of a partition.
+  ///
+  /// \return The offset or nothing if it is not (yet) known.
+  virtual std::optional<int64_t> getHighWatermark(std::string const &Topic,
+                                                  int PartitionId) {
+    UNUSED_ARG(Topic);
+    UNUSED_ARG(PartitionId);
+    return std::nullopt;
+  }
 };
 
 class Consumer : public ConsumerInterface {
@@ -72,6 +83,11 @@ public:
   /// \return Any new messages consumed.
   std::pair<PollStatus, FileWriter::Msg> poll() override;
 
+  /// Get the high watermark offset of a partition from the consumer's cache,
+  /// which is updated on every fetch. Does not query the broker.
+  std::optional<int64_t> getHighWatermark(std::string const &Topic,
+                                          int PartitionId) override;
+
 protected:
   std::unique_ptr<RdKafka::KafkaConsumer> KafkaConsumer;
 
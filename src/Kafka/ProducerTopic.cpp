@@ -37,16 +37,23 @@ struct Msg_ : public ProducerMessage {
 };
 
 int ProducerTopic::produce(flatbuffers::DetachedBuffer const &MsgData) {
+  return produce(MsgData, "");
+}
+
+int ProducerTopic::produce(flatbuffers::DetachedBuffer const &MsgData,
+                           std::string const &Key) {
   auto MsgPtr = new Msg_;
   std::copy(MsgData.data(), MsgData.data() + MsgData.size(),
             std::back_inserter(MsgPtr->v));
   MsgPtr->finalize();
-  return produce(std::unique_ptr<ProducerMessage>(MsgPtr));
+  return produce(std::unique_ptr<ProducerMessage>(MsgPtr), Key);
 }
 
-int ProducerTopic::produce(std::unique_ptr<ProducerMessage> Msg) {
-  void const *key = nullptr;
-  size_t key_len = 0;
+int ProducerTopic::produce(std::unique_ptr<ProducerMessage> Msg,
+                           std::string const &Key) {
+  // The key is copied by RdKafka.
+  void const *key = Key.empty() ? nullptr : Key.data();
+  size_t key_len = Key.size();
   // MsgFlags = 0 means that we are responsible for cleaning up the message
   // after it has been sent
   // We do this by providing a pointer to our message object in the produce
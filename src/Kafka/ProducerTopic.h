@@ -38,10 +38,21 @@ public:
   /// otherwise
   virtual int produce(flatbuffers::DetachedBuffer const &MsgData);
 
+  /// \brief Send a message with a key. Messages with the same key are
+  /// published to the same partition.
+  ///
+  /// \param MsgData The message to publish
+  /// \param Key The key of the message
+  /// \return 0 if message is successfully passed to RdKafka to be published, 1
+  /// otherwise
+  int produce(flatbuffers::DetachedBuffer const &MsgData,
+              std::string const &Key);
+
   std::string name() const;
 
 private:
-  int produce(std::unique_ptr<Kafka::ProducerMessage> Msg);
+  int produce(std::unique_ptr<Kafka::ProducerMessage> Msg,
+              std::string const &Key = "");
   std::unique_ptr<RdKafka::Conf> ConfigPtr{
       RdKafka::Conf::create(RdKafka::Conf::CONF_TOPIC)};
   std::shared_ptr<Producer> KafkaProducer;
@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "RecordingConsumer.h"
+#include "Filesystem.h"
+#include "ReplayConsumer.h"
+#include "logger.h"
+#include <algorithm>
+
+namespace Kafka {
+
+MessageRecorder::MessageRecorder(std::string RecordDirectory,
+                                 std::string Topic, size_t SegmentSize)
+    : Directory(std::move(RecordDirectory)), TopicName(std::move(Topic)),
+      MaxSegmentSize(SegmentSize) {}
+
+std::unique_ptr<Stream::SpoolSegment>
+MessageRecorder::createSegment(int32_t Partition, size_t MinimumCapacity) {
+  auto PartitionDirectory =
+      getRecordingDirectory(Directory, TopicName, Partition);
+  fs::create_directories(PartitionDirectory);
+  if (NextSegmentNumber.find(Partition) == NextSegmentNumber.end()) {
+    NextSegmentNumber[Partition] =
+        getRecordedSegments(PartitionDirectory).size();
+  }
+  auto FilePath = (fs::path(PartitionDirectory) /
+                   fmt::format("segment_{:08d}.spool",
+                               NextSegmentNumber[Partition]++))
+                      .string();
+  return std::make_unique<Stream::SpoolSegment>(
+      FilePath, std::max(MaxSegmentSize, MinimumCapacity), true);
+}
+
+void MessageRecorder::record(FileWriter::Msg const &Message) {
+  auto const &MetaData = Message.getMetaData();
+  Stream::SpoolRecordHeader Header;
+  Header.Size = Message.size();
+  Header.Offset = MetaData.Offset;
+  Header.KafkaTimestamp = MetaData.Timestamp.count();
+  Header.Partition = MetaData.Partition;
+  auto &CurrentSegment = Segments[MetaData.Partition];
+  if (CurrentSegment != nullptr and
+      CurrentSegment->append(Header, Message.data())) {
+    return;
+  }
+  try {
+    CurrentSegment = createSegment(
+        MetaData.Partition, Stream::SpoolSegment::recordSize(Header.Size));
+    CurrentSegment->append(Header, Message.data());
+    HasRecordingError = false;
+  } catch (std::exception &E) {
+    CurrentSegment.reset();
+    if (not HasRecordingError) {
+      LOG_ERROR("Failed to record message from topic \"{}\": {}", TopicName,
+                E.what());
+      HasRecordingError = true;
+    }
+  }
+}
+
+RecordingConsumer::RecordingConsumer(
+    std::unique_ptr<ConsumerInterface> Consumer, std::string RecordDirectory,
+    size_t SegmentSize)
+    : WrappedConsumer(std::move(Consumer)),
+      Recorder(std::move(RecordDirectory), "", SegmentSize) {}
+
+void RecordingConsumer::addTopic(std::string const &Topic) {
+  Recorder.setTopic(Topic);
+  WrappedConsumer->addTopic(Topic);
+}
+
+void RecordingConsumer::addPartitionAtOffset(std::string const &Topic,
+                                             int PartitionId, int64_t Offset) {
+  Recorder.setTopic(Topic);
+  WrappedConsumer->addPartitionAtOffset(Topic, PartitionId, Offset);
+}
+
+std::vector<int32_t>
+RecordingConsumer::queryTopicPartitions(const std::string &Topic) {
+  return WrappedConsumer->queryTopicPartitions(Topic);
+}
+
+std::optional<int64_t>
+RecordingConsumer::getHighWatermark(std::string const &Topic,
+                                    int PartitionId) {
+  return WrappedConsumer->getHighWatermark(Topic, PartitionId);
+}
+
+std::pair<PollStatus, FileWriter::Msg> RecordingConsumer::poll() {
+  auto Result = WrappedConsumer->poll();
+  if (Result.first == PollStatus::Message) {
+    Recorder.record(Result.second);
+  }
+  return Result;
+}
+
+std::unique_ptr<ConsumerInterface>
+RecordingConsumerFactory::createConsumer(BrokerSettings const &Settings) {
+  return std::make_unique<RecordingConsumer>(
+      WrappedFactory->createConsumer(Settings), Directory);
+}
+
+} // namespace Kafka
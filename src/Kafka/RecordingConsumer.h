@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#pragma once
+
+#include "ConsumerFactory.h"
+#include "Stream/SpoolSegment.h"
+#include <map>
+
+namespace Kafka {
+
+/// \brief Records Kafka messages of a topic to disk in the format read by the
+/// ReplayConsumer.
+class MessageRecorder {
+public:
+  static constexpr size_t DefaultSegmentSize{64 * 1024 * 1024};
+  MessageRecorder(std::string RecordDirectory, std::string Topic,
+                  size_t SegmentSize = DefaultSegmentSize);
+
+  /// \brief Record a message.
+  ///
+  /// Errors are logged (once) and otherwise ignored.
+  void record(FileWriter::Msg const &Message);
+  void setTopic(std::string const &Topic) { TopicName = Topic; }
+
+private:
+  std::unique_ptr<Stream::SpoolSegment>
+  createSegment(int32_t Partition, size_t MinimumCapacity);
+  std::string Directory;
+  std::string TopicName;
+  size_t MaxSegmentSize;
+  bool HasRecordingError{false};
+  std::map<int32_t, std::unique_ptr<Stream::SpoolSegment>> Segments;
+  std::map<int32_t, size_t> NextSegmentNumber;
+};
+
+/// \brief Consumer that records all consumed messages to disk.
+///
+/// Wraps another consumer. The recorded messages can be replayed with the
+/// ReplayConsumer.
+class RecordingConsumer : public ConsumerInterface {
+public:
+  RecordingConsumer(
+      std::unique_ptr<ConsumerInterface> Consumer, std::string RecordDirectory,
+      size_t SegmentSize = MessageRecorder::DefaultSegmentSize);
+  ~RecordingConsumer() override = default;
+
+  void addTopic(std::string const &Topic) override;
+  void addPartitionAtOffset(std::string const &Topic, int PartitionId,
+                            int64_t Offset) override;
+  std::vector<int32_t> queryTopicPartitions(const std::string &Topic) override;
+  std::pair<PollStatus, FileWriter::Msg> poll() override;
+  std::optional<int64_t> getHighWatermark(std::string const &Topic,
+                                          int PartitionId) override;
+
+private:
+  std::unique_ptr<ConsumerInterface> WrappedConsumer;
+  MessageRecorder Recorder;
+};
+
+class RecordingConsumerFactory : public ConsumerFactoryInterface {
+public:
+  RecordingConsumerFactory(std::unique_ptr<ConsumerFactoryInterface> Factory,
+                           std::string RecordDirectory)
+      : WrappedFactory(std::move(Factory)),
+        Directory(std::move(RecordDirectory)) {}
+  std::unique_ptr<ConsumerInterface>
+  createConsumer(BrokerSettings const &Settings) override;
+  ~RecordingConsumerFactory() override = default;
+
+private:
+  std::unique_ptr<ConsumerFactoryInterface> WrappedFactory;
+  std::string Directory;
+};
+} // namespace Kafka
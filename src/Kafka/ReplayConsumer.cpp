@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "ReplayConsumer.h"
+#include "Filesystem.h"
+#include "logger.h"
+#include <algorithm>
+#include <thread>
+
+namespace Kafka {
+
+namespace {
+std::string const PartitionDirectoryPrefix{"partition_"};
+std::string const SegmentFileExtension{".spool"};
+} // namespace
+
+std::string getRecordingDirectory(std::string const &Directory,
+                                  std::string const &Topic, int Partition) {
+  return (fs::path(Directory) / Topic /
+          (PartitionDirectoryPrefix + std::to_string(Partition)))
+      .string();
+}
+
+std::vector<std::string>
+getRecordedSegments(std::string const &PartitionDirectory) {
+  std::vector<std::string> SegmentFiles;
+  std::error_code Error;
+  for (auto const &Entry :
+       fs::directory_iterator(PartitionDirectory, Error)) {
+    if (Entry.path().extension() == SegmentFileExtension) {
+      SegmentFiles.push_back(Entry.path().string());
+    }
+  }
+  // Segment files are numbered with leading zeros.
+  std::sort(SegmentFiles.begin(), SegmentFiles.end());
+  return SegmentFiles;
+}
+
+std::set<std::string> getRecordedTopics(std::string const &Directory) {
+  std::set<std::string> Topics;
+  std::error_code Error;
+  for (auto const &Entry : fs::directory_iterator(Directory, Error)) {
+    if (fs::is_directory(Entry.path())) {
+      Topics.insert(Entry.path().filename().string());
+    }
+  }
+  return Topics;
+}
+
+std::vector<int> getRecordedPartitions(std::string const &Directory,
+                                       std::string const &Topic) {
+  std::vector<int> Partitions;
+  std::error_code Error;
+  for (auto const &Entry :
+       fs::directory_iterator(fs::path(Directory) / Topic, Error)) {
+    auto Name = Entry.path().filename().string();
+    if (Name.find(PartitionDirectoryPrefix) == 0) {
+      try {
+        Partitions.push_back(
+            std::stoi(Name.substr(PartitionDirectoryPrefix.size())));
+      } catch (std::exception &) {
+        // Not a partition directory, ignore it.
+      }
+    }
+  }
+  std::sort(Partitions.begin(), Partitions.end());
+  return Partitions;
+}
+
+std::vector<std::pair<int, int64_t>>
+getRecordedOffsetsForTime(std::string const &Directory,
+                          std::string const &Topic,
+                          std::vector<int> const &Partitions,
+                          time_point Time) {
+  auto const TimeMS = toMilliSeconds(Time);
+  std::vector<std::pair<int, int64_t>> PartitionOffsets;
+  for (auto Partition : Partitions) {
+    int64_t UsedOffset{0};
+    bool HasRecords{false};
+    bool Found{false};
+    for (auto const &SegmentFile : getRecordedSegments(
+             getRecordingDirectory(Directory, Topic, Partition))) {
+      try {
+        Stream::SpoolSegment Segment(SegmentFile);
+        size_t Position{0};
+        Stream::SpoolRecordHeader Header;
+        std::uint8_t const *Data{nullptr};
+        while (Segment.readRecord(Position, Header, Data)) {
+          HasRecords = true;
+          UsedOffset = Header.Offset;
+          if (Header.KafkaTimestamp >= TimeMS) {
+            Found = true;
+            break;
+          }
+        }
+      } catch (std::exception &E) {
+        LOG_ERROR("Skipping recorded segment: {}", E.what());
+      }
+      if (Found) {
+        break;
+      }
+    }
+    if (HasRecords and not Found) {
+      // All messages are older, start after the last one.
+      ++UsedOffset;
+    }
+    PartitionOffsets.emplace_back(Partition, UsedOffset);
+  }
+  return PartitionOffsets;
+}
+
+ReplayConsumer::ReplayConsumer(std::string ReplayDirectory)
+    : Directory(std::move(ReplayDirectory)) {}
+
+void ReplayConsumer::addTopic(std::string const &Topic) {
+  Readers.clear();
+  NextReader = 0;
+  for (auto Partition : getRecordedPartitions(Directory, Topic)) {
+    PartitionReader NewReader;
+    NewReader.SegmentFiles =
+        getRecordedSegments(getRecordingDirectory(Directory, Topic, Partition));
+    Readers.emplace_back(std::move(NewReader));
+  }
+}
+
+void ReplayConsumer::addPartitionAtOffset(std::string const &Topic,
+                                          int PartitionId, int64_t Offset) {
+  Readers.clear();
+  NextReader = 0;
+  PartitionReader NewReader;
+  NewReader.SegmentFiles =
+      getRecordedSegments(getRecordingDirectory(Directory, Topic, PartitionId));
+  NewReader.StartOffset = Offset;
+  Readers.emplace_back(std::move(NewReader));
+}
+
+std::vector<int32_t>
+ReplayConsumer::queryTopicPartitions(const std::string &TopicName) {
+  auto Partitions = getRecordedPartitions(Directory, TopicName);
+  return {Partitions.begin(), Partitions.end()};
+}
+
+bool ReplayConsumer::readNext(PartitionReader &Reader,
+                              FileWriter::Msg &Message) {
+  Stream::SpoolRecordHeader Header;
+  std::uint8_t const *Data{nullptr};
+  while (true) {
+    if (Reader.CurrentSegment == nullptr or
+        not Reader.CurrentSegment->readRecord(Reader.Position, Header, Data)) {
+      if (Reader.NextSegment >= Reader.SegmentFiles.size()) {
+        Reader.CurrentSegment.reset();
+        return false;
+      }
+      try {
+        Reader.CurrentSegment = std::make_unique<Stream::SpoolSegment>(
+            Reader.SegmentFiles[Reader.NextSegment]);
+      } catch (std::exception &E) {
+        LOG_ERROR("Skipping recorded segment: {}", E.what());
+        Reader.CurrentSegment.reset();
+      }
+      ++Reader.NextSegment;
+      Reader.Position = 0;
+      continue;
+    }
+    if (Header.Offset >= Reader.StartOffset) {
+      break;
+    }
+  }
+  Message = FileWriter::Msg(
+      Data, Header.Size,
+      FileWriter::MessageMetaData{
+          std::chrono::milliseconds(Header.KafkaTimestamp),
+          RdKafka::MessageTimestamp::MSG_TIMESTAMP_CREATE_TIME, Header.Offset,
+          Header.Partition});
+  return true;
+}
+
+std::pair<PollStatus, FileWriter::Msg> ReplayConsumer::poll() {
+  FileWriter::Msg Message;
+  for (size_t i = 0; i < Readers.size(); ++i) {
+    auto &Reader = Readers[NextReader];
+    NextReader = (NextReader + 1) % Readers.size();
+    if (readNext(Reader, Message)) {
+      return {PollStatus::Message, std::move(Message)};
+    }
+  }
+  std::this_thread::sleep_for(EndOfDataWait);
+  return {PollStatus::TimedOut, std::move(Message)};
+}
+
+std::unique_ptr<ConsumerInterface>
+ReplayConsumerFactory::createConsumer(BrokerSettings const &) {
+  return std::make_unique<ReplayConsumer>(Directory);
+}
+
+} // namespace Kafka
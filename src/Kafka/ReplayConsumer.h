@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+/// \file
+/// \brief Consumer that replays messages recorded to disk instead of
+/// consuming them from a Kafka broker.
+///
+/// Recorded messages are stored in spool segment files (see
+/// Stream::SpoolSegment) using the directory layout
+/// `<directory>/<topic>/partition_<n>/segment_<i>.spool`.
+
+#pragma once
+
+#include "ConsumerFactory.h"
+#include "Stream/SpoolSegment.h"
+#include "TimeUtility.h"
+#include <set>
+
+namespace Kafka {
+
+/// \brief Directory in which the messages of a topic partition are recorded.
+std::string getRecordingDirectory(std::string const &Directory,
+                                  std::string const &Topic, int Partition);
+
+/// \brief Get the (sorted) list of segment files of a recorded topic
+/// partition.
+std::vector<std::string>
+getRecordedSegments(std::string const &PartitionDirectory);
+
+/// \brief The names of the topics that have been recorded.
+std::set<std::string> getRecordedTopics(std::string const &Directory);
+
+/// \brief The partitions of a topic that have been recorded.
+std::vector<int> getRecordedPartitions(std::string const &Directory,
+                                       std::string const &Topic);
+
+/// \brief Replay equivalent of Kafka::getOffsetForTime().
+///
+/// \return The offset of the first recorded message (per partition) with a
+/// Kafka timestamp equal to or later than the given time.
+std::vector<std::pair<int, int64_t>>
+getRecordedOffsetsForTime(std::string const &Directory,
+                          std::string const &Topic,
+                          std::vector<int> const &Partitions, time_point Time);
+
+class ReplayConsumer : public ConsumerInterface {
+public:
+  explicit ReplayConsumer(std::string ReplayDirectory);
+  ~ReplayConsumer() override = default;
+
+  /// \brief Replay all recorded partitions of a topic from the start.
+  void addTopic(std::string const &Topic) override;
+
+  /// \brief Replay a recorded partition of a topic starting at an offset.
+  void addPartitionAtOffset(std::string const &Topic, int PartitionId,
+                            int64_t Offset) override;
+
+  std::vector<int32_t>
+  queryTopicPartitions(const std::string &TopicName) override;
+
+  /// \brief Get the next recorded message.
+  ///
+  /// Messages are returned as fast as possible. When all recorded messages
+  /// have been returned, PollStatus::TimedOut is returned (after a short
+  /// wait).
+  std::pair<PollStatus, FileWriter::Msg> poll() override;
+
+private:
+  struct PartitionReader {
+    std::vector<std::string> SegmentFiles;
+    size_t NextSegment{0};
+    std::unique_ptr<Stream::SpoolSegment> CurrentSegment;
+    size_t Position{0};
+    int64_t StartOffset{0};
+  };
+  bool readNext(PartitionReader &Reader, FileWriter::Msg &Message);
+  std::string Directory;
+  std::vector<PartitionReader> Readers;
+  size_t NextReader{0};
+  duration EndOfDataWait{100ms};
+};
+
+class ReplayConsumerFactory : public ConsumerFactoryInterface {
+public:
+  explicit ReplayConsumerFactory(std::string ReplayDirectory)
+      : Directory(std::move(ReplayDirectory)) {}
+  std::unique_ptr<ConsumerInterface>
+  createConsumer(BrokerSettings const &Settings) override;
+  ~ReplayConsumerFactory() override = default;
+
+private:
+  std::string Directory;
+};
+} // namespace Kafka
@@ -23,5 +23,5 @@ void MainOpt::init() {
 
 void setupLoggerFromOptions(MainOpt const &opt) {
   setUpLogging(opt.LoggingLevel, opt.ServiceID, opt.LogFilename,
-               opt.GraylogLoggerAddress);
+               opt.GraylogLoggerAddress, opt.AsyncLogging);
 }
@@ -15,6 +15,7 @@
 #include "logger.h"
 
 #include <chrono>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -48,6 +49,9 @@ struct MainOpt {
   /// Used for logging to file
   std::string LogFilename;
 
+  /// Pass log messages to the sinks from a background thread.
+  bool AsyncLogging{false};
+
   /// Kafka broker and topic where file writer commands are published.
   uri::URI CommandBrokerURI{"localhost:9092/kafka-to-nexus.command"};
 
@@ -57,12 +61,58 @@ struct MainOpt {
   /// commands.
   std::string HDFOutputPrefix;
 
+  /// \brief Directory (preferably on fast local storage) to write the files
+  /// in.
+  ///
+  /// Files are moved to the output directory (HDFOutputPrefix) in the
+  /// background when they have been written (see FileMover). Disabled if
+  /// empty.
+  std::string ScratchDirectory;
+
   /// Used for command line argument.
   bool ListWriterModules = false;
 
+  /// \brief Name of the predefined file access profile (see
+  /// FileAccessProfile) used for new files.
+  std::string FileAccessProfileName{"default"};
+
+  /// \brief File access settings (JSON object) applied on top of the
+  /// profile. Can be overridden per job with a "file_access" object in the
+  /// NeXus structure.
+  std::string FileAccessSettings;
+
   /// Kafka topic where status updates are to be published.
   uri::URI KafkaStatusURI{"localhost:9092/kafka-to-nexus.status"};
 
+  /// \brief Ceiling for the memory used by all in-flight messages.
+  ///
+  /// Consumption of data is throttled when the ceiling is reached. A value of
+  /// 0 means no ceiling.
+  size_t MaxBufferedBytes{0};
+
+  /// \brief Directory of the cache of skeleton files (see SkeletonCache).
+  ///
+  /// New files are created from a cached skeleton file if there is one for
+  /// the NeXus structure. Disabled if empty.
+  std::string SkeletonCacheDirectory;
+
+  /// Attributes that are expected to change from run to run and are written
+  /// to each file created from a skeleton file.
+  std::vector<std::string> SkeletonVolatileAttributes;
+
+  /// Paths of datasets (e.g. /entry/title) that are expected to change from
+  /// run to run and are written to each file created from a skeleton file.
+  std::vector<std::string> SkeletonVolatileDatasets;
+
+  /// The maximum total size (in bytes) of the skeleton files in the cache,
+  /// the least recently used ones are removed when it is exceeded. 0 means no
+  /// limit.
+  std::uintmax_t SkeletonCacheMaxSize{0};
+
+  /// \brief File to write the recorded trace spans to (as Chrome trace event
+  /// JSON) on SIGUSR1 and on exit. Requires a build with ENABLE_TRACING.
+  std::string TraceFilename;
+
   /// \brief Interval to publish status of `Master`
   /// (e.g. list of current file writings).
   std::chrono::milliseconds StatusMasterIntervalMS{2000};
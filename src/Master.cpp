@@ -10,6 +10,7 @@
 #include "Master.h"
 #include "CommandListener.h"
 #include "CommandParser.h"
+#include "Filesystem.h"
 #include "JobCreator.h"
 #include "Status/StatusReporter.h"
 #include "helper.h"
@@ -59,6 +60,16 @@ Master::Master(MainOpt &Config, std::unique_ptr<CommandListener> Listener,
       MasterMetricsRegistrar(Registrar) {
   CmdListener->start();
   Logger->info("getFileWriterProcessId: {}", Config.ServiceID);
+  if (not Config.ScratchDirectory.empty()) {
+    Mover = std::make_unique<FileMover>();
+  }
+}
+
+Master::~Master() {
+  // Close the file (and queue its move) before the mover is destroyed.
+  if (CurrentStreamController != nullptr) {
+    setToIdle();
+  }
 }
 
 FileWriterState Master::handleCommand(Msg const &CommandMessage) {
@@ -85,6 +96,9 @@ void Master::startWriting(StartCommandInfo const &StartInfo) {
                                 StartInfo.StartTime, StartInfo.StopTime});
     CurrentStreamController = Creator_->createFileWritingJob(
         StartInfo, MainConfig, Logger, MasterMetricsRegistrar);
+    // Only set once the job has created the file, a file with the same name
+    // left in the scratch directory by someone else is not moved.
+    CurrentFileName = StartInfo.Filename;
   } catch (std::runtime_error const &Error) {
     Logger->error("{}", Error.what());
     setToIdle();
@@ -126,6 +140,20 @@ void Master::run() {
     moveToNewState(this->handleCommand(KafkaMessage.second));
   }
 
+  // Getting the figures is not free (e.g. the size of the file), only do so
+  // as often as the status is reported.
+  auto const Now = std::chrono::steady_clock::now();
+  if (Now >= NextStatusUpdate) {
+    NextStatusUpdate = Now + MainConfig.StatusMasterIntervalMS;
+    if (CurrentStreamController != nullptr) {
+      Reporter->updatePerformanceInfo(
+          CurrentStreamController->getPerformanceInfo());
+    }
+    if (Mover != nullptr) {
+      Reporter->updateFileMoves(Mover->getMoveInfo());
+    }
+  }
+
   // Doesn't stop immediately when commanded to.
   // Also, can stop even if not commanded to.
   if (hasWritingStopped()) {
@@ -138,7 +166,18 @@ bool Master::isWriting() const {
 }
 
 void Master::setToIdle() {
+  // Closes the file.
+  auto const FileWasClosed = CurrentStreamController != nullptr;
   CurrentStreamController.reset(nullptr);
+  if (Mover != nullptr and FileWasClosed and not CurrentFileName.empty()) {
+    auto const ScratchFileName =
+        prefixPath(MainConfig.ScratchDirectory, CurrentFileName);
+    if (fs::exists(ScratchFileName)) {
+      Mover->moveFile(ScratchFileName, prefixPath(MainConfig.HDFOutputPrefix,
+                                                  CurrentFileName));
+    }
+  }
+  CurrentFileName.clear();
   CurrentState = States::Idle();
   Reporter->resetStatusInfo();
 }
@@ -10,12 +10,14 @@
 #pragma once
 
 #include "CommandParser.h"
+#include "FileMover.h"
 #include "Kafka/PollStatus.h"
 #include "MainOpt.h"
 #include "Metrics/Registrar.h"
 #include "Msg.h"
 #include "States.h"
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -43,7 +45,7 @@ public:
          std::unique_ptr<IJobCreator> Creator,
          std::unique_ptr<Status::StatusReporter> Reporter,
          Metrics::Registrar const &Registrar);
-  virtual ~Master() = default;
+  virtual ~Master();
 
   /// \brief Sets up command listener and handles any commands received.
   ///
@@ -61,6 +63,12 @@ private:
   std::unique_ptr<Status::StatusReporter> Reporter;
   Metrics::Registrar MasterMetricsRegistrar;
   FileWriterState CurrentState = States::Idle();
+  /// The file name of the current job, as given in the start command.
+  std::string CurrentFileName;
+  /// Moves written files from the scratch directory, if one is used.
+  std::unique_ptr<FileMover> Mover;
+  /// When to next update the performance figures and file moves to report.
+  std::chrono::steady_clock::time_point NextStatusUpdate;
   virtual void startWriting(StartCommandInfo const &StartInfo);
   virtual void requestStopWriting(StopCommandInfo const &StopInfo);
   virtual bool hasWritingStopped();
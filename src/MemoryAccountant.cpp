@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "MemoryAccountant.h"
+#include "Metrics/Registrar.h"
+#include <algorithm>
+
+namespace FileWriter {
+
+MemoryAccountant &MemoryAccountant::getInstance() {
+  static MemoryAccountant Instance;
+  return Instance;
+}
+
+void MemoryAccountant::add(size_t Bytes) {
+  BytesInUse.fetch_add(Bytes);
+  BytesInUseMetric += Bytes;
+}
+
+void MemoryAccountant::remove(size_t Bytes) {
+  BytesInUse.fetch_sub(Bytes);
+  BytesInUseMetric -= Bytes;
+}
+
+bool MemoryAccountant::isOverBudget() const {
+  auto Limit = MaxBufferedBytes.load();
+  return Limit != 0 and BytesInUse.load() >= Limit;
+}
+
+std::shared_ptr<ConsumerStats> MemoryAccountant::addConsumer() {
+  auto NewConsumer = std::make_shared<ConsumerStats>();
+  std::lock_guard<std::mutex> Lock(ConsumersMutex);
+  Consumers.emplace_back(NewConsumer);
+  return NewConsumer;
+}
+
+void MemoryAccountant::updateRates(std::chrono::steady_clock::time_point Now) {
+  Consumers.erase(std::remove_if(Consumers.begin(), Consumers.end(),
+                                 [](auto &Item) { return Item.expired(); }),
+                  Consumers.end());
+  auto TimeDiff = std::chrono::duration<double>(Now - LastRateUpdate).count();
+  LastRateUpdate = Now;
+  NextRateUpdate = Now + RateUpdateInterval;
+  for (auto &Item : Consumers) {
+    if (auto Consumer = Item.lock()) {
+      auto CurrentBytes = Consumer->ConsumedBytes.load();
+      auto CurrentThrottledTime = Consumer->ThrottledTime.load();
+      auto ThrottledSeconds =
+          (CurrentThrottledTime - Consumer->LastThrottledTime) * 1e-9;
+      auto ActiveTime = TimeDiff - ThrottledSeconds;
+      // Keep the previous rate of a consumer that has (almost) only been
+      // throttled, its rate would otherwise drop to about zero.
+      if (ActiveTime > TimeDiff * 0.01) {
+        Consumer->Rate =
+            (CurrentBytes - Consumer->LastConsumedBytes) / ActiveTime;
+      }
+      Consumer->LastConsumedBytes = CurrentBytes;
+      Consumer->LastThrottledTime = CurrentThrottledTime;
+    }
+  }
+}
+
+bool MemoryAccountant::shouldThrottle(ConsumerStats const &Consumer) {
+  auto Limit = MaxBufferedBytes.load();
+  if (Limit == 0) {
+    return false;
+  }
+  auto Now = std::chrono::steady_clock::now();
+  auto InUse = BytesInUse.load();
+  if (InUse < Limit) {
+    if (Now >= NextRateUpdate.load()) {
+      std::lock_guard<std::mutex> Lock(ConsumersMutex);
+      if (Now >= NextRateUpdate.load()) {
+        updateRates(Now);
+      }
+    }
+    return false;
+  }
+  std::lock_guard<std::mutex> Lock(ConsumersMutex);
+  if (Now >= NextRateUpdate.load()) {
+    updateRates(Now);
+  }
+  auto Overshoot = double(InUse - Limit) / (Limit * FullThrottleOvershoot);
+  auto NrOfConsumers = Consumers.size();
+  auto NrToThrottle = std::min(
+      NrOfConsumers, 1 + static_cast<size_t>(Overshoot * NrOfConsumers));
+
+  // Rank the consumer by data rate, ties are broken by address.
+  size_t Rank{0};
+  for (auto &Item : Consumers) {
+    auto Other = Item.lock();
+    if (Other == nullptr or Other.get() == &Consumer) {
+      continue;
+    }
+    if (Other->Rate > Consumer.Rate or
+        (Other->Rate == Consumer.Rate and Other.get() < &Consumer)) {
+      ++Rank;
+    }
+  }
+  if (Rank < NrToThrottle) {
+    Throttles++;
+    return true;
+  }
+  return false;
+}
+
+void MemoryAccountant::registerMetrics(Metrics::Registrar const &Registrar) {
+  auto UsedRegistrar = Registrar;
+  UsedRegistrar.registerMetric(BytesInUseMetric, {Metrics::LogTo::CARBON});
+  UsedRegistrar.registerMetric(Throttles, {Metrics::LogTo::CARBON});
+}
+
+} // namespace FileWriter
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#pragma once
+
+#include "Metrics/Metric.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Metrics {
+class Registrar;
+}
+
+namespace FileWriter {
+
+/// \brief Book keeping of the data rate of a consumer (partition).
+///
+/// Used by the MemoryAccountant to decide which consumers to throttle.
+struct ConsumerStats {
+  std::atomic<std::uint64_t> ConsumedBytes{0};
+  /// Time (ns) the consumer has spent throttled, which is not counted when
+  /// calculating the data rate.
+  std::atomic<std::int64_t> ThrottledTime{0};
+  // The following members are guarded by the mutex of the MemoryAccountant.
+  std::uint64_t LastConsumedBytes{0};
+  std::int64_t LastThrottledTime{0};
+  double Rate{0.0}; // Bytes per second
+};
+
+/// \brief Keeps track of the memory used by all in-flight messages.
+///
+/// All message buffers are allocated through the BufferPool which reports
+/// allocations and releases to this class. If a ceiling is set and the amount
+/// of memory in use is above that ceiling, consumers are throttled, highest
+/// data rate first. The further above the ceiling we are, the more consumers
+/// are throttled.
+class MemoryAccountant {
+public:
+  /// \brief Going this fraction (of the ceiling) above the ceiling will
+  /// throttle all consumers.
+  static constexpr double FullThrottleOvershoot{0.1};
+  static constexpr std::chrono::milliseconds RateUpdateInterval{1000};
+
+  MemoryAccountant() = default;
+
+  static MemoryAccountant &getInstance();
+
+  void add(size_t Bytes);
+  void remove(size_t Bytes);
+  size_t getBytesInUse() const { return BytesInUse.load(); }
+
+  /// \brief Set the ceiling. A value of 0 means no ceiling.
+  void setLimit(size_t MaxBytes) { MaxBufferedBytes = MaxBytes; }
+  size_t getLimit() const { return MaxBufferedBytes.load(); }
+  bool isOverBudget() const;
+
+  /// \brief Register a consumer that should be throttled when we are over
+  /// budget. De-registration happens when the returned pointer is released.
+  std::shared_ptr<ConsumerStats> addConsumer();
+
+  /// \brief Should the consumer pause consumption of data?
+  ///
+  /// Also updates the data rates of the consumers (if a ceiling is set) so
+  /// that they are known when the ceiling is reached.
+  bool shouldThrottle(ConsumerStats const &Consumer);
+
+  void registerMetrics(Metrics::Registrar const &Registrar);
+
+protected:
+  void updateRates(std::chrono::steady_clock::time_point Now);
+  std::atomic<size_t> BytesInUse{0};
+  std::atomic<size_t> MaxBufferedBytes{0};
+  std::mutex ConsumersMutex;
+  std::vector<std::weak_ptr<ConsumerStats>> Consumers;
+  std::chrono::steady_clock::time_point LastRateUpdate{
+      std::chrono::steady_clock::now()};
+  std::atomic<std::chrono::steady_clock::time_point> NextRateUpdate{
+      LastRateUpdate + RateUpdateInterval};
+  Metrics::Gauge BytesInUseMetric{
+      "bytes_in_use", "Memory used by all in-flight message buffers."};
+  Metrics::Metric Throttles{
+      "throttles", "Number of times a consumer was told to back off due to "
+                   "the memory ceiling being reached."};
+};
+
+} // namespace FileWriter
@@ -127,8 +127,8 @@ void Connection::Impl::trySendMessage() {
   std::string NewMessage;
   bool PopResult = Messages.try_dequeue(NewMessage);
   if (PopResult) {
-    std::copy(NewMessage.begin(), NewMessage.end(),
-              std::back_inserter(MessageBuffer));
+    MessageBuffer.insert(MessageBuffer.end(), NewMessage.begin(),
+                         NewMessage.end());
     asio::async_write(Socket, asio::buffer(MessageBuffer), HandlerGlue);
   } else if (!MessageBuffer.empty()) {
     asio::async_write(Socket, asio::buffer(MessageBuffer), HandlerGlue);
@@ -143,10 +143,8 @@ void Connection::Impl::sentMessageHandler(asio::error_code const &Error,
   if (BytesSent == MessageBuffer.size()) {
     MessageBuffer.clear();
   } else if (BytesSent > 0) {
-    std::vector<char> TempVector;
-    std::copy(MessageBuffer.begin() + BytesSent, MessageBuffer.end(),
-              std::back_inserter(TempVector));
-    MessageBuffer = TempVector;
+    MessageBuffer.erase(MessageBuffer.begin(),
+                        MessageBuffer.begin() + BytesSent);
   }
   if (Error) {
     Socket.close();
@@ -1,22 +1,62 @@
 #include "CarbonSink.h"
 #include "InternalMetric.h"
+#include <iterator>
 
 namespace Metrics {
 
 void CarbonSink::reportMetric(InternalMetric &MetricToBeReported) {
-  auto CurrentValue =
-      MetricToBeReported.Counter->load(std::memory_order_relaxed);
+  auto Now = std::chrono::system_clock::now();
   auto CurrentName = MetricToBeReported.FullName;
   auto TimeSinceEpoch = std::chrono::duration_cast<std::chrono::seconds>(
-                            std::chrono::system_clock::now().time_since_epoch())
+                            Now.time_since_epoch())
                             .count();
-  CarbonConnection.sendMessage(
-      fmt::format("{} {} {}\n", CurrentName, CurrentValue, TimeSinceEpoch));
+  if (MetricToBeReported.HistogramPtr != nullptr) {
+    reportHistogram(MetricToBeReported, TimeSinceEpoch);
+    return;
+  }
+  auto CurrentValue = MetricToBeReported.MetricPtr->value();
+  fmt::format_to(std::back_inserter(Batch), "{} {} {}\n", CurrentName,
+                 CurrentValue, TimeSinceEpoch);
+  if (MetricToBeReported.Type == MetricType::RATE) {
+    fmt::format_to(std::back_inserter(Batch), "{}.per_second {:.3f} {}\n",
+                   CurrentName,
+                   getRatePerSecond(MetricToBeReported, CurrentValue, Now),
+                   TimeSinceEpoch);
+    MetricToBeReported.LastValue = CurrentValue;
+    MetricToBeReported.LastTime = Now;
+  }
+}
+
+void CarbonSink::reportHistogram(InternalMetric &MetricToBeReported,
+                                 std::int64_t TimeSinceEpoch) {
+  auto Summary = MetricToBeReported.HistogramPtr->summariseSince(
+      MetricToBeReported.LastBinCounts);
+  auto const &Name = MetricToBeReported.FullName;
+  fmt::format_to(std::back_inserter(Batch), "{}.count {} {}\n", Name,
+                 Summary.Count, TimeSinceEpoch);
+  if (Summary.Count == 0) {
+    return;
+  }
+  std::pair<char const *, std::int64_t> const Series[]{
+      {"p50", Summary.P50},   {"p90", Summary.P90}, {"p99", Summary.P99},
+      {"p999", Summary.P999}, {"max", Summary.Max}};
+  for (auto const &NameValue : Series) {
+    fmt::format_to(std::back_inserter(Batch), "{}.{} {} {}\n", Name,
+                   NameValue.first, NameValue.second, TimeSinceEpoch);
+  }
+}
+
+void CarbonSink::flush() {
+  if (Batch.size() == 0) {
+    return;
+  }
+  CarbonConnection.sendMessage(std::string(Batch.data(), Batch.size()));
+  Batch.clear();
 }
 
 bool CarbonSink::isHealthy() {
-  // If it has successfully sent the previous batch of metrics then report
-  // healthy and ready for a next batch
+  // If it has successfully sent (or at least started sending) the previous
+  // batch of metrics then report healthy and ready for a next batch
   return (CarbonConnection.messageQueueSize() == 0);
 }
 } // namespace Metrics
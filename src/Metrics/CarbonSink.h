@@ -12,6 +12,7 @@
 #include "CarbonInterface.h"
 #include "Sink.h"
 #include "logger.h"
+#include <fmt/format.h>
 
 namespace Metrics {
 
@@ -23,8 +24,18 @@ public:
   LogTo getType() override { return LogTo::CARBON; };
   bool isHealthy() override;
 
+  /// Sends the metrics of the current report period as one message.
+  void flush() override;
+
 private:
+  /// Reports the number of values and percentiles (as separate series) of the
+  /// values added since the last report.
+  void reportHistogram(InternalMetric &MetricToBeReported,
+                       std::int64_t TimeSinceEpoch);
   Carbon::Connection CarbonConnection;
+  /// The lines of the current report period. Cleared (but not deallocated)
+  /// when sent, so that it is only re-allocated if the batch grows.
+  fmt::memory_buffer Batch;
   SharedLogger Logger = getLogger();
 };
 } // namespace Metrics
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "Histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Metrics {
+
+size_t Histogram::getBinIndex(std::uint64_t Value) {
+  if (Value < NrOfSubBins) {
+    return Value;
+  }
+  int const Exponent = 63 - __builtin_clzll(Value);
+  auto const SubBin = (Value >> (Exponent - SubBinsLog2)) & (NrOfSubBins - 1);
+  return (Exponent - SubBinsLog2 + 1) * NrOfSubBins + SubBin;
+}
+
+std::int64_t Histogram::getBinUpperLimit(size_t Index) {
+  if (Index < NrOfSubBins) {
+    return Index;
+  }
+  auto const Exponent = Index / NrOfSubBins + SubBinsLog2 - 1;
+  auto const SubBin = Index % NrOfSubBins;
+  auto const BinWidth = std::uint64_t(1) << (Exponent - SubBinsLog2);
+  auto const UpperLimit =
+      (std::uint64_t(1) << Exponent) + (SubBin + 1) * BinWidth - 1;
+  return static_cast<std::int64_t>(
+      std::min(UpperLimit, std::uint64_t(std::numeric_limits<int64_t>::max())));
+}
+
+void Histogram::add(std::int64_t Value) {
+  auto const UsedValue =
+      static_cast<std::uint64_t>(std::max(Value, std::int64_t(0)));
+  Bins[getBinIndex(UsedValue)].fetch_add(1, std::memory_order_relaxed);
+  Metric::operator++();
+}
+
+std::uint64_t Histogram::count() const {
+  std::uint64_t Sum{0};
+  for (auto const &Bin : Bins) {
+    Sum += Bin.load(std::memory_order_relaxed);
+  }
+  return Sum;
+}
+
+std::int64_t Histogram::percentile(double Fraction) const {
+  return percentile(getBinCounts(), Fraction);
+}
+
+Histogram::BinCounts Histogram::getBinCounts() const {
+  BinCounts Counts(Bins.size());
+  for (size_t i = 0; i < Bins.size(); ++i) {
+    Counts[i] = Bins[i].load(std::memory_order_relaxed);
+  }
+  return Counts;
+}
+
+HistogramSummary Histogram::summariseSince(BinCounts &PreviousCounts) const {
+  auto CurrentCounts = getBinCounts();
+  BinCounts IntervalCounts(CurrentCounts);
+  if (PreviousCounts.size() == IntervalCounts.size()) {
+    for (size_t i = 0; i < IntervalCounts.size(); ++i) {
+      IntervalCounts[i] -= PreviousCounts[i];
+    }
+  }
+  PreviousCounts = std::move(CurrentCounts);
+  HistogramSummary Summary;
+  Summary.Count = std::accumulate(IntervalCounts.begin(), IntervalCounts.end(),
+                                  std::uint64_t(0));
+  if (Summary.Count == 0) {
+    return Summary;
+  }
+  Summary.P50 = percentile(IntervalCounts, 0.5);
+  Summary.P90 = percentile(IntervalCounts, 0.9);
+  Summary.P99 = percentile(IntervalCounts, 0.99);
+  Summary.P999 = percentile(IntervalCounts, 0.999);
+  Summary.Max = percentile(IntervalCounts, 1.0);
+  return Summary;
+}
+
+std::int64_t Histogram::percentile(BinCounts const &Counts, double Fraction) {
+  auto const Total =
+      std::accumulate(Counts.begin(), Counts.end(), std::uint64_t(0));
+  if (Total == 0) {
+    return 0;
+  }
+  auto const Limit = static_cast<std::uint64_t>(std::ceil(Fraction * Total));
+  std::uint64_t Sum{0};
+  for (size_t i = 0; i < Counts.size(); ++i) {
+    Sum += Counts[i];
+    if (Sum >= Limit and Sum > 0) {
+      return getBinUpperLimit(i);
+    }
+  }
+  return getBinUpperLimit(Counts.size() - 1);
+}
+
+} // namespace Metrics
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#pragma once
+
+#include "Metric.h"
+#include <array>
+#include <vector>
+
+namespace Metrics {
+
+/// Percentiles etc. of the values added to a histogram during some interval.
+struct HistogramSummary {
+  std::uint64_t Count{0};
+  std::int64_t P50{0};
+  std::int64_t P90{0};
+  std::int64_t P99{0};
+  std::int64_t P999{0};
+  std::int64_t Max{0};
+};
+
+/// Lock free histogram with logarithmically sized bins (in the spirit of HDR
+/// histograms). Every power of two range is divided into 8 bins, i.e. the
+/// relative error of a percentile is at most 1/8. Negative values are counted
+/// as zero.
+///
+/// The counter of the (base) metric holds the number of added values. Sinks
+/// that know about histograms report the percentiles of the values added
+/// since the previous report.
+class Histogram : public Metric {
+public:
+  using BinCounts = std::vector<std::uint64_t>;
+  Histogram(std::string Name, std::string Description,
+            Severity Level = Severity::DEBUG)
+      : Metric(std::move(Name), std::move(Description), Level) {}
+  Histogram const *getHistogram() const override { return this; }
+
+  void add(std::int64_t Value);
+
+  /// Total number of values added.
+  std::uint64_t count() const;
+
+  /// The value below which the given fraction (0 - 1) of all the added
+  /// values are. Rounded up to the upper limit of the bin.
+  std::int64_t percentile(double Fraction) const;
+
+  BinCounts getBinCounts() const;
+
+  /// Summary of the values added since the last call. The bin counts from the
+  /// previous call are kept by the caller, which allows several sinks to
+  /// report on the same histogram.
+  HistogramSummary summariseSince(BinCounts &PreviousCounts) const;
+
+  static std::int64_t percentile(BinCounts const &Counts, double Fraction);
+
+private:
+  static constexpr int SubBinsLog2{3};
+  static constexpr int NrOfSubBins{1 << SubBinsLog2};
+  static constexpr size_t NrOfBins{(64 - SubBinsLog2 + 1) * NrOfSubBins};
+  static size_t getBinIndex(std::uint64_t Value);
+  static std::int64_t getBinUpperLimit(size_t Index);
+  std::array<std::atomic<std::uint64_t>, NrOfBins> Bins{};
+};
+
+} // namespace Metrics
@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include "Histogram.h"
 #include "Metric.h"
 #include <chrono>
 
@@ -17,20 +18,40 @@ namespace Metrics {
 /// Should not be used outside of objects in the Metrics namespace
 /// InternalMetric contains details we need from a Metric instance in order for
 /// the Reporter to report on the Metric
+/// LastValue and LastTime are the value and time of the last report, used for
+/// reporting the change (and rate of change) of the value
 struct InternalMetric {
   explicit InternalMetric(Metric &MetricToGetDetailsFrom, std::string Name)
       : Name(MetricToGetDetailsFrom.getName()), FullName(std::move(Name)),
-        Counter(MetricToGetDetailsFrom.getCounterPtr()),
+        MetricPtr(&MetricToGetDetailsFrom),
         DescriptionString(MetricToGetDetailsFrom.getDescription()),
-        LastValue(MetricToGetDetailsFrom.getCounterPtr()->load()),
-        ValueSeverity(MetricToGetDetailsFrom.getSeverity()){};
+        LastValue(MetricToGetDetailsFrom.value()),
+        ValueSeverity(MetricToGetDetailsFrom.getSeverity()),
+        Type(MetricToGetDetailsFrom.getType()),
+        HistogramPtr(MetricToGetDetailsFrom.getHistogram()){};
   std::string const Name;
   std::string const FullName; // Including prefix from local registrar
-  CounterType *Counter{nullptr};
+  Metric const *MetricPtr{nullptr};
   std::string const DescriptionString;
   std::int64_t LastValue{0};
   std::chrono::system_clock::time_point LastTime{
       std::chrono::system_clock::now()};
   Severity const ValueSeverity;
+  MetricType const Type;
+  Histogram const *HistogramPtr{nullptr};
+  /// Bin counts of the histogram (if any) at the time of the last report.
+  Histogram::BinCounts LastBinCounts;
 };
+
+/// Change per second of the value of the metric since the last report.
+inline double getRatePerSecond(InternalMetric const &MetricToBeReported,
+                               std::int64_t CurrentValue,
+                               std::chrono::system_clock::time_point Now) {
+  auto const Seconds =
+      std::chrono::duration<double>(Now - MetricToBeReported.LastTime).count();
+  if (Seconds <= 0.0) {
+    return 0.0;
+  }
+  return (CurrentValue - MetricToBeReported.LastValue) / Seconds;
+}
 } // namespace Metrics
@@ -13,19 +13,55 @@ namespace Metrics {
 
 void LogSink::reportMetric(InternalMetric &MetricToBeReported) {
   auto Now = std::chrono::system_clock::now();
-  auto CurrentValue =
-      MetricToBeReported.Counter->load(std::memory_order_relaxed);
+  if (MetricToBeReported.HistogramPtr != nullptr) {
+    reportHistogram(MetricToBeReported, Now);
+    return;
+  }
+  auto CurrentValue = MetricToBeReported.MetricPtr->value();
   auto ValueDiff = CurrentValue - MetricToBeReported.LastValue;
   if (ValueDiff != 0) {
+    auto TimeDiff = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        Now - MetricToBeReported.LastTime)
+                        .count();
+    if (MetricToBeReported.Type == MetricType::GAUGE) {
+      Logger->log(LogSeverityMap[MetricToBeReported.ValueSeverity],
+                  "The value of \"{}\" changed by {} to {} in the past {} ms "
+                  "({}).",
+                  MetricToBeReported.FullName, ValueDiff, CurrentValue,
+                  TimeDiff, MetricToBeReported.DescriptionString);
+    } else if (MetricToBeReported.Type == MetricType::RATE) {
+      Logger->log(LogSeverityMap[MetricToBeReported.ValueSeverity],
+                  "In the past {} ms, {} events of type \"{}\" have occurred "
+                  "({:.1f} per second) ({}).",
+                  TimeDiff, ValueDiff, MetricToBeReported.FullName,
+                  getRatePerSecond(MetricToBeReported, CurrentValue, Now),
+                  MetricToBeReported.DescriptionString);
+    } else {
+      Logger->log(
+          LogSeverityMap[MetricToBeReported.ValueSeverity],
+          "In the past {} ms, {} events of type \"{}\" have occurred ({}).",
+          TimeDiff, ValueDiff, MetricToBeReported.FullName,
+          MetricToBeReported.DescriptionString);
+    }
     MetricToBeReported.LastValue = CurrentValue;
+  }
+  MetricToBeReported.LastTime = Now;
+}
+
+void LogSink::reportHistogram(InternalMetric &MetricToBeReported,
+                              std::chrono::system_clock::time_point Now) {
+  auto Summary = MetricToBeReported.HistogramPtr->summariseSince(
+      MetricToBeReported.LastBinCounts);
+  if (Summary.Count != 0) {
     auto TimeDiff = std::chrono::duration_cast<std::chrono::milliseconds>(
                         Now - MetricToBeReported.LastTime)
                         .count();
-    Logger->log(
-        LogSeverityMap[MetricToBeReported.ValueSeverity],
-        "In the past {} ms, {} events of type \"{}\" have occurred ({}).",
-        TimeDiff, ValueDiff, MetricToBeReported.FullName,
-        MetricToBeReported.DescriptionString);
+    Logger->log(LogSeverityMap[MetricToBeReported.ValueSeverity],
+                "In the past {} ms, {} values of \"{}\" ({}): p50 = {}, p99 = "
+                "{}, p99.9 = {}, max = {}.",
+                TimeDiff, Summary.Count, MetricToBeReported.FullName,
+                MetricToBeReported.DescriptionString, Summary.P50, Summary.P99,
+                Summary.P999, Summary.Max);
   }
   MetricToBeReported.LastTime = Now;
 }
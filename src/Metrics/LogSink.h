@@ -11,6 +11,7 @@
 
 #include "Sink.h"
 #include "logger.h"
+#include <chrono>
 
 namespace Metrics {
 
@@ -20,5 +21,9 @@ public:
   LogTo getType() override { return LogTo::LOG_MSG; };
   bool isHealthy() override { return true; };
   SharedLogger Logger = getLogger();
+
+private:
+  void reportHistogram(InternalMetric &MetricToBeReported,
+                       std::chrono::system_clock::time_point Now);
 };
 } // namespace Metrics
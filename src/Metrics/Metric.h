@@ -1,6 +1,6 @@
 #pragma once
 
-#include <atomic>
+#include "ShardedCounter.h"
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -8,48 +8,57 @@
 
 namespace Metrics {
 
+class Histogram;
 class Reporter;
 
 enum struct Severity { DEBUG, INFO, WARNING, ERROR };
 
-using CounterType = std::atomic<int64_t>;
+/// How the value of a metric is interpreted by the sinks.
+enum struct MetricType {
+  COUNTER, ///< Number of events.
+  GAUGE,   ///< Current value of some quantity, e.g. a queue depth.
+  RATE     ///< Number of events (or bytes), also reported per second.
+};
 
+/// Metrics are updated without read-modify-write operations on shared memory
+/// (see ShardedCounter), i.e. updating a metric is cheap while reading its
+/// value is relatively expensive.
 class Metric {
 public:
   Metric(std::string Name, std::string Description,
-         Severity Level = Severity::DEBUG)
-      : MName(std::move(Name)), MDesc(std::move(Description)), SevLvl(Level) {}
-  ~Metric();
-  int64_t operator++() {
-    Counter.store(Counter.load(MemoryOrder) + 1, MemoryOrder);
-    return Counter.load(MemoryOrder);
-  };
-  int64_t operator++(int) {
-    Counter.store(Counter.load(MemoryOrder) + 1, MemoryOrder);
-    return Counter.load(MemoryOrder);
-  };
+         Severity Level = Severity::DEBUG,
+         MetricType Type = MetricType::COUNTER)
+      : MName(std::move(Name)), MDesc(std::move(Description)), SevLvl(Level),
+        MType(Type) {}
+  virtual ~Metric();
+  void operator++() { Counter.add(1); };
+  void operator++(int) { Counter.add(1); };
 
-  template <typename CType> bool operator==(CType const &Rhs) {
-    return Counter.load(MemoryOrder) == Rhs;
+  template <typename CType> bool operator==(CType const &Rhs) const {
+    return value() == Rhs;
   };
 
   template <typename CType> explicit operator CType() const {
-    return static_cast<CType>(Counter.load());
+    return static_cast<CType>(value());
   }
 
+  /// \note Should not be used concurrently with other updates of the metric.
   int64_t operator=(int64_t const &NewValue) {
-    Counter.store(NewValue, MemoryOrder);
-    return Counter.load(MemoryOrder);
-  };
-  int64_t operator+=(int64_t AddValue) {
-    Counter.store(AddValue + Counter.load(MemoryOrder), MemoryOrder);
-    return Counter.load(MemoryOrder);
+    Counter.set(NewValue);
+    return NewValue;
   };
+  void operator+=(int64_t AddValue) { Counter.add(AddValue); };
+  void operator-=(int64_t SubtractValue) { Counter.add(-SubtractValue); };
+
+  int64_t value() const { return Counter.value(); }
 
   std::string getName() const { return MName; }
   std::string getDescription() const { return MDesc; }
   Severity getSeverity() const { return SevLvl; }
-  CounterType *getCounterPtr() { return &Counter; }
+  MetricType getType() const { return MType; }
+
+  /// Returns nullptr unless the metric is a histogram.
+  virtual Histogram const *getHistogram() const { return nullptr; }
 
   void setDeregistrationDetails(std::string const &NameWithPrefix,
                                 std::shared_ptr<Reporter> const &Reporter);
@@ -61,10 +70,30 @@ private:
   std::string FullName;
   std::vector<std::shared_ptr<Reporter>> Reporters;
 
-  std::memory_order const MemoryOrder{std::memory_order::memory_order_relaxed};
   std::string const MName;
   std::string const MDesc;
   Severity const SevLvl;
-  CounterType Counter{0};
+  MetricType const MType;
+  ShardedCounter Counter;
+};
+
+/// Metric with a value that can go up and down. Either set the value (from
+/// one thread) or add to and subtract from it (from any thread).
+class Gauge : public Metric {
+public:
+  Gauge(std::string Name, std::string Description,
+        Severity Level = Severity::DEBUG)
+      : Metric(std::move(Name), std::move(Description), Level,
+               MetricType::GAUGE) {}
+  using Metric::operator=;
+};
+
+/// Counter that is also reported as a rate (per second) by the sinks.
+class Rate : public Metric {
+public:
+  Rate(std::string Name, std::string Description,
+       Severity Level = Severity::DEBUG)
+      : Metric(std::move(Name), std::move(Description), Level,
+               MetricType::RATE) {}
 };
 } // namespace Metrics
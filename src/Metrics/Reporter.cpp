@@ -9,7 +9,9 @@ void Reporter::reportMetrics() {
     for (auto &MetricNameValue : MetricsToReportOn) {
       MetricSink->reportMetric(MetricNameValue.second);
     }
+    MetricSink->flush();
   } else {
+    DroppedBatches++;
     std::string MetricsSinkName{"Unknown"};
     std::map<LogTo, std::string> SinkNameMap{
         {LogTo::CARBON, "grafana/graphite"}, {LogTo::LOG_MSG, "log-message"}};
@@ -56,6 +58,9 @@ void Reporter::waitForStop() {
 }
 
 Reporter::~Reporter() {
+  if (not DroppedBatchesName.empty()) {
+    tryRemoveMetric(DroppedBatchesName);
+  }
   {
     std::lock_guard<std::mutex> Lock(MetricsMapMutex);
     if (!MetricsToReportOn.empty()) {
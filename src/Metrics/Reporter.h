@@ -10,6 +10,7 @@
 #pragma once
 
 #include "InternalMetric.h"
+#include "Metric.h"
 #include "Sink.h"
 #include <asio.hpp>
 #include <map>
@@ -20,9 +21,16 @@ namespace Metrics {
 
 class Reporter {
 public:
-  Reporter(std::unique_ptr<Sink> MetricSink, std::chrono::milliseconds Interval)
+  /// \param StatisticsPrefix If not empty, the reporter also reports on its
+  /// own metrics (e.g. the number of dropped batches) using this prefix.
+  Reporter(std::unique_ptr<Sink> MetricSink, std::chrono::milliseconds Interval,
+           std::string const &StatisticsPrefix = "")
       : MetricSink(std::move(MetricSink)), IO(), Period(Interval),
         AsioTimer(IO, Period) {
+    if (not StatisticsPrefix.empty()) {
+      DroppedBatchesName = StatisticsPrefix + "." + DroppedBatches.getName();
+      addMetric(DroppedBatches, DroppedBatchesName);
+    }
     start();
   };
 
@@ -38,6 +46,12 @@ private:
   void waitForStop();
 
   std::unique_ptr<Sink> MetricSink;
+  /// Not registered through a Registrar as that would make the metric keep
+  /// the reporter alive.
+  Metric DroppedBatches{"dropped_batches",
+                        "Report periods skipped as the sink was not ready.",
+                        Severity::WARNING};
+  std::string DroppedBatchesName;
   std::mutex MetricsMapMutex; // lock when accessing MetricToReportOn
   std::map<std::string, InternalMetric> MetricsToReportOn; // MetricName: Metric
   asio::io_context IO;
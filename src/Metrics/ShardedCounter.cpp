@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "ShardedCounter.h"
+#include <mutex>
+
+namespace Metrics {
+
+namespace {
+/// Hands out the exclusive shards (1 to NrOfShards - 1) to threads.
+class ShardAllocator {
+public:
+  static ShardAllocator &getInstance() {
+    static ShardAllocator Instance;
+    return Instance;
+  }
+  size_t claim() {
+    std::lock_guard<std::mutex> Lock(AllocatorMutex);
+    for (size_t i = 1; i < InUse.size(); ++i) {
+      if (not InUse[i]) {
+        InUse[i] = true;
+        return i;
+      }
+    }
+    return 0;
+  }
+  void release(size_t Index) {
+    std::lock_guard<std::mutex> Lock(AllocatorMutex);
+    InUse[Index] = false;
+  }
+
+private:
+  std::mutex AllocatorMutex;
+  std::array<bool, ShardedCounter::NrOfShards> InUse{};
+};
+
+/// Releases the shard when the thread exits.
+class ThreadShard {
+public:
+  ThreadShard() : Index(ShardAllocator::getInstance().claim()) {}
+  ~ThreadShard() { ShardAllocator::getInstance().release(Index); }
+  size_t const Index;
+};
+} // namespace
+
+size_t ShardedCounter::getThreadShardIndex() {
+  thread_local ThreadShard CurrentShard;
+  return CurrentShard.Index;
+}
+
+std::int64_t ShardedCounter::value() const {
+  std::int64_t Sum{0};
+  for (auto const &CurrentShard : Shards) {
+    Sum += CurrentShard.Value.load(std::memory_order_relaxed);
+  }
+  return Sum;
+}
+
+void ShardedCounter::set(std::int64_t NewValue) {
+  Shards[SharedShardIndex].Value.store(NewValue, std::memory_order_relaxed);
+  for (size_t i = 1; i < Shards.size(); ++i) {
+    Shards[i].Value.store(0, std::memory_order_relaxed);
+  }
+}
+
+} // namespace Metrics
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Metrics {
+
+/// Counter that is split into several cache line sized shards in order for
+/// threads to not contend for the same cache line when incrementing it.
+///
+/// A thread is given a shard of its own (for as long as it lives) if there is
+/// one available; such a shard is updated without a read-modify-write
+/// operation. Threads that do not get a shard of their own share the first
+/// shard, which is updated atomically. The shards are summed on read, i.e.
+/// reading is much more expensive than writing.
+class ShardedCounter {
+public:
+  static constexpr size_t NrOfShards{8};
+
+  void add(std::int64_t Value) {
+    auto const Index = getThreadShardIndex();
+    auto &Cell = Shards[Index].Value;
+    if (Index == SharedShardIndex) {
+      Cell.fetch_add(Value, std::memory_order_relaxed);
+    } else {
+      Cell.store(Cell.load(std::memory_order_relaxed) + Value,
+                 std::memory_order_relaxed);
+    }
+  }
+
+  std::int64_t value() const;
+
+  /// Set the value of the counter.
+  ///
+  /// \note Not atomic with respect to concurrent calls to add().
+  void set(std::int64_t NewValue);
+
+  /// Index of the shard used by the calling thread.
+  static size_t getThreadShardIndex();
+
+private:
+  static constexpr size_t SharedShardIndex{0};
+  struct alignas(64) Shard {
+    std::atomic<std::int64_t> Value{0};
+  };
+  std::array<Shard, NrOfShards> Shards{};
+};
+
+} // namespace Metrics
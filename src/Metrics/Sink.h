@@ -25,6 +25,10 @@ public:
   /// report on
   virtual bool isHealthy() = 0;
 
+  /// Called once all metrics of a report period have been passed to
+  /// reportMetric, for sinks that send the metrics of a period in one batch
+  virtual void flush() {}
+
   virtual LogTo getType() = 0;
   virtual ~Sink() = default;
 };
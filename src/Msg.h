@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include "BufferPool.h"
 #include "logger.h"
 #include <chrono>
 #include <librdkafka/rdkafkacpp.h>
@@ -26,6 +27,9 @@ struct MessageMetaData {
           MSG_TIMESTAMP_NOT_AVAILABLE};
   int64_t Offset{0};
   int32_t Partition{0};
+  /// Time at which the message was returned by the consumer, only set by
+  /// consumers that measure the latency of the pipeline.
+  std::chrono::system_clock::time_point PollTime{};
 };
 
 struct Msg {
@@ -34,19 +38,25 @@ struct Msg {
       : DataPtr(std::move(Other.DataPtr)), Size(Other.Size),
         MetaData(Other.MetaData) {}
   Msg(char const *Data, size_t Bytes, MessageMetaData MessageInfo = {})
-      : DataPtr(std::make_unique<char[]>(Bytes)), Size(Bytes),
+      : DataPtr(BufferPool::getInstance().allocate(Bytes)), Size(Bytes),
         MetaData(MessageInfo) {
-    std::memcpy(reinterpret_cast<void *>(DataPtr.get()), Data, Bytes);
+    std::memcpy(DataPtr.get(), Data, Bytes);
   }
   Msg(uint8_t const *Data, size_t Bytes, MessageMetaData MessageInfo = {})
-      : DataPtr(std::make_unique<char[]>(Bytes)), Size(Bytes),
+      : DataPtr(BufferPool::getInstance().allocate(Bytes)), Size(Bytes),
         MetaData(MessageInfo) {
-    std::memcpy(reinterpret_cast<void *>(DataPtr.get()), Data, Bytes);
+    std::memcpy(DataPtr.get(), Data, Bytes);
+  }
+  Msg &operator=(Msg &&Other) noexcept {
+    DataPtr = std::move(Other.DataPtr);
+    Size = Other.Size;
+    MetaData = Other.MetaData;
+    return *this;
   }
   Msg &operator=(Msg const &Other) {
     Size = Other.Size;
     MetaData = Other.MetaData;
-    DataPtr = std::make_unique<char[]>(Size);
+    DataPtr = BufferPool::getInstance().allocate(Size);
     std::memcpy(DataPtr.get(), Other.DataPtr.get(), Size);
     return *this;
   }
@@ -55,7 +65,7 @@ struct Msg {
     if (DataPtr == nullptr) {
       getLogger()->error("error at type: {}", -1);
     }
-    return reinterpret_cast<uint8_t const *>(DataPtr.get());
+    return DataPtr.get();
   }
 
   size_t size() const {
@@ -68,7 +78,7 @@ struct Msg {
   MessageMetaData const &getMetaData() const { return MetaData; }
 
 protected:
-  std::unique_ptr<char[]> DataPtr{nullptr};
+  PooledBuffer DataPtr{nullptr};
   size_t Size{0};
   MessageMetaData MetaData;
 };
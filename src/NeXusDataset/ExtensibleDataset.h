@@ -299,7 +299,8 @@ public:
     ++CurrentExtent[0];
     Shape.insert(Shape.begin(), 1);
     if (Shape.size() != CurrentExtent.size()) {
-      Logger->error(
+      LOG_RATE_LIMITED(
+          Logger, spdlog::level::err,
           "Data has {} dimension(s) and dataset has {} (+1) dimensions.",
           Shape.size() - 1, CurrentExtent.size() - 1);
       throw std::runtime_error(
@@ -307,14 +308,16 @@ public:
     }
     for (size_t i = 1; i < Shape.size(); i++) {
       if (Shape[i] > CurrentExtent[i]) {
-        Logger->warn("Dimension {} of new data is larger than that of the "
-                     "dataset. Extending dataset.",
-                     i - 1);
+        LOG_RATE_LIMITED(Logger, spdlog::level::warn,
+                         "Dimension {} of new data is larger than that of the "
+                         "dataset. Extending dataset.",
+                         i - 1);
         CurrentExtent[i] = Shape[i];
       } else if (Shape[i] < CurrentExtent[i]) {
-        Logger->warn("Dimension {} of new data is smaller than that of "
-                     "the dataset. Using 0 as a filler.",
-                     i - 1);
+        LOG_RATE_LIMITED(Logger, spdlog::level::warn,
+                         "Dimension {} of new data is smaller than that of "
+                         "the dataset. Using 0 as a filler.",
+                         i - 1);
       }
     }
     Dataset::extent(CurrentExtent);
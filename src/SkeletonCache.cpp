@@ -0,0 +1,396 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "SkeletonCache.h"
+#include "Filesystem.h"
+#include "HDFOperations.h"
+#include "Version.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
+namespace FileWriter {
+
+using nlohmann::json;
+
+namespace {
+void hashCombine(std::size_t &Seed, std::size_t Value) {
+  Seed ^= Value + 0x9e3779b97f4a7c15ULL + (Seed << 6) + (Seed >> 2);
+}
+
+/// \brief Add the size and modification time of the template files of the
+/// "copy" nodes to the hash.
+///
+/// The hash of the NeXus structure only covers the names of the template
+/// files, a template file that has changed must give a different key.
+void hashCopySources(std::size_t &Hash, json const &Node) {
+  if (Node.is_array()) {
+    for (auto const &Element : Node) {
+      hashCopySources(Hash, Element);
+    }
+    return;
+  }
+  if (not Node.is_object()) {
+    return;
+  }
+  std::string Type;
+  if (HDFOperations::findType(Node, Type) and Type == "copy") {
+    if (auto SourceFile = find<std::string>("source_file", Node)) {
+      // A missing file fails when creating the skeleton file.
+      std::error_code Error;
+      auto const Size = fs::file_size(*SourceFile, Error);
+      hashCombine(Hash, std::hash<std::uintmax_t>{}(Error ? 0 : Size));
+      auto const ModificationTime = fs::last_write_time(*SourceFile, Error);
+      hashCombine(Hash,
+                  std::hash<std::int64_t>{}(
+                      Error ? 0 : ModificationTime.time_since_epoch().count()));
+    }
+  }
+  if (auto Children = Node.find("children"); Children != Node.end()) {
+    hashCopySources(Hash, *Children);
+  }
+}
+
+/// \brief Try to clone a file using the FICLONE ioctl.
+///
+/// \return True if the file was cloned, false if cloning is not supported.
+bool reflinkFile(std::string const &Source, std::string const &Destination) {
+#ifdef FICLONE
+  auto SourceDescriptor = open(Source.c_str(), O_RDONLY);
+  if (SourceDescriptor == -1) {
+    return false;
+  }
+  auto DestinationDescriptor =
+      open(Destination.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+  if (DestinationDescriptor == -1) {
+    auto Error = errno;
+    close(SourceDescriptor);
+    throw std::runtime_error(fmt::format("Unable to create the file \"{}\": {}",
+                                         Destination, std::strerror(Error)));
+  }
+  auto Result = ioctl(DestinationDescriptor, FICLONE, SourceDescriptor);
+  close(DestinationDescriptor);
+  close(SourceDescriptor);
+  if (Result == -1) {
+    fs::remove(Destination);
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+} // namespace
+
+void cloneFile(std::string const &Source, std::string const &Destination) {
+  if (reflinkFile(Source, Destination)) {
+    return;
+  }
+  // Fails if the destination exists.
+  fs::copy_file(Source, Destination);
+}
+
+SkeletonCache::SkeletonCache(std::string Directory,
+                             std::vector<std::string> const &VolatileAttributes,
+                             std::vector<std::string> const &VolatileDatasets,
+                             std::uintmax_t MaxSize)
+    : Directory(std::move(Directory)),
+      VolatileAttributes(VolatileAttributes.begin(), VolatileAttributes.end()),
+      VolatileDatasets(VolatileDatasets.begin(), VolatileDatasets.end()),
+      MaxSize(MaxSize) {}
+
+bool SkeletonCache::isVolatile(std::string const &AttributeName) const {
+  return VolatileAttributes.find(AttributeName) != VolatileAttributes.end();
+}
+
+bool SkeletonCache::isVolatileDataset(json const &Node,
+                                      std::string const &Path) const {
+  std::string Type;
+  if (not HDFOperations::findType(Node, Type) or Type != "dataset") {
+    return false;
+  }
+  auto Name = find<std::string>("name", Node);
+  return Name and VolatileDatasets.find(Path + "/" + *Name) !=
+                      VolatileDatasets.end();
+}
+
+std::size_t SkeletonCache::hashNode(json const &Node) const {
+  auto Hash = static_cast<std::size_t>(Node.type());
+  switch (Node.type()) {
+  case json::value_t::object:
+    for (auto It = Node.cbegin(); It != Node.cend(); ++It) {
+      hashCombine(Hash, std::hash<std::string>{}(It.key()));
+      hashCombine(Hash, hashNode(It.value()));
+    }
+    break;
+  case json::value_t::array:
+    for (auto const &Element : Node) {
+      hashCombine(Hash, hashNode(Element));
+    }
+    break;
+  case json::value_t::string:
+    hashCombine(Hash, std::hash<std::string>{}(
+                          Node.get_ref<json::string_t const &>()));
+    break;
+  case json::value_t::boolean:
+    hashCombine(Hash, std::hash<bool>{}(Node.get<bool>()));
+    break;
+  case json::value_t::number_integer:
+    hashCombine(Hash, std::hash<json::number_integer_t>{}(
+                          Node.get<json::number_integer_t>()));
+    break;
+  case json::value_t::number_unsigned:
+    hashCombine(Hash, std::hash<json::number_unsigned_t>{}(
+                          Node.get<json::number_unsigned_t>()));
+    break;
+  case json::value_t::number_float:
+    hashCombine(Hash, std::hash<json::number_float_t>{}(
+                          Node.get<json::number_float_t>()));
+    break;
+  default:
+    break;
+  }
+  return Hash;
+}
+
+json SkeletonCache::stripAttributes(json const &Attributes) const {
+  if (Attributes.is_object()) {
+    json Result = json::object();
+    for (auto It = Attributes.cbegin(); It != Attributes.cend(); ++It) {
+      if (not isVolatile(It.key())) {
+        Result[It.key()] = It.value();
+      }
+    }
+    return Result;
+  }
+  if (Attributes.is_array()) {
+    json Result = json::array();
+    for (auto const &Attribute : Attributes) {
+      if (auto Name = find<std::string>("name", Attribute);
+          not Name or not isVolatile(*Name)) {
+        Result.push_back(Attribute);
+      }
+    }
+    return Result;
+  }
+  return Attributes;
+}
+
+json SkeletonCache::stripNode(json const &Node, std::string const &Path) const {
+  if (not Node.is_object()) {
+    return Node;
+  }
+  json Result = json::object();
+  for (auto It = Node.cbegin(); It != Node.cend(); ++It) {
+    if (It.key() == "attributes") {
+      Result[It.key()] = stripAttributes(It.value());
+    } else if (It.key() == "children" and It.value().is_array()) {
+      auto &Children = Result[It.key()] = json::array();
+      for (auto const &Child : It.value()) {
+        if (isVolatileDataset(Child, Path)) {
+          continue;
+        }
+        std::string Type;
+        auto Name = find<std::string>("name", Child);
+        if (HDFOperations::findType(Child, Type) and Type == "group" and
+            Name) {
+          Children.push_back(stripNode(Child, Path + "/" + *Name));
+        } else {
+          Children.push_back(stripNode(Child, Path));
+        }
+      }
+    } else {
+      Result[It.key()] = It.value();
+    }
+  }
+  return Result;
+}
+
+json SkeletonCache::getSkeletonStructure(json const &NexusStructure) const {
+  return stripNode(NexusStructure, "");
+}
+
+std::string
+SkeletonCache::getKey(json const &NexusStructure,
+                      FileAccessProfile const &AccessProfile) const {
+  auto const SkeletonStructure = getSkeletonStructure(NexusStructure);
+  auto Hash = hashNode(SkeletonStructure);
+  hashCopySources(Hash, SkeletonStructure);
+  hashCombine(Hash, std::hash<std::string>{}(GetVersion()));
+  // Only the settings that change the layout of the file.
+  hashCombine(Hash, std::hash<hsize_t>{}(AccessProfile.AlignmentThreshold));
+  hashCombine(Hash, std::hash<hsize_t>{}(AccessProfile.Alignment));
+  hashCombine(Hash, std::hash<hsize_t>{}(AccessProfile.MetaBlockSize));
+  hashCombine(Hash,
+              std::hash<std::string>{}(AccessProfile.LibraryVersionLowBound));
+  return fmt::format("{:016x}", Hash);
+}
+
+std::string SkeletonCache::getSkeletonPath(std::string const &Key) const {
+  return (fs::path(Directory) / (Key + ".nxs")).string();
+}
+
+bool SkeletonCache::hasSkeleton(std::string const &Key) const {
+  return fs::exists(getSkeletonPath(Key));
+}
+
+json SkeletonCache::getVolatileAttributes(
+    json const &NexusStructureNode) const {
+  auto AttributesIter = NexusStructureNode.find("attributes");
+  if (AttributesIter == NexusStructureNode.end()) {
+    return {};
+  }
+  auto const &Attributes = *AttributesIter;
+  json Result;
+  if (Attributes.is_object()) {
+    for (auto It = Attributes.cbegin(); It != Attributes.cend(); ++It) {
+      if (isVolatile(It.key())) {
+        Result[It.key()] = It.value();
+      }
+    }
+  } else if (Attributes.is_array()) {
+    for (auto const &Attribute : Attributes) {
+      if (auto Name = find<std::string>("name", Attribute);
+          Name and isVolatile(*Name)) {
+        Result.push_back(Attribute);
+      }
+    }
+  }
+  return Result;
+}
+
+void SkeletonCache::writeVolatileNodes(hdf5::node::Group const &Group,
+                                       json const &NexusStructureNode,
+                                       std::string const &Path) const {
+  if (auto Attributes = getVolatileAttributes(NexusStructureNode);
+      not Attributes.empty()) {
+    HDFOperations::writeAttributes(Group, &Attributes, Logger);
+  }
+  auto Children = NexusStructureNode.find("children");
+  if (Children == NexusStructureNode.end() or not Children->is_array()) {
+    return;
+  }
+  for (auto const &Child : *Children) {
+    std::string Type;
+    if (not HDFOperations::findType(Child, Type)) {
+      continue;
+    }
+    if (Type == "stream") {
+      // The attributes of a stream are written to its parent group.
+      if (auto Attributes = getVolatileAttributes(Child);
+          not Attributes.empty()) {
+        HDFOperations::writeAttributes(Group, &Attributes, Logger);
+      }
+      continue;
+    }
+    auto Name = find<std::string>("name", Child);
+    if (not Name) {
+      continue;
+    }
+    if (Type == "group" and Group.has_group(*Name)) {
+      writeVolatileNodes(hdf5::node::get_group(Group, *Name), Child,
+                         Path + "/" + *Name);
+    } else if (isVolatileDataset(Child, Path)) {
+      HDFOperations::writeDataset(Group, &Child, Logger);
+    } else if (Type == "dataset" and Group.has_dataset(*Name)) {
+      if (auto Attributes = getVolatileAttributes(Child);
+          not Attributes.empty()) {
+        HDFOperations::writeAttributes(hdf5::node::get_dataset(Group, *Name),
+                                       &Attributes, Logger);
+      }
+    }
+  }
+}
+
+void SkeletonCache::createFileFromSkeleton(
+    std::string const &Key, std::string const &FileName,
+    json const &NexusStructure) const {
+  auto const SkeletonPath = getSkeletonPath(Key);
+  cloneFile(SkeletonPath, FileName);
+  // The modification time of a skeleton file is the time it was last used.
+  std::error_code IgnoredError;
+  fs::last_write_time(SkeletonPath, fs::file_time_type::clock::now(),
+                      IgnoredError);
+  try {
+    auto File =
+        hdf5::file::open(FileName, hdf5::file::AccessFlags::READWRITE, {});
+    auto RootGroup = File.root();
+    for (auto const &Name : {"file_name", "file_time"}) {
+      if (RootGroup.attributes.exists(Name)) {
+        RootGroup.attributes.remove(Name);
+      }
+    }
+    HDFOperations::writeStringAttribute(RootGroup, "file_name",
+                                        File.id().file_name().string());
+    HDFOperations::writeHDFISO8601AttributeCurrentTime(RootGroup, "file_time",
+                                                       Logger);
+    writeVolatileNodes(RootGroup, NexusStructure, "");
+  } catch (std::exception const &) {
+    fs::remove(FileName);
+    std::throw_with_nested(std::runtime_error(fmt::format(
+        "Unable to write the volatile attributes of the file \"{}\" created "
+        "from the skeleton file \"{}\".",
+        FileName, SkeletonPath)));
+  }
+}
+
+void SkeletonCache::removeLeastRecentlyUsed(std::string const &KeepKey) const {
+  if (MaxSize == 0) {
+    return;
+  }
+  struct SkeletonFile {
+    fs::path Path;
+    fs::file_time_type LastUsed;
+    std::uintmax_t Size;
+  };
+  std::vector<SkeletonFile> Files;
+  std::uintmax_t TotalSize{0};
+  for (auto const &Entry : fs::directory_iterator(Directory)) {
+    if (not fs::is_regular_file(Entry.path()) or
+        Entry.path().extension() != ".nxs") {
+      continue;
+    }
+    std::error_code Error;
+    auto Size = fs::file_size(Entry.path(), Error);
+    auto LastUsed = fs::last_write_time(Entry.path(), Error);
+    if (Error) {
+      continue;
+    }
+    TotalSize += Size;
+    Files.push_back({Entry.path(), LastUsed, Size});
+  }
+  std::sort(Files.begin(), Files.end(), [](auto const &A, auto const &B) {
+    return A.LastUsed < B.LastUsed;
+  });
+  auto const KeepPath = fs::path(getSkeletonPath(KeepKey));
+  for (auto const &File : Files) {
+    if (TotalSize <= MaxSize) {
+      break;
+    }
+    if (File.Path == KeepPath) {
+      continue;
+    }
+    std::error_code Error;
+    if (fs::remove(File.Path, Error)) {
+      TotalSize -= File.Size;
+      Logger->info("Removed the least recently used skeleton file {}",
+                   File.Path.string());
+    }
+  }
+}
+
+} // namespace FileWriter
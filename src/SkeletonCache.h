@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#pragma once
+
+#include "FileAccessProfile.h"
+#include "json.h"
+#include "logger.h"
+#include <cstdint>
+#include <h5cpp/hdf5.hpp>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace FileWriter {
+
+/// \brief Cache of "skeleton" files, i.e. files that have the HDF structure
+/// of a NeXus structure (including the datasets created by the writer
+/// modules) but no streamed data.
+///
+/// Volatile attributes and datasets are expected to change from run to run
+/// (e.g. the attribute "title" or the dataset "/entry/start_time") without
+/// changing the structure of the file. They are left out of skeleton files
+/// and the skeletons are keyed by a hash of the NeXus structure without
+/// them. A new file is created by cloning the skeleton and then writing the
+/// volatile attributes and datasets.
+///
+/// The least recently used skeleton files are removed when the total size of
+/// the skeleton files exceeds a limit.
+class SkeletonCache {
+public:
+  /// \param Directory The directory to store the skeleton files in.
+  /// \param VolatileAttributes Names of the volatile attributes.
+  /// \param VolatileDatasets Paths (e.g. "/entry/title") of the volatile
+  /// datasets.
+  /// \param MaxSize The maximum total size (in bytes) of the skeleton files.
+  /// 0 means no limit.
+  SkeletonCache(std::string Directory,
+                std::vector<std::string> const &VolatileAttributes,
+                std::vector<std::string> const &VolatileDatasets = {},
+                std::uintmax_t MaxSize = 0);
+
+  /// \brief Get the cache key of a NeXus structure.
+  ///
+  /// The key depends on the version of the application as the HDF structure
+  /// created from a NeXus structure might change between versions, on the
+  /// file access settings that change the layout of a file and on the size
+  /// and modification time of the template files of "copy" nodes.
+  std::string getKey(nlohmann::json const &NexusStructure,
+                     FileAccessProfile const &AccessProfile = {}) const;
+
+  /// \brief Get the NeXus structure to create a skeleton file from, i.e. the
+  /// structure without the volatile attributes and datasets.
+  nlohmann::json
+  getSkeletonStructure(nlohmann::json const &NexusStructure) const;
+
+  /// \brief Get the path of the skeleton file for a cache key.
+  std::string getSkeletonPath(std::string const &Key) const;
+
+  bool hasSkeleton(std::string const &Key) const;
+
+  /// \brief Create a new file from a skeleton file.
+  ///
+  /// Throws if the file can not be created, in which case no file is left
+  /// behind.
+  ///
+  /// \param Key The cache key of the NeXus structure.
+  /// \param FileName The name of the file to create.
+  /// \param NexusStructure The NeXus structure to get the volatile attributes
+  /// and datasets from.
+  void createFileFromSkeleton(std::string const &Key,
+                              std::string const &FileName,
+                              nlohmann::json const &NexusStructure) const;
+
+  /// \brief Remove the least recently used skeleton files until the total
+  /// size of the skeleton files is within the limit.
+  ///
+  /// \param KeepKey The key of a skeleton file that is never removed, e.g.
+  /// the one that was just created.
+  void removeLeastRecentlyUsed(std::string const &KeepKey) const;
+
+private:
+  std::size_t hashNode(nlohmann::json const &Node) const;
+  nlohmann::json stripAttributes(nlohmann::json const &Attributes) const;
+  nlohmann::json stripNode(nlohmann::json const &Node,
+                           std::string const &Path) const;
+  nlohmann::json
+  getVolatileAttributes(nlohmann::json const &NexusStructureNode) const;
+  void writeVolatileNodes(hdf5::node::Group const &Group,
+                          nlohmann::json const &NexusStructureNode,
+                          std::string const &Path) const;
+  bool isVolatile(std::string const &AttributeName) const;
+  bool isVolatileDataset(nlohmann::json const &Node,
+                         std::string const &Path) const;
+
+  std::string Directory;
+  std::set<std::string> VolatileAttributes;
+  std::set<std::string> VolatileDatasets;
+  std::uintmax_t MaxSize;
+  SharedLogger Logger = getLogger();
+};
+
+/// \brief Copy a file, as a copy-on-write clone (reflink) if the file system
+/// supports it.
+///
+/// Throws if the destination file exists or if the file can not be copied.
+void cloneFile(std::string const &Source, std::string const &Destination);
+
+} // namespace FileWriter
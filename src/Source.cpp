@@ -12,9 +12,11 @@
 namespace FileWriter {
 
 Source::Source(std::string Name, std::string FlatbufferID, std::string ModuleID,
-               std::string Topic, WriterModule::ptr Writer)
+               std::string Topic, WriterModule::ptr Writer,
+               std::string HDFParentName)
     : SourceName(std::move(Name)), SchemaID(std::move(FlatbufferID)),
       WriterModuleID(std::move(ModuleID)), TopicName(std::move(Topic)),
+      HDFParentName(std::move(HDFParentName)),
       SrcHash(calcSourceHash(SchemaID, SourceName)),
       ModuleHash(calcSourceHash(ModuleID, SourceName)),
       WriterModule(std::move(Writer)) {}
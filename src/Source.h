@@ -20,8 +20,10 @@ namespace FileWriter {
 /// \brief Represents a sourcename on a topic.
 class Source {
 public:
+  /// \param HDFParentName The path of the HDF group of the stream.
   Source(std::string Name, std::string FlatbufferID, std::string ModuleID,
-         std::string Topic, WriterModule::ptr Writer);
+         std::string Topic, WriterModule::ptr Writer,
+         std::string HDFParentName = "");
   Source(Source &&) = default;
   ~Source() = default;
   std::string const &topic() const;
@@ -31,12 +33,14 @@ public:
   FlatbufferMessage::SrcHash getSrcHash() const { return SrcHash; };
   FlatbufferMessage::SrcHash getModuleHash() const { return ModuleHash; };
   WriterModule::Base *getWriterPtr() { return WriterModule.get(); }
+  std::string const &hdfParentName() const { return HDFParentName; }
 
 private:
   std::string SourceName;
   std::string SchemaID;
   std::string WriterModuleID;
   std::string TopicName;
+  std::string HDFParentName;
   FlatbufferMessage::SrcHash SrcHash;
   FlatbufferMessage::SrcHash ModuleHash;
   std::unique_ptr<WriterModule::Base> WriterModule;
@@ -11,6 +11,8 @@
 
 #include "TimeUtility.h"
 #include <chrono>
+#include <cstdint>
+#include <map>
 #include <string>
 
 namespace Status {
@@ -23,6 +25,32 @@ struct JobStatusInfo {
   time_point StopTime{0ms};
 };
 
+/// Live performance figures of the current job. The counts are totals since
+/// the start of the job, taken from the metrics counters.
+struct JobPerformanceInfo {
+  std::int64_t MessagesWritten{0};
+  std::int64_t BytesWritten{0};
+  std::int64_t QueueDepth{0};
+  std::int64_t WriteErrors{0};
+  /// Write errors per "<source name>_<flatbuffer id>".
+  std::map<std::string, std::int64_t> WriteErrorsPerStream;
+  /// For a file kept in memory, the size of the file in memory.
+  std::uintmax_t BytesOnDisk{0};
+  std::chrono::milliseconds ConsumerLag{0};
+};
+
+/// Progress of moving a finished file from the scratch directory to its final
+/// location (see FileWriter::FileMover).
+struct FileMoveInfo {
+  std::string Source;
+  std::string Destination;
+  /// "queued", "moving", "done" or "failed".
+  std::string State;
+  std::uintmax_t BytesMoved{0};
+  std::uintmax_t Size{0};
+  std::string Error;
+};
+
 // This info is constant for this instance of the software
 struct ApplicationStatusInfo {
   // Time interval between publishing status messages
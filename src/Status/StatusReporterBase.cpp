@@ -28,8 +28,23 @@ void StatusReporterBase::updateStopTime(std::chrono::milliseconds StopTime) {
   Status.StopTime = time_point(StopTime);
 }
 
+void StatusReporterBase::updatePerformanceInfo(
+    JobPerformanceInfo const &NewInfo) {
+  const std::lock_guard<std::mutex> lock(StatusMutex);
+  Performance = NewInfo;
+}
+
+void StatusReporterBase::updateFileMoves(
+    std::vector<FileMoveInfo> const &NewMoves) {
+  const std::lock_guard<std::mutex> lock(StatusMutex);
+  FileMoves = NewMoves;
+}
+
 void StatusReporterBase::resetStatusInfo() {
   updateStatusInfo({"", "", std::chrono::milliseconds(0)});
+  const std::lock_guard<std::mutex> lock(StatusMutex);
+  Performance = JobPerformanceInfo();
+  LastReportedPerformance = JobPerformanceInfo();
 }
 
 flatbuffers::DetachedBuffer
@@ -56,7 +71,7 @@ StatusReporterBase::createReport(std::string const &JSONReport) const {
 }
 
 // Create the JSON part of the status message
-std::string StatusReporterBase::createJSONReport() const {
+std::string StatusReporterBase::createJSONReport() {
   auto Info = nlohmann::json::object();
   std::lock_guard<std::mutex> const lock(StatusMutex);
 
@@ -65,6 +80,44 @@ std::string StatusReporterBase::createJSONReport() const {
   Info["start_time"] = Status.StartTime.count();
   Info["stop_time"] = toMilliSeconds(Status.StopTime);
 
+  auto const Now = std::chrono::steady_clock::now();
+  auto const Seconds =
+      std::chrono::duration<double>(Now - LastReportTime).count();
+  auto PerSecond = [Seconds](std::int64_t Current, std::int64_t Last) {
+    if (Seconds <= 0.0 or Current < Last) {
+      return 0.0;
+    }
+    return (Current - Last) / Seconds;
+  };
+  auto const &Last = LastReportedPerformance;
+  Info["performance"] = {
+      {"messages_per_second",
+       PerSecond(Performance.MessagesWritten, Last.MessagesWritten)},
+      {"bytes_per_second",
+       PerSecond(Performance.BytesWritten, Last.BytesWritten)},
+      {"queue_depth", Performance.QueueDepth},
+      {"write_errors", Performance.WriteErrors},
+      {"write_errors_per_stream", Performance.WriteErrorsPerStream},
+      {"bytes_on_disk", Performance.BytesOnDisk},
+      {"seconds_behind",
+       std::chrono::duration<double>(Performance.ConsumerLag).count()}};
+  LastReportedPerformance = Performance;
+  LastReportTime = Now;
+
+  auto Moves = nlohmann::json::array();
+  for (auto const &Move : FileMoves) {
+    auto MoveInfo = nlohmann::json{{"source", Move.Source},
+                                   {"destination", Move.Destination},
+                                   {"state", Move.State},
+                                   {"bytes_moved", Move.BytesMoved},
+                                   {"size", Move.Size}};
+    if (not Move.Error.empty()) {
+      MoveInfo["error"] = Move.Error;
+    }
+    Moves.push_back(std::move(MoveInfo));
+  }
+  Info["file_moves"] = std::move(Moves);
+
   return Info.dump();
 }
 
@@ -15,6 +15,7 @@
 #include <asio.hpp>
 #include <chrono>
 #include <mutex>
+#include <vector>
 
 namespace flatbuffers {
 class DetachedBuffer;
@@ -42,6 +43,18 @@ public:
   /// \param StopTime The new stop time.
   void updateStopTime(std::chrono::milliseconds StopTime);
 
+  /// \brief Update the performance figures of the current job.
+  ///
+  /// \param NewInfo The latest performance figures.
+  void updatePerformanceInfo(JobPerformanceInfo const &NewInfo);
+
+  /// \brief Update the progress of the moves of finished files to their
+  /// final location.
+  ///
+  /// Not cleared by resetStatusInfo() as files are moved after the job has
+  /// finished.
+  void updateFileMoves(std::vector<FileMoveInfo> const &NewMoves);
+
   /// \brief Clear out the current information.
   ///
   /// Used when a file has finished writing.
@@ -52,8 +65,10 @@ public:
   /// \return The report message buffer.
   flatbuffers::DetachedBuffer createReport(std::string const &JSONReport) const;
 
-  /// Create the JSON part of the status report.
-  std::string createJSONReport() const;
+  /// \brief Create the JSON part of the status report.
+  ///
+  /// Rates are calculated over the time since the previous call.
+  std::string createJSONReport();
 
 protected:
   std::chrono::milliseconds const Period;
@@ -63,6 +78,11 @@ protected:
 private:
   virtual void postReportStatusActions(){};
   JobStatusInfo Status{};
+  JobPerformanceInfo Performance{};
+  JobPerformanceInfo LastReportedPerformance{};
+  std::vector<FileMoveInfo> FileMoves;
+  std::chrono::steady_clock::time_point LastReportTime{
+      std::chrono::steady_clock::now()};
   mutable std::mutex StatusMutex;
   std::unique_ptr<Kafka::ProducerTopic> StatusProducerTopic;
   ApplicationStatusInfo const StaticStatusInformation;
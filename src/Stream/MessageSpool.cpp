@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "MessageSpool.h"
+#include "Filesystem.h"
+#include "logger.h"
+#include <algorithm>
+
+namespace Stream {
+
+MessageSpool::MessageSpool(std::string SpoolDirectory, size_t MaxSegmentSize)
+    : Directory(std::move(SpoolDirectory)), SegmentSize(MaxSegmentSize) {
+  fs::create_directories(Directory);
+}
+
+MessageSpool::~MessageSpool() {
+  Segments.clear();
+  std::error_code Error;
+  fs::remove(Directory, Error);
+}
+
+std::unique_ptr<SpoolSegment>
+MessageSpool::createSegment(size_t MinimumCapacity) {
+  auto FilePath = (fs::path(Directory) /
+                   fmt::format("segment_{:08d}.spool", SegmentCounter++))
+                      .string();
+  return std::make_unique<SpoolSegment>(
+      FilePath, std::max(SegmentSize, MinimumCapacity));
+}
+
+bool MessageSpool::append(Message const &Msg) {
+  SpoolRecordHeader Header;
+  Header.Size = Msg.FbMsg.size();
+  Header.SourceHash = Msg.FbMsg.getSourceHash();
+  Header.Destination = reinterpret_cast<std::uint64_t>(Msg.DestPtr);
+  Header.MessageTimestamp = Msg.FbMsg.getTimestamp();
+  Header.KafkaTimestamp = Msg.FbMsg.getKafkaTimestamp().count();
+  Header.AppendTime = toNanoSeconds(system_clock::now());
+  std::lock_guard<std::mutex> Lock(AppendMutex);
+  if (CurrentSegment != nullptr and
+      CurrentSegment->append(Header, Msg.FbMsg.data())) {
+    return true;
+  }
+  std::unique_ptr<SpoolSegment> NewSegment;
+  try {
+    NewSegment = createSegment(SpoolSegment::recordSize(Header.Size));
+  } catch (std::exception &E) {
+    LOG_ERROR("Failed to create new message spool segment: {}", E.what());
+    return false;
+  }
+  NewSegment->append(Header, Msg.FbMsg.data());
+  if (CurrentSegment != nullptr) {
+    CurrentSegment->seal();
+  }
+  CurrentSegment = NewSegment.get();
+  std::lock_guard<std::mutex> SegmentsLock(SegmentsMutex);
+  Segments.emplace_back(std::move(NewSegment));
+  return true;
+}
+
+bool MessageSpool::readNext(MessageHandler const &Handler) {
+  SpoolSegment *FrontSegment{nullptr};
+  {
+    std::lock_guard<std::mutex> Lock(SegmentsMutex);
+    if (Segments.empty()) {
+      return false;
+    }
+    FrontSegment = Segments.front().get();
+  }
+  SpoolRecordHeader Header;
+  std::uint8_t const *Data{nullptr};
+  if (FrontSegment->readRecord(ReadPosition, Header, Data)) {
+    try {
+      Handler(reinterpret_cast<WriterModule::Base *>(Header.Destination),
+              FileWriter::FlatbufferMessage(
+                  Data, Header.Size, FileWriter::VerificationLevel::NONE,
+                  std::chrono::milliseconds(Header.KafkaTimestamp)),
+              time_point(std::chrono::duration_cast<duration>(
+                  std::chrono::nanoseconds(Header.AppendTime))));
+    } catch (std::exception &E) {
+      LOG_ERROR("Unable to read back spooled message: {}", E.what());
+    }
+    return true;
+  }
+  if (FrontSegment->isSealed() and
+      ReadPosition == FrontSegment->committedBytes()) {
+    {
+      std::lock_guard<std::mutex> Lock(SegmentsMutex);
+      Segments.pop_front();
+    }
+    ReadPosition = 0;
+    return readNext(Handler);
+  }
+  return false;
+}
+
+size_t MessageSpool::nrOfSegments() {
+  std::lock_guard<std::mutex> Lock(SegmentsMutex);
+  return Segments.size();
+}
+
+} // namespace Stream
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+/// \file
+/// \brief Spooling of messages to local disk before they are written to file.
+///
+
+#pragma once
+
+#include "Message.h"
+#include "SpoolSegment.h"
+#include "TimeUtility.h"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace Stream {
+
+struct SpoolSettings {
+  /// Directory to spool messages to. Spooling is disabled if empty.
+  std::string Directory;
+  size_t SegmentSize{256 * 1024 * 1024};
+};
+
+/// \brief Stores messages in memory mapped segment files on local disk until
+/// they are read back by the writer thread.
+///
+/// Decouples the consumption of data from Kafka from the speed of the (HDF5)
+/// storage. Messages can be appended by multiple threads but should only be
+/// read by one thread. Messages are read back in the order they were
+/// appended. Segment files are removed once they have been read.
+class MessageSpool {
+public:
+  /// \throw std::runtime_error If the spool directory can not be created.
+  MessageSpool(std::string SpoolDirectory, size_t MaxSegmentSize);
+  ~MessageSpool();
+
+  /// \brief Append a message to the spool.
+  ///
+  /// Thread safe.
+  /// \return false if the message could not be spooled.
+  bool append(Message const &Msg);
+
+  /// The last argument is the time at which the message was appended.
+  using MessageHandler =
+      std::function<void(WriterModule::Base *,
+                         FileWriter::FlatbufferMessage const &, time_point)>;
+
+  /// \brief Read the next message (if there is one) and pass it to the
+  /// handler.
+  ///
+  /// \return true if a message was read.
+  bool readNext(MessageHandler const &Handler);
+
+  size_t nrOfSegments();
+
+private:
+  std::unique_ptr<SpoolSegment> createSegment(size_t MinimumCapacity);
+  std::string Directory;
+  size_t SegmentSize;
+  std::mutex AppendMutex;
+  SpoolSegment *CurrentSegment{nullptr};
+  size_t SegmentCounter{0};
+  std::mutex SegmentsMutex;
+  std::deque<std::unique_ptr<SpoolSegment>> Segments;
+  size_t ReadPosition{0};
+};
+
+} // namespace Stream
@@ -11,7 +11,9 @@
 ///
 
 #include "MessageWriter.h"
+#include "Tracing.h"
 #include "WriterModuleBase.h"
+#include <limits>
 
 namespace Stream {
 
@@ -25,16 +27,46 @@ ModuleHash generateSrcHash(std::string const &Source,
 static const ModuleHash UnknownModuleHash{
     generateSrcHash("Unknown source", "Unknown fb-id")};
 
+static std::int64_t inMicroSeconds(duration Time) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(Time).count();
+}
+
+std::unique_ptr<MessageSpool> createSpool(SpoolSettings const &Settings) {
+  if (Settings.Directory.empty()) {
+    return nullptr;
+  }
+  try {
+    return std::make_unique<MessageSpool>(Settings.Directory,
+                                          Settings.SegmentSize);
+  } catch (std::exception &E) {
+    LOG_ERROR("Unable to set up message spool in \"{}\". Messages will be "
+              "queued in memory instead. The error was: {}",
+              Settings.Directory, E.what());
+  }
+  return nullptr;
+}
+
 MessageWriter::MessageWriter(std::function<void()> FlushFunction,
                              duration FlushIntervalTime,
-                             Metrics::Registrar const &MetricReg)
+                             Metrics::Registrar const &MetricReg,
+                             SpoolSettings const &Spooling,
+                             std::function<std::size_t()> MemoryCheck)
     : FlushDataFunction(FlushFunction),
+      MemoryCheckFunction(std::move(MemoryCheck)),
       Registrar(MetricReg.getNewRegistrar("writer")),
+      Spool(createSpool(Spooling)),
       WriterThread(&MessageWriter::threadFunction, this),
       FlushInterval(FlushIntervalTime) {
   Registrar.registerMetric(WritesDone, {Metrics::LogTo::CARBON});
+  Registrar.registerMetric(BytesWritten, {Metrics::LogTo::CARBON});
+  Registrar.registerMetric(QueueDepth, {Metrics::LogTo::CARBON});
   Registrar.registerMetric(WriteErrors,
                            {Metrics::LogTo::CARBON, Metrics::LogTo::LOG_MSG});
+  Registrar.registerMetric(SpooledMessages, {Metrics::LogTo::CARBON});
+  Registrar.registerMetric(QueueLatency, {Metrics::LogTo::CARBON});
+  Registrar.registerMetric(WriteTime, {Metrics::LogTo::CARBON});
+  Registrar.registerMetric(Latency,
+                           {Metrics::LogTo::CARBON, Metrics::LogTo::LOG_MSG});
   ModuleErrorCounters[UnknownModuleHash] = std::make_unique<Metrics::Metric>(
       "error_unknown", "Unknown flatbuffer message.", Metrics::Severity::ERROR);
   Registrar.registerMetric(*ModuleErrorCounters[UnknownModuleHash],
@@ -49,37 +81,146 @@ MessageWriter::~MessageWriter() {
 }
 
 void MessageWriter::addMessage(Message const &Msg) {
-  WriteJobs.enqueue([=]() { writeMsgImpl(Msg.DestPtr, Msg.FbMsg); });
+  TRACE_SPAN("queue_message");
+  // Once spooling has failed, all messages are queued in memory. Switching
+  // back and forth could change the order of the messages of a stream.
+  if (Spool != nullptr and not SpoolFailed) {
+    if (Spool->append(Msg)) {
+      SpooledMessages++;
+      QueueDepth++;
+      return;
+    }
+    if (not SpoolFailed.exchange(true)) {
+      Log->error("Unable to spool message to disk, queueing all remaining "
+                 "messages in memory instead.");
+    }
+  }
+  auto const QueueTime = system_clock::now();
+  QueueDepth++;
+  WriteJobs.enqueue([=]() {
+    QueueDepth -= 1;
+    QueueLatency.add(inMicroSeconds(system_clock::now() - QueueTime));
+    writeMsgImpl(Msg.DestPtr, Msg.FbMsg);
+  });
 }
 
 void MessageWriter::stop() { RunThread = false; }
 
+std::map<std::string, int64_t> MessageWriter::getWriteErrorsPerStream() const {
+  std::lock_guard<std::mutex> const Lock(StreamWriteErrorsMutex);
+  return StreamWriteErrors;
+}
+
+void MessageWriter::addStreamWriteError(std::string const &StreamName) {
+  std::lock_guard<std::mutex> const Lock(StreamWriteErrorsMutex);
+  ++StreamWriteErrors[StreamName];
+}
+
 void MessageWriter::writeMsgImpl(WriterModule::Base *ModulePtr,
                                  FileWriter::FlatbufferMessage const &Msg) {
   try {
+    TRACE_SPAN("writer_module_write");
+    auto const WriteStart = system_clock::now();
     ModulePtr->write(Msg);
+    ModulesToFlush.insert(ModulePtr);
+    auto const WriteDone = system_clock::now();
     WritesDone++;
+    BytesWritten += Msg.size();
+    WriteTime.add(inMicroSeconds(WriteDone - WriteStart));
+    addLatency(Msg, WriteDone);
+    checkMemoryLimit(Msg.size());
   } catch (WriterModule::WriterException &E) {
     WriteErrors++;
     auto UsedHash = UnknownModuleHash;
+    std::string StreamName{"unknown"};
     if (Msg.isValid()) {
+      StreamName = Msg.getSourceName() + "_" + Msg.getFlatbufferID();
       UsedHash = generateSrcHash(Msg.getSourceName(), Msg.getFlatbufferID());
       if (ModuleErrorCounters.find(UsedHash) == ModuleErrorCounters.end()) {
         auto Description = "Error writing fb.-msg with source name \"" +
                            Msg.getSourceName() +
                            "\" and flatbuffer id: " + Msg.getFlatbufferID();
-        auto Name =
-            "error_" + Msg.getSourceName() + "_" + Msg.getFlatbufferID();
         ModuleErrorCounters[UsedHash] = std::make_unique<Metrics::Metric>(
-            Name, Description, Metrics::Severity::ERROR);
-        Registrar.registerMetric(*ModuleErrorCounters[UnknownModuleHash],
+            "error_" + StreamName, Description, Metrics::Severity::ERROR);
+        Registrar.registerMetric(*ModuleErrorCounters[UsedHash],
                                  {Metrics::LogTo::LOG_MSG});
       }
     }
     (*ModuleErrorCounters[UsedHash])++;
+    addStreamWriteError(StreamName);
   } catch (std::exception &E) {
     WriteErrors++;
-    Log->critical("Unknown file writing error: {}", E.what());
+    LOG_RATE_LIMITED(Log, spdlog::level::critical,
+                     "Unknown file writing error: {}", E.what());
+  }
+}
+
+void MessageWriter::checkMemoryLimit(std::size_t BytesWritten) {
+  if (not MemoryCheckFunction) {
+    return;
+  }
+  if (BytesWritten < BytesUntilMemoryCheck) {
+    BytesUntilMemoryCheck -= BytesWritten;
+    return;
+  }
+  try {
+    BytesUntilMemoryCheck = MemoryCheckFunction();
+  } catch (std::exception const &E) {
+    Log->error("Unable to check the memory limit of the file, the error "
+               "was: {}",
+               E.what());
+    BytesUntilMemoryCheck = std::numeric_limits<std::size_t>::max();
+  }
+}
+
+void MessageWriter::addLatency(FileWriter::FlatbufferMessage const &Msg,
+                               time_point Now) {
+  if (Msg.getKafkaTimestamp().count() == 0) {
+    return;
+  }
+  auto const MsgLatency =
+      inMicroSeconds(Now - time_point(Msg.getKafkaTimestamp()));
+  Latency.add(MsgLatency);
+  auto &SourceLatency = SourceLatencies[Msg.getSourceHash()];
+  if (SourceLatency == nullptr) {
+    SourceLatency = std::make_unique<Metrics::Histogram>(
+        fmt::format("source_latency_us.{}_{}", Msg.getSourceName(),
+                    Msg.getFlatbufferID()),
+        fmt::format("Time (us) from the Kafka timestamp of a message with "
+                    "source name \"{}\" and flatbuffer id \"{}\" until it has "
+                    "been written to file.",
+                    Msg.getSourceName(), Msg.getFlatbufferID()));
+    Registrar.registerMetric(*SourceLatency, {Metrics::LogTo::CARBON});
+  }
+  SourceLatency->add(MsgLatency);
+}
+
+void MessageWriter::flushData() {
+  TRACE_SPAN("flush_datasets");
+  auto const Now = system_clock::now();
+  bool FlushFile{false};
+  for (auto It = ModulesToFlush.begin(); It != ModulesToFlush.end();) {
+    auto *Module = *It;
+    auto &LastFlushTime = LastFlushTimes[Module];
+    if (Now - LastFlushTime < Module->flushInterval()) {
+      ++It;
+      continue;
+    }
+    try {
+      if (not Module->flushDatasets()) {
+        FlushFile = true;
+      }
+    } catch (std::exception const &E) {
+      Log->error("Failed to flush datasets, flushing the file instead. The "
+                 "error was: {}",
+                 E.what());
+      FlushFile = true;
+    }
+    LastFlushTime = Now;
+    It = ModulesToFlush.erase(It);
+  }
+  if (FlushFile) {
+    FlushDataFunction();
   }
 }
 
@@ -95,10 +236,30 @@ void MessageWriter::threadFunction() {
       NextFlushTime += FlushPeriods * FlushInterval;
     }
   };
+  MessageSpool::MessageHandler const WriteSpooledMessage =
+      [this](WriterModule::Base *ModulePtr,
+             FileWriter::FlatbufferMessage const &Msg, time_point AppendTime) {
+        QueueDepth -= 1;
+        QueueLatency.add(inMicroSeconds(system_clock::now() - AppendTime));
+        writeMsgImpl(ModulePtr, Msg);
+      };
+  auto WriteNextMessage = [&]() {
+    if (Spool != nullptr and Spool->readNext(WriteSpooledMessage)) {
+      return true;
+    }
+    if (WriteJobs.try_dequeue(CurrentJob)) {
+      // Messages spooled before spooling failed were appended before this
+      // job was queued and must be written first.
+      while (Spool != nullptr and Spool->readNext(WriteSpooledMessage)) {
+      }
+      CurrentJob();
+      return true;
+    }
+    return false;
+  };
   auto WriteOperation = [&]() {
     CheckTimeCounter = 0;
-    while (WriteJobs.try_dequeue(CurrentJob)) {
-      CurrentJob();
+    while (WriteNextMessage()) {
       ++CheckTimeCounter;
       if (CheckTimeCounter > MaxTimeCheckCounter) {
         FlushOperation();
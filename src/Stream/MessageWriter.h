@@ -13,13 +13,18 @@
 #pragma once
 
 #include "Message.h"
+#include "MessageSpool.h"
+#include "Metrics/Histogram.h"
 #include "Metrics/Metric.h"
 #include "Metrics/Registrar.h"
 #include "TimeUtility.h"
 #include "logger.h"
 #include <concurrentqueue/concurrentqueue.h>
 #include <map>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace WriterModule {
 class Base;
@@ -29,9 +34,15 @@ namespace Stream {
 
 class MessageWriter {
 public:
+  /// \param MemoryCheck Called after writing a message, at the latest when
+  /// the number of bytes it returned the last time it was called have been
+  /// written. Used for switching a file kept in memory to disk before it
+  /// reaches its memory limit.
   explicit MessageWriter(std::function<void()> FlushFunction,
                          duration FlushIntervalTime,
-                         Metrics::Registrar const &MetricReg);
+                         Metrics::Registrar const &MetricReg,
+                         SpoolSettings const &Spooling = {},
+                         std::function<std::size_t()> MemoryCheck = {});
 
   virtual ~MessageWriter();
 
@@ -46,29 +57,75 @@ public:
 
   auto nrOfWritesDone() const { return int64_t(WritesDone); };
   auto nrOfWriteErrors() const { return int64_t(WriteErrors); };
+  auto nrOfBytesWritten() const { return int64_t(BytesWritten); };
+  auto queueDepth() const { return int64_t(QueueDepth); };
   auto nrOfWriterModulesWithErrors() const {
     return ModuleErrorCounters.size();
   }
 
+  /// \brief The number of write errors per "<source name>_<flatbuffer id>".
+  ///
+  /// Errors of messages that could not be identified are counted as
+  /// "unknown". Can be called from any thread.
+  std::map<std::string, int64_t> getWriteErrorsPerStream() const;
+
 protected:
   virtual void writeMsgImpl(WriterModule::Base *ModulePtr,
                             FileWriter::FlatbufferMessage const &Msg);
   virtual void threadFunction();
 
-  virtual void flushData() { FlushDataFunction(); };
+  /// \brief Flush the datasets of the writer modules that have written data
+  /// since they were last flushed.
+  ///
+  /// Writer modules with a flush interval are skipped until the interval has
+  /// passed. The whole file is flushed (FlushDataFunction) if the datasets of
+  /// a writer module are not known.
+  virtual void flushData();
   std::function<void()> FlushDataFunction;
+  void checkMemoryLimit(std::size_t BytesWritten);
+  std::function<std::size_t()> MemoryCheckFunction;
+  std::size_t BytesUntilMemoryCheck{0};
+  std::unordered_set<WriterModule::Base *> ModulesToFlush;
+  std::unordered_map<WriterModule::Base *, time_point> LastFlushTimes;
 
   SharedLogger Log{getLogger()};
-  Metrics::Metric WritesDone{"writes_done",
-                             "Number of completed writes to HDF file."};
+  Metrics::Rate WritesDone{"writes_done",
+                           "Number of completed writes to HDF file."};
+  Metrics::Rate BytesWritten{
+      "bytes_written", "Number of bytes of flatbuffer messages written."};
+  Metrics::Gauge QueueDepth{
+      "queue_depth",
+      "Number of messages queued up (or spooled) for writing."};
   Metrics::Metric WriteErrors{"write_errors",
                               "Number of failed HDF file writes.",
                               Metrics::Severity::ERROR};
+  Metrics::Metric SpooledMessages{
+      "spooled", "Number of messages spooled to disk before writing."};
   std::map<ModuleHash, std::unique_ptr<Metrics::Metric>> ModuleErrorCounters;
+  void addStreamWriteError(std::string const &StreamName);
+  mutable std::mutex StreamWriteErrorsMutex;
+  std::map<std::string, int64_t> StreamWriteErrors;
+  Metrics::Histogram QueueLatency{
+      "queue_latency_us",
+      "Time (us) from queueing a message until writing of it starts."};
+  Metrics::Histogram WriteTime{
+      "write_time_us",
+      "Time (us) used by the writer module to write a message."};
+  Metrics::Histogram Latency{"latency_us",
+                             "Time (us) from the Kafka timestamp of a message "
+                             "until it has been written to file."};
+  /// Keyed by the source hash of the messages, which is calculated once when
+  /// a message is received.
+  std::unordered_map<FileWriter::FlatbufferMessage::SrcHash,
+                     std::unique_ptr<Metrics::Histogram>>
+      SourceLatencies;
+  void addLatency(FileWriter::FlatbufferMessage const &Msg, time_point Now);
   Metrics::Registrar Registrar;
 
   using JobType = std::function<void()>;
   moodycamel::ConcurrentQueue<JobType> WriteJobs;
+  std::unique_ptr<MessageSpool> Spool;
+  std::atomic_bool SpoolFailed{false};
   std::thread WriterThread;
   std::atomic_bool RunThread{true};
   const duration SleepTime{10ms};
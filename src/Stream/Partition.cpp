@@ -9,6 +9,8 @@
 
 #include "Partition.h"
 #include "Msg.h"
+#include "Tracing.h"
+#include <thread>
 
 namespace Stream {
 
@@ -16,10 +18,11 @@ Partition::Partition(std::unique_ptr<Kafka::ConsumerInterface> Consumer,
                      int Partition, std::string TopicName, SrcToDst const &Map,
                      MessageWriter *Writer, Metrics::Registrar RegisterMetric,
                      time_point Start, time_point Stop, duration StopLeeway,
-                     duration KafkaErrorTimeout)
+                     duration KafkaErrorTimeout,
+                     VerificationSettings const &Verification)
     : ConsumerPtr(std::move(Consumer)), PartitionID(Partition),
       Topic(std::move(TopicName)), StopTime(Stop), StopTimeLeeway(StopLeeway),
-      StopTester(Stop, StopLeeway, KafkaErrorTimeout) {
+      StopTester(Stop, StopLeeway, KafkaErrorTimeout), Verifier(Verification) {
   // Stop time is reduced if it is too close to max to avoid overflow.
   if (time_point::max() - StopTime <= StopTimeLeeway) {
     StopTime -= StopTimeLeeway;
@@ -55,6 +58,7 @@ Partition::Partition(std::unique_ptr<Kafka::ConsumerInterface> Consumer,
   RegisterMetric.registerMetric(
       KafkaErrors, {Metrics::LogTo::CARBON, Metrics::LogTo::LOG_MSG});
   RegisterMetric.registerMetric(MessagesReceived, {Metrics::LogTo::CARBON});
+  RegisterMetric.registerMetric(BytesReceived, {Metrics::LogTo::CARBON});
   RegisterMetric.registerMetric(MessagesProcessed, {Metrics::LogTo::CARBON});
   RegisterMetric.registerMetric(
       BadOffsets, {Metrics::LogTo::CARBON, Metrics::LogTo::LOG_MSG});
@@ -71,6 +75,14 @@ Partition::Partition(std::unique_ptr<Kafka::ConsumerInterface> Consumer,
       {Metrics::LogTo::CARBON, Metrics::LogTo::LOG_MSG});
   RegisterMetric.registerMetric(
       BufferTooSmallErrors, {Metrics::LogTo::CARBON, Metrics::LogTo::LOG_MSG});
+  RegisterMetric.registerMetric(
+      VerificationReverts, {Metrics::LogTo::CARBON, Metrics::LogTo::LOG_MSG});
+  RegisterMetric.registerMetric(BoundsOnlyVerifications,
+                                {Metrics::LogTo::CARBON});
+  RegisterMetric.registerMetric(ThrottledPolls, {Metrics::LogTo::CARBON});
+  RegisterMetric.registerMetric(ConsumeLatency, {Metrics::LogTo::CARBON});
+  RegisterMetric.registerMetric(LagMessages, {Metrics::LogTo::CARBON});
+  RegisterMetric.registerMetric(LagTime, {Metrics::LogTo::CARBON});
 }
 
 void Partition::start() { addPollTask(); }
@@ -113,11 +125,71 @@ bool Partition::shouldStopBasedOnPollStatus(Kafka::PollStatus CStatus) {
   return false;
 }
 
+bool Partition::throttleIfOverBudget() {
+  if (not FileWriter::MemoryAccountant::getInstance().shouldThrottle(
+          *ConsumptionStats)) {
+    return false;
+  }
+  ThrottledPolls++;
+  std::this_thread::sleep_for(ThrottleBackOffTime);
+  ConsumptionStats->ThrottledTime +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(ThrottleBackOffTime)
+          .count();
+  return true;
+}
+
+void Partition::updateLag() {
+  auto Now = system_clock::now();
+  if (Now < NextLagUpdate or LastMessageTime == time_point()) {
+    return;
+  }
+  NextLagUpdate = Now + LagUpdateInterval;
+  auto HighWatermark = ConsumerPtr->getHighWatermark(Topic, PartitionID);
+  if (not HighWatermark) {
+    return;
+  }
+  // The high watermark is the offset of the next message to be produced.
+  auto NrOfMessagesBehind =
+      std::max(*HighWatermark - (CurrentOffset + 1), std::int64_t(0));
+  LagMessages = NrOfMessagesBehind;
+  if (NrOfMessagesBehind == 0) {
+    LastCaughtUpTime = Now;
+    LagTime = 0;
+    return;
+  }
+  // The next unconsumed message was produced after the last consumed message
+  // and, as it was not on the broker then, after the partition was last
+  // caught up. For a sparse partition the latter is the better estimate.
+  auto NextMessageTime = std::max(LastMessageTime, LastCaughtUpTime);
+  LagTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::max(Now - NextMessageTime, duration(0)))
+                .count();
+}
+
 void Partition::pollForMessage() {
+  updateLag();
+  if (throttleIfOverBudget()) {
+    if (StopTester.hasForceStopped()) {
+      HasFinished = true;
+      return;
+    }
+    if (system_clock::now() > StopTime + StopTimeLeeway) {
+      LOG_WARN("Done consuming data from partition {} of topic \"{}\" as we "
+               "have reached the stop time while throttled, data might be "
+               "missing from the file.",
+               PartitionID, Topic);
+      HasFinished = true;
+      return;
+    }
+    addPollTask();
+    return;
+  }
   auto Msg = ConsumerPtr->poll();
   switch (Msg.first) {
   case Kafka::PollStatus::Message:
     MessagesReceived++;
+    BytesReceived += Msg.second.size();
+    ConsumptionStats->ConsumedBytes += Msg.second.size();
     break;
   case Kafka::PollStatus::TimedOut:
     KafkaTimeouts++;
@@ -154,33 +226,60 @@ void Partition::pollForMessage() {
   addPollTask();
 }
 
+void Partition::revertToFullVerification() {
+  if (Verifier.reportFailure()) {
+    VerificationReverts++;
+    LOG_WARN("Got bad flatbuffer in partition {} of topic \"{}\". Reverting "
+             "to full verification of all messages.",
+             PartitionID, Topic);
+  }
+}
+
 void Partition::processMessage(FileWriter::Msg const &Message) {
+  if (Message.getMetaData().TimestampType !=
+      RdKafka::MessageTimestamp::MSG_TIMESTAMP_NOT_AVAILABLE) {
+    LastMessageTime = Message.getMetaData().timestamp();
+    ConsumeLatency.add(std::chrono::duration_cast<std::chrono::microseconds>(
+                           system_clock::now() -
+                           Message.getMetaData().timestamp())
+                           .count());
+  }
   if (CurrentOffset != 0 and
       CurrentOffset + 1 != Message.getMetaData().Offset) {
     BadOffsets++;
   }
   CurrentOffset = Message.getMetaData().Offset;
+  auto UsedVerification = Verifier.getNextLevel();
+  if (UsedVerification == FileWriter::VerificationLevel::BOUNDS_ONLY) {
+    BoundsOnlyVerifications++;
+  }
   FileWriter::FlatbufferMessage FbMsg;
   try {
-    FbMsg = FileWriter::FlatbufferMessage(Message);
+    TRACE_SPAN("flatbuffer_verify");
+    FbMsg = FileWriter::FlatbufferMessage(Message, UsedVerification);
   } catch (FileWriter::BufferTooSmallError &) {
     BufferTooSmallErrors++;
     FlatbufferErrors++;
+    revertToFullVerification();
     return;
   } catch (FileWriter::InvalidFlatbufferTimestamp &) {
     BadFlatbufferTimestampErrors++;
     FlatbufferErrors++;
     return;
   } catch (FileWriter::UnknownFlatbufferID &) {
+    // Neither error is a sign of a malformed buffer, thus the verification
+    // level is kept.
     UnknownFlatbufferIdErrors++;
     FlatbufferErrors++;
     return;
   } catch (FileWriter::NotValidFlatbuffer &) {
     NotValidFlatbufferErrors++;
     FlatbufferErrors++;
+    revertToFullVerification();
     return;
   } catch (std::exception &) {
     FlatbufferErrors++;
+    revertToFullVerification();
     return;
   }
   if (std::any_of(MsgFilters.begin(), MsgFilters.end(), [&FbMsg](auto &Item) {
@@ -11,13 +11,16 @@
 
 #include "FlatbufferMessage.h"
 #include "Kafka/Consumer.h"
+#include "MemoryAccountant.h"
 #include "Message.h"
 #include "MessageWriter.h"
+#include "Metrics/Histogram.h"
 #include "PartitionFilter.h"
 #include "SourceFilter.h"
 #include "Stream/MessageWriter.h"
 #include "ThreadedExecutor.h"
 #include "TimeUtility.h"
+#include "VerificationSampler.h"
 
 namespace Stream {
 
@@ -43,7 +46,8 @@ public:
   Partition(std::unique_ptr<Kafka::ConsumerInterface> Consumer, int Partition,
             std::string TopicName, SrcToDst const &Map, MessageWriter *Writer,
             Metrics::Registrar RegisterMetric, time_point Start,
-            time_point Stop, duration StopLeeway, duration KafkaErrorTimeout);
+            time_point Stop, duration StopLeeway, duration KafkaErrorTimeout,
+            VerificationSettings const &Verification = {});
   virtual ~Partition() = default;
 
   /// \brief Must be called after the constructor.
@@ -62,14 +66,22 @@ public:
   auto getPartitionID() const { return PartitionID; }
   auto getTopicName() const { return Topic; }
 
+  /// \brief How long the oldest unconsumed message has been on the broker,
+  /// as of the last lag update.
+  std::chrono::milliseconds getLagTime() const {
+    return std::chrono::milliseconds(LagTime.value());
+  }
+
 protected:
   Metrics::Metric KafkaTimeouts{"timeouts",
                                 "Timeouts when polling for messages."};
   Metrics::Metric KafkaErrors{"kafka_errors",
                               "Errors received when polling for messages.",
                               Metrics::Severity::ERROR};
-  Metrics::Metric MessagesReceived{"received",
-                                   "Number of messages received from broker."};
+  Metrics::Rate MessagesReceived{"received",
+                                 "Number of messages received from broker."};
+  Metrics::Rate BytesReceived{"bytes_received",
+                              "Number of bytes received from broker."};
   Metrics::Metric MessagesProcessed{
       "processed", "Number of messages queued up for writing."};
   Metrics::Metric BadOffsets{"bad_offsets",
@@ -98,10 +110,40 @@ protected:
       "Number of messages received with bad timestamps.",
       Metrics::Severity::ERROR};
 
+  Metrics::Metric VerificationReverts{
+      "flatbuffer_errors.verification_reverted",
+      "Number of times sampled flatbuffer verification was turned off due "
+      "to a bad message.",
+      Metrics::Severity::ERROR};
+
+  Metrics::Metric BoundsOnlyVerifications{
+      "flatbuffer_verification.bounds_only",
+      "Number of messages that were only bounds checked (not fully "
+      "verified)."};
+
+  Metrics::Metric ThrottledPolls{
+      "throttled_polls",
+      "Number of polls skipped due to the memory ceiling being reached."};
+
+  Metrics::Gauge LagMessages{
+      "lag_messages",
+      "Number of messages on the broker that have not yet been consumed."};
+
+  Metrics::Gauge LagTime{"lag_ms",
+                         "Estimated age (ms) of the oldest unconsumed message "
+                         "on the broker, zero if there is none."};
+
+  Metrics::Histogram ConsumeLatency{
+      "consume_latency_us",
+      "Time (us) from the Kafka timestamp of a message until it is consumed."};
+
   virtual void pollForMessage();
+  bool throttleIfOverBudget();
+  void updateLag();
   virtual void addPollTask();
   virtual bool shouldStopBasedOnPollStatus(Kafka::PollStatus CStatus);
   void forceStop();
+  void revertToFullVerification();
 
   virtual void processMessage(FileWriter::Msg const &Message);
   std::unique_ptr<Kafka::ConsumerInterface> ConsumerPtr;
@@ -109,9 +151,19 @@ protected:
   std::string Topic{"not_initialized"};
   std::atomic_bool HasFinished{false};
   std::int64_t CurrentOffset{0};
+  /// Kafka timestamp of the last consumed message.
+  time_point LastMessageTime;
+  /// Time of the last lag update at which all messages had been consumed.
+  time_point LastCaughtUpTime;
+  time_point NextLagUpdate;
+  duration LagUpdateInterval{1s};
   time_point StopTime;
   duration StopTimeLeeway;
   PartitionFilter StopTester;
+  VerificationSampler Verifier;
+  std::shared_ptr<FileWriter::ConsumerStats> ConsumptionStats{
+      FileWriter::MemoryAccountant::getInstance().addConsumer()};
+  duration ThrottleBackOffTime{10ms};
   std::vector<std::pair<FileWriter::FlatbufferMessage::SrcHash,
                         std::unique_ptr<SourceFilter>>>
       MsgFilters;
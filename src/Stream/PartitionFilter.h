@@ -46,6 +46,9 @@ public:
   /// \brief Check if we currently have an error state.
   bool hasErrorState() const { return HasError; }
 
+  /// \brief Check if forceStop() has been called.
+  bool hasForceStopped() const { return ForceStop; }
+
 protected:
   bool ForceStop{false};
   bool HasError{false};
@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "ReplayTopic.h"
+#include "Kafka/ReplayConsumer.h"
+
+namespace Stream {
+
+ReplayTopic::ReplayTopic(std::string ReplayDirectory,
+                         Kafka::BrokerSettings const &Settings,
+                         std::string const &Topic, SrcToDst Map,
+                         MessageWriter *Writer,
+                         Metrics::Registrar &RegisterMetric,
+                         time_point StartTime, duration StartTimeLeeway,
+                         time_point StopTime, duration StopTimeLeeway,
+                         VerificationSettings const &Verification)
+    : Stream::Topic(Settings, Topic, std::move(Map), Writer, RegisterMetric,
+                    StartTime, StartTimeLeeway, StopTime, StopTimeLeeway,
+                    std::make_unique<Kafka::ReplayConsumerFactory>(
+                        ReplayDirectory),
+                    Verification),
+      Directory(std::move(ReplayDirectory)) {}
+
+std::vector<std::pair<int, int64_t>> ReplayTopic::getOffsetForTimeInternal(
+    std::string const &, std::string const &Topic,
+    std::vector<int> const &Partitions, time_point Time, duration) const {
+  return Kafka::getRecordedOffsetsForTime(Directory, Topic, Partitions, Time);
+}
+
+std::vector<int>
+ReplayTopic::getPartitionsForTopicInternal(std::string const &,
+                                           std::string const &Topic,
+                                           duration) const {
+  return Kafka::getRecordedPartitions(Directory, Topic);
+}
+
+} // namespace Stream
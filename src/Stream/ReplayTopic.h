@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#pragma once
+
+#include "Topic.h"
+
+namespace Stream {
+
+/// \brief Topic that replays recorded messages instead of consuming them
+/// from a Kafka broker.
+///
+/// Partition and offset look-ups are done on the recorded messages.
+class ReplayTopic : public Topic {
+public:
+  ReplayTopic(std::string ReplayDirectory,
+              Kafka::BrokerSettings const &Settings, std::string const &Topic,
+              SrcToDst Map, MessageWriter *Writer,
+              Metrics::Registrar &RegisterMetric, time_point StartTime,
+              duration StartTimeLeeway, time_point StopTime,
+              duration StopTimeLeeway,
+              VerificationSettings const &Verification = {});
+
+protected:
+  std::vector<std::pair<int, int64_t>>
+  getOffsetForTimeInternal(std::string const &Broker, std::string const &Topic,
+                           std::vector<int> const &Partitions, time_point Time,
+                           duration TimeOut) const override;
+
+  std::vector<int>
+  getPartitionsForTopicInternal(std::string const &Broker,
+                                std::string const &Topic,
+                                duration TimeOut) const override;
+
+  std::string Directory;
+};
+} // namespace Stream
@@ -8,6 +8,7 @@
 // Screaming Udder!                              https://esss.se
 
 #include "SourceFilter.h"
+#include "Tracing.h"
 
 namespace Stream {
 
@@ -39,6 +40,7 @@ void SourceFilter::sendBufferedMessage() {
 }
 
 bool SourceFilter::filterMessage(FileWriter::FlatbufferMessage InMsg) {
+  TRACE_SPAN("source_filter");
   MessagesReceived++;
   if (not InMsg.isValid()) {
     MessagesDiscarded++;
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "SpoolSegment.h"
+#include "logger.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Stream {
+
+namespace {
+size_t const RecordAlignment{8};
+
+size_t padToAlignment(size_t Size) {
+  return (Size + RecordAlignment - 1) / RecordAlignment * RecordAlignment;
+}
+} // namespace
+
+static_assert(sizeof(SpoolRecordHeader) % RecordAlignment == 0,
+              "Spool record header must keep the message data aligned.");
+
+SpoolSegment::SpoolSegment(std::string Path, size_t SegmentCapacity,
+                           bool KeepFile)
+    : FilePath(std::move(Path)), Capacity(SegmentCapacity),
+      KeepFileOnClose(KeepFile) {
+  FileDescriptor = open(FilePath.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (FileDescriptor == -1) {
+    throw std::runtime_error(
+        fmt::format("Unable to create spool file \"{}\": {}", FilePath,
+                    std::strerror(errno)));
+  }
+  if (ftruncate(FileDescriptor, static_cast<off_t>(Capacity)) != 0) {
+    auto Error = errno;
+    close(FileDescriptor);
+    unlink(FilePath.c_str());
+    throw std::runtime_error(
+        fmt::format("Unable to resize spool file \"{}\": {}", FilePath,
+                    std::strerror(Error)));
+  }
+  auto MapResult = mmap(nullptr, Capacity, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        FileDescriptor, 0);
+  if (MapResult == MAP_FAILED) {
+    auto Error = errno;
+    close(FileDescriptor);
+    unlink(FilePath.c_str());
+    throw std::runtime_error(fmt::format("Unable to map spool file \"{}\": {}",
+                                         FilePath, std::strerror(Error)));
+  }
+  MappedData = static_cast<std::uint8_t *>(MapResult);
+}
+
+SpoolSegment::SpoolSegment(std::string Path)
+    : FilePath(std::move(Path)), KeepFileOnClose(true), ReadOnly(true),
+      Sealed(true) {
+  FileDescriptor = open(FilePath.c_str(), O_RDONLY);
+  if (FileDescriptor == -1) {
+    throw std::runtime_error(
+        fmt::format("Unable to open spool file \"{}\": {}", FilePath,
+                    std::strerror(errno)));
+  }
+  Capacity = static_cast<size_t>(lseek(FileDescriptor, 0, SEEK_END));
+  if (Capacity == 0) {
+    return;
+  }
+  auto MapResult =
+      mmap(nullptr, Capacity, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+  if (MapResult == MAP_FAILED) {
+    auto Error = errno;
+    close(FileDescriptor);
+    throw std::runtime_error(fmt::format("Unable to map spool file \"{}\": {}",
+                                         FilePath, std::strerror(Error)));
+  }
+  MappedData = static_cast<std::uint8_t *>(MapResult);
+  // The file of a segment that is still being written, or whose writer was
+  // killed, has not been truncated and ends with zeros. Its contents end at
+  // the first record without data.
+  size_t Position{0};
+  SpoolRecordHeader Header;
+  while (Position + sizeof(Header) <= Capacity) {
+    std::memcpy(&Header, MappedData + Position, sizeof(Header));
+    if (Header.Size == 0 or Position + recordSize(Header.Size) > Capacity) {
+      break;
+    }
+    Position += recordSize(Header.Size);
+  }
+  CommittedBytes = Position;
+}
+
+SpoolSegment::~SpoolSegment() {
+  if (MappedData != nullptr) {
+    munmap(MappedData, Capacity);
+  }
+  if (not KeepFileOnClose) {
+    close(FileDescriptor);
+    unlink(FilePath.c_str());
+    return;
+  }
+  if (not ReadOnly and
+      ftruncate(FileDescriptor, static_cast<off_t>(committedBytes())) != 0) {
+    LOG_ERROR("Unable to truncate spool file \"{}\": {}", FilePath,
+              std::strerror(errno));
+  }
+  close(FileDescriptor);
+}
+
+size_t SpoolSegment::recordSize(size_t MessageSize) {
+  return sizeof(SpoolRecordHeader) + padToAlignment(MessageSize);
+}
+
+bool SpoolSegment::append(SpoolRecordHeader const &Header, void const *Data) {
+  auto const Position = CommittedBytes.load(std::memory_order_relaxed);
+  if (ReadOnly or Position + recordSize(Header.Size) > Capacity) {
+    return false;
+  }
+  std::memcpy(MappedData + Position, &Header, sizeof(Header));
+  std::memcpy(MappedData + Position + sizeof(Header), Data, Header.Size);
+  CommittedBytes.store(Position + recordSize(Header.Size),
+                       std::memory_order_release);
+  return true;
+}
+
+bool SpoolSegment::readRecord(size_t &Position, SpoolRecordHeader &Header,
+                              std::uint8_t const *&Data) const {
+  if (Position + sizeof(Header) > committedBytes()) {
+    return false;
+  }
+  std::memcpy(&Header, MappedData + Position, sizeof(Header));
+  if (Position + recordSize(Header.Size) > committedBytes()) {
+    return false;
+  }
+  Data = MappedData + Position + sizeof(Header);
+  Position += recordSize(Header.Size);
+  return true;
+}
+
+} // namespace Stream
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+/// \file
+/// \brief Memory mapped file of length prefixed (flatbuffer) messages.
+///
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace Stream {
+
+/// \brief Header stored in front of every message in a spool segment.
+///
+/// The size of the header is a multiple of 8 bytes and the message data is
+/// padded to a multiple of 8 bytes in order to keep the flatbuffers aligned.
+struct SpoolRecordHeader {
+  std::uint64_t Size{0}; // Size of the message data (excluding padding), > 0
+  std::uint64_t SourceHash{0};
+  std::uint64_t Destination{0};
+  std::int64_t Offset{-1};          // Kafka offset
+  std::int64_t KafkaTimestamp{0};   // ms
+  std::int64_t MessageTimestamp{0}; // Flatbuffer timestamp, ns
+  std::int64_t AppendTime{0};       // ns since epoch
+  std::int32_t Partition{-1};
+  std::uint32_t Reserved{0};
+};
+
+/// \brief A file of spooled messages that is memory mapped.
+///
+/// There can be one thread appending messages and one thread reading messages
+/// at the same time.
+class SpoolSegment {
+public:
+  /// \brief Create (and memory map) a new segment file.
+  ///
+  /// \param FilePath Path of the file to create. The file must not exist.
+  /// \param Capacity Size of the file in bytes.
+  /// \param KeepFile If true, the file is truncated to the size of its
+  /// contents instead of being removed on destruction.
+  /// \throw std::runtime_error If the file could not be created or mapped.
+  SpoolSegment(std::string FilePath, size_t Capacity, bool KeepFile = false);
+
+  /// \brief Open (and memory map) an existing segment file for reading.
+  ///
+  /// The file is expected to have been created with KeepFile set to true.
+  /// Reading stops at the first record without data, i.e. at the zero filled
+  /// end of a file that has not been truncated.
+  /// \throw std::runtime_error If the file could not be opened or mapped.
+  explicit SpoolSegment(std::string FilePath);
+  SpoolSegment(SpoolSegment const &) = delete;
+  SpoolSegment &operator=(SpoolSegment const &) = delete;
+
+  /// \brief Un-maps and removes (or truncates) the file.
+  ~SpoolSegment();
+
+  /// \brief The number of bytes used by a record with the given message size.
+  static size_t recordSize(size_t MessageSize);
+
+  /// \brief Append a message.
+  ///
+  /// \return false if there is not enough space left in the segment or if
+  /// the segment was opened for reading only.
+  bool append(SpoolRecordHeader const &Header, void const *Data);
+
+  /// \brief Read the record at a position (if it has been written).
+  ///
+  /// \param Position Position of the record, is moved to the next record if
+  /// a record was read.
+  /// \return false if there is no (completely written) record at the
+  /// position.
+  bool readRecord(size_t &Position, SpoolRecordHeader &Header,
+                  std::uint8_t const *&Data) const;
+
+  /// \brief Mark the segment as done, i.e. no more messages will be
+  /// appended.
+  void seal() { Sealed = true; }
+  bool isSealed() const { return Sealed.load(); }
+  size_t committedBytes() const {
+    return CommittedBytes.load(std::memory_order_acquire);
+  }
+  size_t capacity() const { return Capacity; }
+  std::string const &filePath() const { return FilePath; }
+
+private:
+  std::string FilePath;
+  size_t Capacity{0};
+  int FileDescriptor{-1};
+  std::uint8_t *MappedData{nullptr};
+  bool KeepFileOnClose{false};
+  bool ReadOnly{false};
+  std::atomic<size_t> CommittedBytes{0};
+  std::atomic_bool Sealed{false};
+};
+
+} // namespace Stream
@@ -20,12 +20,14 @@ Topic::Topic(Kafka::BrokerSettings const &Settings, std::string const &Topic,
              Metrics::Registrar &RegisterMetric, time_point StartTime,
              duration StartTimeLeeway, time_point StopTime,
              duration StopTimeLeeway,
-             std::unique_ptr<Kafka::ConsumerFactoryInterface> CreateConsumers)
+             std::unique_ptr<Kafka::ConsumerFactoryInterface> CreateConsumers,
+             VerificationSettings const &Verification)
     : KafkaSettings(Settings), TopicName(Topic), DataMap(std::move(Map)),
       WriterPtr(Writer), StartConsumeTime(StartTime),
       StartLeeway(StartTimeLeeway), StopConsumeTime(StopTime),
       StopLeeway(StopTimeLeeway),
       CurrentMetadataTimeOut(Settings.MinMetadataTimeout),
+      FlatbufferVerification(Verification),
       Registrar(RegisterMetric.getNewRegistrar(Topic)),
       ConsumerCreator(std::move(CreateConsumers)) {}
 
@@ -138,7 +140,7 @@ void Topic::createStreams(
     auto TempPartition = std::make_unique<Partition>(
         std::move(Consumer), CParOffset.first, Topic, DataMap, WriterPtr,
         CRegistrar, StartConsumeTime, StopConsumeTime, StopLeeway,
-        Settings.KafkaErrorTimeout);
+        Settings.KafkaErrorTimeout, FlatbufferVerification);
     TempPartition->start();
     ConsumerThreads.emplace_back(std::move(TempPartition));
   }
@@ -150,6 +152,11 @@ void Topic::checkIfDone() {
       std::remove_if(ConsumerThreads.begin(), ConsumerThreads.end(),
                      [](auto const &Elem) { return Elem->hasFinished(); }),
       ConsumerThreads.end());
+  std::chrono::milliseconds MaxLagTime{0};
+  for (auto const &Consumer : ConsumerThreads) {
+    MaxLagTime = std::max(MaxLagTime, Consumer->getLagTime());
+  }
+  LagTime.store(MaxLagTime.count());
   if (ConsumerThreads.empty()) {
     IsDone.store(true);
   }
@@ -28,7 +28,8 @@ public:
         time_point StartTime, duration StartTimeLeeway, time_point StopTime,
         duration StopTimeLeeway,
         std::unique_ptr<Kafka::ConsumerFactoryInterface> CreateConsumers =
-            std::make_unique<Kafka::ConsumerFactory>());
+            std::make_unique<Kafka::ConsumerFactory>(),
+        VerificationSettings const &Verification = {});
 
   /// \brief Must be called after the constructor.
   /// \note This function exist in order to make unit testing possible.
@@ -44,10 +45,17 @@ public:
 
   bool isDone() { return IsDone.load(); };
 
+  /// \brief The largest consumer lag (in time) of the partitions of the
+  /// topic.
+  std::chrono::milliseconds getLagTime() const {
+    return std::chrono::milliseconds(LagTime.load());
+  }
+
   virtual ~Topic() = default;
 
 protected:
   std::atomic_bool IsDone{false};
+  std::atomic<std::int64_t> LagTime{0};
   Kafka::BrokerSettings KafkaSettings;
   std::string TopicName;
   SrcToDst DataMap;
@@ -57,6 +65,7 @@ protected:
   time_point StopConsumeTime;
   duration StopLeeway;
   duration CurrentMetadataTimeOut;
+  VerificationSettings FlatbufferVerification;
   Metrics::Registrar Registrar;
 
   // This intermediate function is required for unit testing.
@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "VerificationSampler.h"
+
+namespace Stream {
+
+using FileWriter::VerificationLevel;
+
+VerificationSampler::VerificationSampler(VerificationSettings const &Settings)
+    : UsedSettings(Settings), AlwaysFullyVerify(Settings.SampleInterval <= 1) {}
+
+VerificationLevel VerificationSampler::getNextLevel() {
+  if (AlwaysFullyVerify) {
+    return VerificationLevel::FULL;
+  }
+  auto CurrentMessage = MessageCounter++;
+  if (CurrentMessage < UsedSettings.FullyVerifiedMessages) {
+    return VerificationLevel::FULL;
+  }
+  if ((CurrentMessage - UsedSettings.FullyVerifiedMessages) %
+          UsedSettings.SampleInterval ==
+      0) {
+    return VerificationLevel::FULL;
+  }
+  return VerificationLevel::BOUNDS_ONLY;
+}
+
+bool VerificationSampler::reportFailure() {
+  if (AlwaysFullyVerify) {
+    return false;
+  }
+  AlwaysFullyVerify = true;
+  return true;
+}
+
+} // namespace Stream
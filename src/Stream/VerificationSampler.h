@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#pragma once
+
+#include "FlatbufferMessage.h"
+#include <cstdint>
+
+namespace Stream {
+
+/// \brief Settings for sampled verification of flatbuffers.
+///
+/// The default values result in every message being fully verified.
+struct VerificationSettings {
+  /// Number of messages at the start of a stream that are always fully
+  /// verified.
+  std::uint64_t FullyVerifiedMessages{0};
+  /// After the initial messages, only one in this many messages is fully
+  /// verified. The remaining messages only get a bounds check. A value of 0 or
+  /// 1 disables sampling.
+  std::uint64_t SampleInterval{1};
+};
+
+/// \brief Decides on the level of verification to apply to each flatbuffer
+/// received on a stream.
+///
+/// Meant for data from trusted producers where running the full flatbuffer
+/// verifier on every (large) message is a waste of CPU time. Any failure
+/// reported to an instance will permanently revert it to full verification.
+class VerificationSampler {
+public:
+  VerificationSampler() = default;
+  explicit VerificationSampler(VerificationSettings const &Settings);
+
+  /// \brief Get the verification level to use for the next message.
+  FileWriter::VerificationLevel getNextLevel();
+
+  /// \brief Report that a message failed verification (or was otherwise
+  /// broken).
+  ///
+  /// \return True if this call caused the sampler to revert to full
+  /// verification.
+  bool reportFailure();
+
+  /// \brief Check if messages are currently being sampled.
+  bool isSampling() const { return not AlwaysFullyVerify; }
+
+protected:
+  VerificationSettings UsedSettings;
+  std::uint64_t MessageCounter{0};
+  bool AlwaysFullyVerify{true};
+};
+
+} // namespace Stream
@@ -1,12 +1,35 @@
 #include "StreamController.h"
 #include "FileWriterTask.h"
+#include "Filesystem.h"
 #include "Kafka/ConsumerFactory.h"
 #include "Kafka/MetaDataQuery.h"
 #include "Kafka/MetadataException.h"
+#include "Kafka/RecordingConsumer.h"
+#include "Kafka/ReplayConsumer.h"
 #include "Stream/Partition.h"
+#include "Stream/ReplayTopic.h"
 #include "helper.h"
 
 namespace FileWriter {
+
+namespace {
+Stream::SpoolSettings getJobSpoolSettings(Stream::SpoolSettings Settings,
+                                          std::string const &JobId) {
+  if (not Settings.Directory.empty()) {
+    Settings.Directory = (fs::path(Settings.Directory) / JobId).string();
+  }
+  return Settings;
+}
+
+std::unique_ptr<Kafka::ConsumerFactoryInterface>
+createConsumerFactory(StreamerOptions const &Settings) {
+  if (Settings.RecordDirectory.empty()) {
+    return std::make_unique<Kafka::ConsumerFactory>();
+  }
+  return std::make_unique<Kafka::RecordingConsumerFactory>(
+      std::make_unique<Kafka::ConsumerFactory>(), Settings.RecordDirectory);
+}
+} // namespace
 StreamController::StreamController(
     std::unique_ptr<FileWriterTask> FileWriterTask, std::string ServiceID,
     FileWriter::StreamerOptions const &Settings,
@@ -15,7 +38,10 @@ StreamController::StreamController(
     : WriterTask(std::move(FileWriterTask)), StreamMetricRegistrar(Registrar),
       WriterThread([this]() { WriterTask->flushDataToFile(); },
                    Settings.DataFlushInterval,
-                   Registrar.getNewRegistrar("stream")),
+                   Registrar.getNewRegistrar("stream"),
+                   getJobSpoolSettings(Settings.MessageSpooling,
+                                       WriterTask->jobID()),
+                   [this]() { return WriterTask->checkMemoryLimit(); }),
       ServiceId(std::move(ServiceID)), KafkaSettings(Settings) {
   Executor.sendLowPriorityWork([=]() {
     CurrentMetadataTimeOut = Settings.BrokerSettings.MinMetadataTimeout;
@@ -45,10 +71,32 @@ bool StreamController::isDoneWriting() {
 
 std::string StreamController::getJobId() const { return WriterTask->jobID(); }
 
+Status::JobPerformanceInfo StreamController::getPerformanceInfo() const {
+  Status::JobPerformanceInfo Info;
+  Info.MessagesWritten = WriterThread.nrOfWritesDone();
+  Info.BytesWritten = WriterThread.nrOfBytesWritten();
+  Info.QueueDepth = WriterThread.queueDepth();
+  Info.WriteErrors = WriterThread.nrOfWriteErrors();
+  Info.WriteErrorsPerStream = WriterThread.getWriteErrorsPerStream();
+  if (auto SizeInMemory = WriterTask->sizeInMemory()) {
+    // The file on disk is only written when the file is flushed or closed.
+    Info.BytesOnDisk = *SizeInMemory;
+  } else {
+    std::error_code ErrorCode;
+    auto const FileSize = fs::file_size(WriterTask->filename(), ErrorCode);
+    Info.BytesOnDisk = ErrorCode ? 0 : FileSize;
+  }
+  Info.ConsumerLag = std::chrono::milliseconds(ConsumerLag.load());
+  return Info;
+}
+
 void StreamController::getTopicNames() {
   try {
-    auto TopicNames = Kafka::getTopicList(KafkaSettings.BrokerSettings.Address,
-                                          CurrentMetadataTimeOut);
+    auto TopicNames =
+        KafkaSettings.ReplayDirectory.empty()
+            ? Kafka::getTopicList(KafkaSettings.BrokerSettings.Address,
+                                  CurrentMetadataTimeOut)
+            : Kafka::getRecordedTopics(KafkaSettings.ReplayDirectory);
     Executor.sendLowPriorityWork([=]() { initStreams(TopicNames); });
   } catch (MetadataException &E) {
     CurrentMetadataTimeOut *= 2;
@@ -84,10 +132,21 @@ void StreamController::initStreams(std::set<std::string> KnownTopicNames) {
         std::chrono::system_clock::time_point(KafkaSettings.StartTimestamp);
     auto CStopTime =
         std::chrono::system_clock::time_point(KafkaSettings.StopTimestamp);
-    auto CTopic = std::make_unique<Stream::Topic>(
-        KafkaSettings.BrokerSettings, CItem.first, CItem.second, &WriterThread,
-        StreamMetricRegistrar, CStartTime, KafkaSettings.BeforeStartTime,
-        CStopTime, KafkaSettings.AfterStopTime);
+    std::unique_ptr<Stream::Topic> CTopic;
+    if (not KafkaSettings.ReplayDirectory.empty()) {
+      CTopic = std::make_unique<Stream::ReplayTopic>(
+          KafkaSettings.ReplayDirectory, KafkaSettings.BrokerSettings,
+          CItem.first, CItem.second, &WriterThread, StreamMetricRegistrar,
+          CStartTime, KafkaSettings.BeforeStartTime, CStopTime,
+          KafkaSettings.AfterStopTime, KafkaSettings.FlatbufferVerification);
+    } else {
+      CTopic = std::make_unique<Stream::Topic>(
+          KafkaSettings.BrokerSettings, CItem.first, CItem.second,
+          &WriterThread, StreamMetricRegistrar, CStartTime,
+          KafkaSettings.BeforeStartTime, CStopTime, KafkaSettings.AfterStopTime,
+          createConsumerFactory(KafkaSettings),
+          KafkaSettings.FlatbufferVerification);
+    }
     CTopic->start();
     Streamers.emplace_back(std::move(CTopic));
   }
@@ -99,6 +158,11 @@ void StreamController::checkIfStreamsAreDone() {
       std::remove_if(Streamers.begin(), Streamers.end(),
                      [](auto const &Elem) { return Elem->isDone(); }),
       Streamers.end());
+  std::chrono::milliseconds MaxLag{0};
+  for (auto const &Streamer : Streamers) {
+    MaxLag = std::max(MaxLag, Streamer->getLagTime());
+  }
+  ConsumerLag.store(MaxLag.count());
 
   if (Streamers.empty()) {
     StreamersRemaining.store(false);
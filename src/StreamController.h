@@ -14,6 +14,7 @@
 
 #include "MainOpt.h"
 #include "Metrics/Registrar.h"
+#include "Status/StatusInfo.h"
 #include "Stream/Topic.h"
 #include "ThreadedExecutor.h"
 #include <atomic>
@@ -29,6 +30,7 @@ public:
   virtual std::string getJobId() const = 0;
   virtual void setStopTime(const std::chrono::milliseconds &StopTime) = 0;
   virtual bool isDoneWriting() = 0;
+  virtual Status::JobPerformanceInfo getPerformanceInfo() const = 0;
 };
 
 /// \brief The StreamController's task is to coordinate the different Streamers.
@@ -69,12 +71,20 @@ public:
   /// \return The job id.
   std::string getJobId() const override;
 
+  /// \brief Get the performance figures of the job for the status messages.
+  ///
+  /// \return The messages and bytes written, the write queue depth, the
+  /// (per stream) write errors, the size of the file and the consumer lag of
+  /// the slowest partition.
+  Status::JobPerformanceInfo getPerformanceInfo() const override;
+
 private:
   void getTopicNames();
   void initStreams(std::set<std::string> KnownTopicNames);
   void checkIfStreamsAreDone();
   std::chrono::system_clock::duration CurrentMetadataTimeOut;
   std::atomic<bool> StreamersRemaining{true};
+  std::atomic<std::int64_t> ConsumerLag{0};
   std::vector<std::unique_ptr<Stream::Topic>> Streamers;
   std::unique_ptr<FileWriterTask> WriterTask{nullptr};
   Metrics::Registrar StreamMetricRegistrar;
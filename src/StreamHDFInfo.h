@@ -9,10 +9,11 @@
 
 #pragma once
 
+#include "json.h"
 #include <string>
 
 struct StreamHDFInfo {
   std::string HDFParentName;
-  std::string ConfigStream;
+  nlohmann::json ConfigStream;
   bool InitialisedOk = false;
 };
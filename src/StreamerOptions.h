@@ -10,6 +10,8 @@
 #pragma once
 
 #include "Kafka/BrokerSettings.h"
+#include "Stream/MessageSpool.h"
+#include "Stream/VerificationSampler.h"
 #include "TimeUtility.h"
 
 namespace FileWriter {
@@ -23,6 +25,13 @@ struct StreamerOptions {
   time_point StopTimestamp{time_point::max()};
   std::chrono::milliseconds BeforeStartTime{1000};
   std::chrono::milliseconds AfterStopTime{1000};
+  Stream::VerificationSettings FlatbufferVerification;
+  Stream::SpoolSettings MessageSpooling;
+  /// Replay messages recorded in this directory instead of consuming them
+  /// from Kafka. Disabled if empty.
+  std::string ReplayDirectory;
+  /// Record all consumed messages to this directory. Disabled if empty.
+  std::string RecordDirectory;
 };
 
 } // namespace FileWriter
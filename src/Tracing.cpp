@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "Tracing.h"
+#include <algorithm>
+#include <chrono>
+#include <fmt/format.h>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+
+namespace Tracing {
+
+namespace {
+auto const ApplicationStart = std::chrono::steady_clock::now();
+
+using BufferPtr = std::shared_ptr<ThreadBuffer>;
+
+/// Keeps the buffers of all threads (also of threads that have exited until
+/// their spans have been written to file) and re-uses the buffers of exited
+/// threads.
+class BufferRegistry {
+public:
+  /// \return nullptr if the maximum number of buffers are in use.
+  BufferPtr acquireBuffer() {
+    std::lock_guard<std::mutex> Lock(BuffersMutex);
+    auto const NewId = NextId++;
+    if (not FreeBuffers.empty()) {
+      auto Buffer = std::move(FreeBuffers.back());
+      FreeBuffers.pop_back();
+      Buffer->reset(NewId);
+      Buffers.push_back(Buffer);
+      return Buffer;
+    }
+    if (Buffers.size() < MaxNrOfThreadBuffers) {
+      Buffers.push_back(std::make_shared<ThreadBuffer>(NewId));
+      return Buffers.back();
+    }
+    if (not ExitedBuffers.empty()) {
+      // The spans of the thread that exited first are lost.
+      auto Buffer = std::move(ExitedBuffers.front());
+      ExitedBuffers.erase(ExitedBuffers.begin());
+      Buffer->reset(NewId);
+      return Buffer;
+    }
+    return nullptr;
+  }
+
+  void releaseBuffer(BufferPtr Buffer) {
+    std::lock_guard<std::mutex> Lock(BuffersMutex);
+    ExitedBuffers.push_back(std::move(Buffer));
+  }
+
+  /// \return The buffers to write to file and, of those, the buffers of the
+  /// threads that have exited.
+  std::pair<std::vector<BufferPtr>, std::vector<BufferPtr>> getBuffers() {
+    std::lock_guard<std::mutex> Lock(BuffersMutex);
+    return {Buffers, ExitedBuffers};
+  }
+
+  /// \brief Make the buffers of exited threads that have been written to
+  /// file available for re-use.
+  void recycleBuffers(std::vector<BufferPtr> const &WrittenExitedBuffers) {
+    std::lock_guard<std::mutex> Lock(BuffersMutex);
+    for (auto const &Buffer : WrittenExitedBuffers) {
+      auto ExitedIt =
+          std::find(ExitedBuffers.begin(), ExitedBuffers.end(), Buffer);
+      if (ExitedIt == ExitedBuffers.end()) {
+        // Already re-used by another thread.
+        continue;
+      }
+      ExitedBuffers.erase(ExitedIt);
+      Buffers.erase(std::find(Buffers.begin(), Buffers.end(), Buffer));
+      FreeBuffers.push_back(Buffer);
+    }
+  }
+
+private:
+  std::mutex BuffersMutex;
+  int NextId{0};
+  std::vector<BufferPtr> Buffers;
+  std::vector<BufferPtr> ExitedBuffers;
+  std::vector<BufferPtr> FreeBuffers;
+};
+
+BufferRegistry &getRegistry() {
+  static BufferRegistry Registry;
+  return Registry;
+}
+
+/// Hands the buffer back to the registry when the thread exits.
+struct ThreadBufferHolder {
+  ThreadBufferHolder() : Buffer(getRegistry().acquireBuffer()) {}
+  ~ThreadBufferHolder() {
+    if (Buffer != nullptr) {
+      getRegistry().releaseBuffer(std::move(Buffer));
+    }
+  }
+  BufferPtr Buffer;
+};
+
+ThreadBuffer *getThreadBuffer() {
+  thread_local ThreadBufferHolder Holder;
+  return Holder.Buffer.get();
+}
+} // namespace
+
+void ThreadBuffer::add(char const *Name, std::int64_t Start,
+                       std::int64_t Duration) {
+  auto Index = NrOfEvents.load(std::memory_order_relaxed);
+  auto &CurrentSlot = Slots[Index % Size];
+  CurrentSlot.Name.store(Name, std::memory_order_relaxed);
+  CurrentSlot.Start.store(Start, std::memory_order_relaxed);
+  CurrentSlot.Duration.store(Duration, std::memory_order_relaxed);
+  NrOfEvents.store(Index + 1, std::memory_order_release);
+}
+
+void ThreadBuffer::reset(int ThreadId) {
+  Id = ThreadId;
+  NrOfEvents.store(0, std::memory_order_release);
+}
+
+std::vector<Event> ThreadBuffer::getEvents() const {
+  auto End = NrOfEvents.load(std::memory_order_acquire);
+  auto Begin = End > Size ? End - Size : 0;
+  std::vector<Event> Events;
+  Events.reserve(End - Begin);
+  for (auto i = Begin; i < End; ++i) {
+    auto const &CurrentSlot = Slots[i % Size];
+    Events.push_back({CurrentSlot.Name.load(std::memory_order_relaxed),
+                      CurrentSlot.Start.load(std::memory_order_relaxed),
+                      CurrentSlot.Duration.load(std::memory_order_relaxed)});
+  }
+  return Events;
+}
+
+std::int64_t now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - ApplicationStart)
+      .count();
+}
+
+void record(char const *Name, std::int64_t Start, std::int64_t End) {
+  if (auto *Buffer = getThreadBuffer()) {
+    Buffer->add(Name, Start, End - Start);
+  }
+}
+
+std::string toChromeTraceJSON() {
+  fmt::memory_buffer Buffer;
+  auto Out = std::back_inserter(Buffer);
+  fmt::format_to(Out, "{{\"traceEvents\":[");
+  char const *Separator = "\n";
+  auto const [Buffers, ExitedBuffers] = getRegistry().getBuffers();
+  for (auto const &CBuffer : Buffers) {
+    fmt::format_to(Out,
+                   "{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                   "\"tid\":{},\"args\":{{\"name\":\"thread {}\"}}}}",
+                   Separator, CBuffer->getId(), CBuffer->getId());
+    Separator = ",\n";
+    for (auto const &CEvent : CBuffer->getEvents()) {
+      if (CEvent.Name == nullptr) {
+        continue;
+      }
+      fmt::format_to(Out,
+                     ",\n{{\"name\":\"{}\",\"cat\":\"kafka-to-nexus\","
+                     "\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},"
+                     "\"dur\":{:.3f}}}",
+                     CEvent.Name, CBuffer->getId(), CEvent.Start / 1000.0,
+                     CEvent.Duration / 1000.0);
+    }
+  }
+  fmt::format_to(Out, "\n],\"displayTimeUnit\":\"ms\"}}\n");
+  getRegistry().recycleBuffers(ExitedBuffers);
+  return fmt::to_string(Buffer);
+}
+
+void writeChromeTrace(std::string const &FileName) {
+  std::ofstream TraceFile(FileName, std::ios::trunc);
+  TraceFile << toChromeTraceJSON();
+  if (not TraceFile) {
+    throw std::runtime_error(
+        fmt::format("Unable to write trace to file \"{}\".", FileName));
+  }
+}
+
+} // namespace Tracing
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+/// \file
+/// \brief Low overhead tracing of the stages of the hot path.
+///
+/// Spans are recorded in a fixed size ring buffer per thread and can be
+/// written to file as Chrome trace event JSON (open in chrome://tracing or
+/// https://ui.perfetto.dev). Use the TRACE_SPAN() macro to trace a scope. The
+/// macro expands to nothing unless the application is built with
+/// ENABLE_TRACING.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Tracing {
+
+/// \brief A completed span. Times are in nanoseconds since the start of the
+/// application.
+struct Event {
+  char const *Name{nullptr};
+  std::int64_t Start{0};
+  std::int64_t Duration{0};
+};
+
+/// \brief Ring buffer with the most recent spans of one thread.
+///
+/// Only the owning thread adds spans. All fields are atomics so that the
+/// buffer can be read from another thread at any time. A span that is
+/// overwritten while being read may be returned with mixed up fields.
+///
+/// The buffer of a thread that has exited is re-used by a new thread once
+/// its spans have been written to file.
+class ThreadBuffer {
+public:
+  static constexpr size_t Size{1 << 16};
+  explicit ThreadBuffer(int ThreadId) : Id(ThreadId) {}
+  void add(char const *Name, std::int64_t Start, std::int64_t Duration);
+  std::vector<Event> getEvents() const;
+  int getId() const { return Id.load(); }
+
+  /// \brief Remove all spans and give the buffer to another thread.
+  void reset(int ThreadId);
+
+private:
+  struct Slot {
+    std::atomic<char const *> Name{nullptr};
+    std::atomic<std::int64_t> Start{0};
+    std::atomic<std::int64_t> Duration{0};
+  };
+  std::unique_ptr<Slot[]> Slots{new Slot[Size]};
+  std::atomic<std::uint64_t> NrOfEvents{0};
+  std::atomic<int> Id;
+};
+
+/// \brief Nanoseconds since the start of the application.
+std::int64_t now();
+
+/// \brief Record a span in the ring buffer of the calling thread.
+///
+/// The span is dropped if the thread has no buffer as the maximum number of
+/// buffers are in use.
+/// \param Name Name of the span, must be a string literal.
+void record(char const *Name, std::int64_t Start, std::int64_t End);
+
+/// \brief The maximum number of thread buffers (of about 1.5 MB each).
+constexpr size_t MaxNrOfThreadBuffers{64};
+
+/// \brief The spans of all threads as Chrome trace event JSON.
+///
+/// The buffers of threads that had exited are released for re-use.
+std::string toChromeTraceJSON();
+
+/// \brief Write the spans of all threads as Chrome trace event JSON.
+///
+/// \throws std::runtime_error If the file can not be written.
+void writeChromeTrace(std::string const &FileName);
+
+/// \brief Records the time spent in the scope of the instance.
+class Span {
+public:
+  /// \param Name Name of the span, must be a string literal.
+  explicit Span(char const *Name) : Name(Name), Start(now()) {}
+  ~Span() { record(Name, Start, now()); }
+  Span(Span const &) = delete;
+  Span &operator=(Span const &) = delete;
+
+private:
+  char const *Name;
+  std::int64_t const Start;
+};
+
+/// \brief True if the application is built with tracing.
+constexpr bool isEnabled() {
+#ifdef ENABLE_TRACING
+  return true;
+#else
+  return false;
+#endif
+}
+
+} // namespace Tracing
+
+#define TRACE_CONCAT_IMPL(A, B) A##B
+#define TRACE_CONCAT(A, B) TRACE_CONCAT_IMPL(A, B)
+
+#ifdef ENABLE_TRACING
+#define TRACE_SPAN(Name) Tracing::Span TRACE_CONCAT(TraceSpan, __LINE__)(Name)
+#else
+#define TRACE_SPAN(Name)
+#endif
@@ -149,7 +149,8 @@ void ev42_Writer::write(FlatbufferMessage const &Message) {
       getFBVectorAsArrayAdapter(EventMsgFlatbuffer->detector_id()));
   if (EventMsgFlatbuffer->time_of_flight()->size() !=
       EventMsgFlatbuffer->detector_id()->size()) {
-    Logger->warn("written data lengths differ");
+    LOG_RATE_LIMITED(Logger, spdlog::level::warn,
+                     "written data lengths differ");
   }
   auto CurrentRefTime = EventMsgFlatbuffer->pulse_time();
   auto CurrentNumberOfEvents = EventMsgFlatbuffer->detector_id()->size();
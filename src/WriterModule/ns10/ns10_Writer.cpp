@@ -79,11 +79,14 @@ void ns10_Writer::write(const FileWriter::FlatbufferMessage &Message) {
     double ConvertedValue = std::stod(Value->str());
     Values.appendElement(ConvertedValue);
   } catch (std::invalid_argument const &Exception) {
-    Logger->error("Could not convert string value to double: '{}'",
-                  Value->str());
+    LOG_RATE_LIMITED(Logger, spdlog::level::err,
+                     "Could not convert string value to double: '{}'",
+                     Value->str());
     throw;
   } catch (std::out_of_range const &Exception) {
-    Logger->error("Converted value too big for result type: {}", Value->str());
+    LOG_RATE_LIMITED(Logger, spdlog::level::err,
+                     "Converted value too big for result type: {}",
+                     Value->str());
     throw;
   }
 
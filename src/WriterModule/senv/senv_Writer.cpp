@@ -88,7 +88,9 @@ void senv_Writer::write(const FileWriter::FlatbufferMessage &Message) {
   auto TempDataPtr = FbPointer->Values()->data();
   auto TempDataSize = FbPointer->Values()->size();
   if (TempDataSize == 0) {
-    Logger->warn("Received a flatbuffer with zero (0) data elements in it.");
+    LOG_RATE_LIMITED(
+        Logger, spdlog::level::warn,
+        "Received a flatbuffer with zero (0) data elements in it.");
     return;
   }
   ArrayAdapter<const std::uint16_t> CArray(TempDataPtr, TempDataSize);
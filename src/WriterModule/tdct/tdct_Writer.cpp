@@ -72,7 +72,8 @@ void tdct_Writer::write(const FileWriter::FlatbufferMessage &Message) {
   auto TempTimePtr = FbPointer->timestamps()->data();
   auto TempTimeSize = FbPointer->timestamps()->size();
   if (TempTimeSize == 0) {
-    Logger->warn(
+    LOG_RATE_LIMITED(
+        Logger, spdlog::level::warn,
         "Received a flatbuffer with zero (0) timestamps elements in it.");
     return;
   }
@@ -9,8 +9,23 @@
 
 #include "WriterModuleBase.h"
 #include "WriterModuleConfig/Field.h"
+#include <fmt/format.h>
 
 void WriterModule::Base::addConfigField(
     WriterModuleConfig::FieldBase *NewField) {
   ConfigFieldProcessor.registerField(NewField);
 }
+
+bool WriterModule::Base::flushDatasets() {
+  if (DatasetsToFlush.empty()) {
+    return false;
+  }
+  for (auto const &Dataset : DatasetsToFlush) {
+    if (H5Dflush(static_cast<hid_t>(Dataset)) < 0) {
+      throw WriterException(
+          fmt::format("Unable to flush the dataset \"{}\".",
+                      std::string(Dataset.link().path())));
+    }
+  }
+  return true;
+}
@@ -12,10 +12,12 @@
 #include "FlatbufferMessage.h"
 #include "WriterModuleConfig/Field.h"
 #include "WriterModuleConfig/FieldHandler.h"
+#include <chrono>
 #include <h5cpp/hdf5.hpp>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace WriterModule {
 
@@ -47,11 +49,19 @@ public:
   /// application right after the constructor has been called.
   /// \param config_stream Configuration from the write file command for this
   /// stream.
-  void parse_config(std::string const &ConfigurationStream) {
+  void parse_config(nlohmann::json const &ConfigurationStream) {
     ConfigFieldProcessor.processConfigData(ConfigurationStream);
     config_post_processing();
   }
 
+  void parse_config(std::string const &ConfigurationStream) {
+    parse_config(nlohmann::json::parse(ConfigurationStream));
+  }
+
+  void parse_config(char const *ConfigurationStream) {
+    parse_config(std::string(ConfigurationStream));
+  }
+
   /// \brief For doing extra processing related to the configuration of the
   /// writer module.
   ///
@@ -95,6 +105,27 @@ public:
 
   void addConfigField(WriterModuleConfig::FieldBase *NewField);
 
+  /// \brief Set the datasets to flush when this writer module has written to
+  /// them.
+  ///
+  /// Called by the application after reopen().
+  void setDatasetsToFlush(std::vector<hdf5::node::Dataset> Datasets) {
+    DatasetsToFlush = std::move(Datasets);
+  }
+
+  /// \brief Flush (H5Dflush) the datasets of this writer module.
+  ///
+  /// \return False if the datasets are not known, in which case the whole
+  /// file has to be flushed instead.
+  bool flushDatasets();
+
+  /// \brief Minimum time between flushes of the datasets of this writer
+  /// module, e.g. longer than the data flush interval for slowly changing
+  /// values. 0 for flushing at every data flush.
+  std::chrono::duration<double> flushInterval() const {
+    return std::chrono::duration<double>(static_cast<double>(FlushInterval));
+  }
+
 private:
   WriterModuleConfig::FieldHandler ConfigFieldProcessor;
 
@@ -103,10 +134,13 @@ protected:
   WriterModuleConfig::Field<std::string> Topic{this, "topic", ""};
   WriterModuleConfig::Field<std::string> WriterModule{this, "writer_module",
                                                       ""};
+  WriterModuleConfig::Field<double> FlushInterval{this, "flush_interval",
+                                                  0.0};
 
 private:
   bool WriteRepeatedTimestamps;
   std::string_view NX_class;
+  std::vector<hdf5::node::Dataset> DatasetsToFlush;
 };
 
 class WriterException : public std::runtime_error {
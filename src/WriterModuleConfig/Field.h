@@ -28,6 +28,7 @@ public:
       : FieldBase(Ptr, std::vector<std::string>{Key}) {}
   virtual ~FieldBase() {}
   virtual void setValue(std::string const &NewValue) = 0;
+  virtual void setValueFromJson(json const &NewValue) = 0;
   [[nodiscard]] bool hasDefaultValue() const { return GotDefault; }
   [[nodiscard]] auto getKeys() const { return FieldKeys; }
   [[nodiscard]] bool isRequried() const { return FieldRequired; }
@@ -54,6 +55,10 @@ public:
     setValueImpl<FieldType>(ValueString);
   }
 
+  void setValueFromJson(json const &NewValue) override {
+    setValueFromJsonImpl<FieldType>(NewValue);
+  }
+
   FieldType getValue() { return FieldValue; };
 
   operator FieldType() const { return FieldValue; }
@@ -80,6 +85,23 @@ private:
       setValueInternal(ValueString);
     }
   }
+
+  template <typename T,
+            std::enable_if_t<!std::is_same_v<std::string, T>, bool> = true>
+  void setValueFromJsonImpl(json const &NewValue) {
+    setValueInternal(NewValue.get<FieldType>());
+  }
+
+  template <typename T,
+            std::enable_if_t<std::is_same_v<std::string, T>, bool> = true>
+  void setValueFromJsonImpl(json const &NewValue) {
+    if (NewValue.is_string()) {
+      setValueInternal(NewValue.get<FieldType>());
+    } else {
+      setValueInternal(NewValue.dump());
+    }
+  }
+
   void setValueInternal(FieldType NewValue) {
     if (not GotDefault) {
       auto Keys = getKeys();
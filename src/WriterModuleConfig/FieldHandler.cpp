@@ -31,8 +31,11 @@ void FieldHandler::registerField(FieldBase *Ptr) {
 }
 
 void FieldHandler::processConfigData(std::string const &ConfigJsonStr) {
-  auto JsonObj = json::parse(ConfigJsonStr);
-  for (auto Iter = JsonObj.begin(); Iter != JsonObj.end(); ++Iter) {
+  processConfigData(json::parse(ConfigJsonStr));
+}
+
+void FieldHandler::processConfigData(json const &ConfigJson) {
+  for (auto Iter = ConfigJson.begin(); Iter != ConfigJson.end(); ++Iter) {
     if (FieldMap.find(Iter.key()) == FieldMap.end()) {
       LOG_ERROR("Writer module config field with name (key) \"{}\" is unknown. "
                 "Is it a typo?",
@@ -40,7 +43,7 @@ void FieldHandler::processConfigData(std::string const &ConfigJsonStr) {
     } else {
       auto CurrentField = FieldMap.find(Iter.key());
       try {
-        CurrentField->second->setValue(Iter.value().dump());
+        CurrentField->second->setValueFromJson(Iter.value());
       } catch (json::type_error &E) {
         LOG_ERROR("Got type error when trying to set writer module config "
                   "field value (with key \"{}\"). The error message was: {}",
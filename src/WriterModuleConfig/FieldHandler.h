@@ -10,6 +10,7 @@
 #pragma once
 
 #include <map>
+#include <nlohmann/json.hpp>
 #include <string>
 
 namespace WriterModuleConfig {
@@ -21,6 +22,7 @@ public:
   FieldHandler() = default;
   void registerField(FieldBase *Ptr);
   void processConfigData(std::string const &ConfigJsonStr);
+  void processConfigData(nlohmann::json const &ConfigJson);
 
 private:
   std::map<std::string, FieldBase *> FieldMap;
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "BenchmarkHelpers.h"
+#include "Filesystem.h"
+#include "WriterRegistrar.h"
+#include <fmt/format.h>
+#include <unistd.h>
+
+namespace Benchmark {
+
+BenchmarkFile::BenchmarkFile(FileLocation Location,
+                             hdf5::property::FileAccessList Fapl) {
+  if (Location == FileLocation::Memory) {
+    Fapl.driver(hdf5::file::MemoryDriver());
+  } else {
+    FilePath = (fs::temp_directory_path() /
+                fmt::format("kafka-to-nexus-benchmark-{}.nxs", getpid()))
+                   .string();
+  }
+  File = hdf5::file::create(FilePath, hdf5::file::AccessFlags::TRUNCATE, {},
+                            Fapl);
+}
+
+BenchmarkFile::~BenchmarkFile() {
+  File.close();
+  if (FilePath != InMemoryFileName) {
+    fs::remove(FilePath);
+  }
+}
+
+WriterModule::ptr createWriter(std::string const &ModuleName,
+                               std::string const &Config,
+                               hdf5::node::Group &Group) {
+  auto Writer = WriterModule::Registry::find(ModuleName).first();
+  Writer->parse_config(Config);
+  if (Writer->init_hdf(Group) != WriterModule::InitResult::OK) {
+    throw std::runtime_error(
+        fmt::format("Unable to initialise {} writer module.", ModuleName));
+  }
+  if (Writer->reopen(Group) != WriterModule::InitResult::OK) {
+    throw std::runtime_error(
+        fmt::format("Unable to re-open {} writer module.", ModuleName));
+  }
+  return Writer;
+}
+
+} // namespace Benchmark
@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#pragma once
+
+#include "WriterModuleBase.h"
+#include <h5cpp/hdf5.hpp>
+#include <string>
+
+namespace Benchmark {
+
+enum class FileLocation { Memory = 0, Disk = 1 };
+
+/// \brief HDF file that is removed (if on disk) when it goes out of scope.
+class BenchmarkFile {
+public:
+  explicit BenchmarkFile(FileLocation Location,
+                         hdf5::property::FileAccessList Fapl = {});
+  ~BenchmarkFile();
+  hdf5::node::Group root() { return File.root(); }
+  void flush() { File.flush(hdf5::file::Scope::GLOBAL); }
+
+private:
+  static constexpr char const *InMemoryFileName{"unused"};
+  std::string FilePath{InMemoryFileName};
+  hdf5::file::File File;
+};
+
+/// \brief Create the writer module the same way as the application does, i.e.
+/// initialise the HDF structure and then re-open the same instance for
+/// writing.
+WriterModule::ptr createWriter(std::string const &ModuleName,
+                               std::string const &Config,
+                               hdf5::node::Group &Group);
+
+} // namespace Benchmark
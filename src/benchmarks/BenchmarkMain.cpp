@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "URI.h"
+#include "logger.h"
+#include <benchmark/benchmark.h>
+
+int main(int argc, char **argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  // Only log errors as logging would otherwise distort the results.
+  std::string ServiceID;
+  std::string LogFile;
+  auto GraylogURI = uri::URI();
+  ::setUpLogging(spdlog::level::err, ServiceID, LogFile, GraylogURI);
+
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+/// \file
+/// \brief Comparison of the file access profiles (see FileAccessProfile) when
+/// writing to an on-disk file.
+///
+/// The first argument of every benchmark selects the profile (0 = default,
+/// 1 = parallel_filesystem, 2 = in_memory). Point TMPDIR at the file system
+/// of interest.
+
+#include "BenchmarkHelpers.h"
+#include "FileAccessProfile.h"
+#include "FlatbufferMessage.h"
+#include "loadgen/SyntheticMessages.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using Benchmark::BenchmarkFile;
+using Benchmark::FileLocation;
+
+std::vector<std::string> const ProfileNames{"default", "parallel_filesystem",
+                                            "in_memory"};
+
+FileWriter::FileAccessProfile getProfile(benchmark::State &State) {
+  auto const &Name = ProfileNames.at(static_cast<size_t>(State.range(0)));
+  State.SetLabel(Name);
+  return FileWriter::getFileAccessProfile(Name);
+}
+
+/// Write event messages and flush the file periodically, as the application
+/// does.
+void ev42WriteWithProfile(benchmark::State &State) {
+  auto Profile = getProfile(State);
+  auto const NrOfEvents = static_cast<size_t>(State.range(1));
+  std::vector<FileWriter::FlatbufferMessage> Messages;
+  for (size_t i = 0; i < 16; ++i) {
+    auto Buffer = SyntheticMessages::createEventMessage(
+        "event_source", i, (i + 1) * 71428571, NrOfEvents);
+    Messages.emplace_back(Buffer.data(), Buffer.size());
+  }
+  BenchmarkFile File(FileLocation::Disk, Profile.createFileAccessList());
+  auto Group = File.root();
+  auto Writer = Benchmark::createWriter("ev42", "{}", Group);
+  size_t MessageIndex{0};
+  size_t BytesWritten{0};
+  for (auto _ : State) {
+    auto const &CurrentMessage = Messages[MessageIndex % Messages.size()];
+    Writer->write(CurrentMessage);
+    BytesWritten += CurrentMessage.size();
+    if (++MessageIndex % 64 == 0) {
+      File.flush();
+    }
+  }
+  State.SetItemsProcessed(State.iterations());
+  State.SetBytesProcessed(BytesWritten);
+}
+BENCHMARK(ev42WriteWithProfile)
+    ->ArgsProduct({{0, 1, 2}, {1000, 100000}})
+    ->Unit(benchmark::kMicrosecond);
+
+/// Create a file with many small groups and datasets, i.e. mostly metadata,
+/// similar to the static part of a NeXus structure.
+void createStructureWithProfile(benchmark::State &State) {
+  auto Profile = getProfile(State);
+  auto const NrOfGroups = static_cast<size_t>(State.range(1));
+  std::vector<double> Values(16, 1.0);
+  for (auto _ : State) {
+    BenchmarkFile File(FileLocation::Disk, Profile.createFileAccessList());
+    auto Root = File.root();
+    for (size_t i = 0; i < NrOfGroups; ++i) {
+      auto Group = Root.create_group(fmt::format("group_{}", i));
+      Group.attributes.create_from("NX_class", std::string("NXcollection"));
+      auto Dataset = Group.create_dataset(
+          "values", hdf5::datatype::create<double>(),
+          hdf5::dataspace::Simple({Values.size()}));
+      Dataset.write(Values);
+    }
+    File.flush();
+  }
+  State.SetItemsProcessed(State.iterations() * NrOfGroups);
+}
+BENCHMARK(createStructureWithProfile)
+    ->ArgsProduct({{0, 1, 2}, {100, 10000}})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
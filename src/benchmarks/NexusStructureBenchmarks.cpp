@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+/// \file
+/// \brief Time to create a file from a NeXus structure with a large detector
+/// geometry (pixel offsets and detector numbers) as given in start commands.
+///
+/// The first argument of the benchmark is the number of pixels.
+
+#include "Filesystem.h"
+#include "HDFFile.h"
+#include "json.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <fmt/format.h>
+#include <unistd.h>
+
+namespace {
+
+nlohmann::json createDataset(std::string const &Name, std::string const &Type,
+                             nlohmann::json Values) {
+  auto const Size = Values.size();
+  return {{"type", "dataset"},
+          {"name", Name},
+          {"dataset", {{"type", Type}, {"size", {Size}}}},
+          {"values", std::move(Values)}};
+}
+
+/// The NeXus structure (as JSON text) of a detector with the given number of
+/// pixels.
+std::string createDetectorStructure(size_t NrOfPixels) {
+  auto XOffsets = nlohmann::json::array();
+  auto YOffsets = nlohmann::json::array();
+  auto DetectorNumbers = nlohmann::json::array();
+  auto const Width = static_cast<size_t>(std::sqrt(NrOfPixels));
+  for (size_t i = 0; i < NrOfPixels; ++i) {
+    XOffsets.push_back(0.001 * static_cast<double>(i % Width));
+    YOffsets.push_back(0.001 * static_cast<double>(i / Width));
+    DetectorNumbers.push_back(i + 1);
+  }
+  nlohmann::json Detector{
+      {"type", "group"},
+      {"name", "detector"},
+      {"attributes", {{"NX_class", "NXdetector"}}},
+      {"children",
+       {createDataset("x_pixel_offset", "double", std::move(XOffsets)),
+        createDataset("y_pixel_offset", "double", std::move(YOffsets)),
+        createDataset("detector_number", "int32",
+                      std::move(DetectorNumbers))}}};
+  nlohmann::json Entry{{"type", "group"},
+                       {"name", "entry"},
+                       {"attributes", {{"NX_class", "NXentry"}}},
+                       {"children", {std::move(Detector)}}};
+  return nlohmann::json{{"children", {std::move(Entry)}}}.dump();
+}
+
+/// Parse the NeXus structure and create the file from it, as is done when
+/// starting a job.
+void createFileWithDetectorGeometry(benchmark::State &State) {
+  auto const NrOfPixels = static_cast<size_t>(State.range(0));
+  auto const NexusStructure = createDetectorStructure(NrOfPixels);
+  auto const FileName =
+      (fs::temp_directory_path() /
+       fmt::format("kafka-to-nexus-benchmark-{}.nxs", getpid()))
+          .string();
+  for (auto _ : State) {
+    {
+      std::vector<FileWriter::StreamHDFInfo> StreamHDFInfo;
+      FileWriter::HDFFile File(FileName, nlohmann::json::parse(NexusStructure),
+                               StreamHDFInfo);
+    }
+    State.PauseTiming();
+    fs::remove(FileName);
+    State.ResumeTiming();
+  }
+  State.SetItemsProcessed(State.iterations() * NrOfPixels);
+  State.SetBytesProcessed(State.iterations() * NexusStructure.size());
+}
+BENCHMARK(createFileWithDetectorGeometry)
+    ->Arg(10000)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,351 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+/// \file
+/// \brief End-to-end throughput of the streaming pipeline (Stream::Topic ->
+/// Partition -> SourceFilter -> MessageWriter -> writer modules) fed by
+/// in-process consumers that return synthetic messages as fast as possible.
+///
+/// The first benchmark argument sets the number of partitions, the second
+/// argument selects the message mix (see createMessageMix()). Besides the
+/// throughput, the mean and max writer queue depth as well as latency
+/// percentiles (in microseconds) of the following stages are reported:
+///  - consume: poll() returns -> message passed to the message writer
+///  - queue: message queued (or spooled) -> writing starts
+///  - write: writing of the message by the writer module
+///  - total: poll() returns -> message written
+/// The poll time is carried by the messages (see MessageMetaData::PollTime),
+/// the queue and write latencies are the ones measured by the MessageWriter.
+
+#include "BenchmarkHelpers.h"
+#include "MemoryAccountant.h"
+#include "Metrics/Histogram.h"
+#include "Source.h"
+#include "Stream/Topic.h"
+#include "loadgen/SyntheticMessages.h"
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include <thread>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+std::int64_t inNanoSeconds(duration Time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Time).count();
+}
+
+duration const WarmUpTime{1s};
+duration const MeasurementTime{5s};
+duration const QueueSampleInterval{10ms};
+size_t const MaxBufferedBytes{512 * 1024 * 1024};
+
+struct SourceSetup {
+  std::string Name;
+  std::string FlatbufferId;
+  std::string Config;
+  /// Messages (with increasing timestamps) that are returned round-robin.
+  std::vector<flatbuffers::DetachedBuffer> Messages;
+};
+
+/// \brief The messages produced for the sources of a message mix.
+///
+/// 0: Events (4 sources with 10k events per pulse).
+/// 1: Slow log data (200 scalar PVs).
+/// 2: Images (1 camera, 1024x1024 pixels).
+/// 3: Mix of 2 event sources, 100 PVs and a 512x512 pixels camera.
+std::vector<SourceSetup> createMessageMix(int MixIndex) {
+  size_t const NrOfDistinctMessages{8};
+  std::uint64_t const StartTime{1600000000000000000};
+  std::vector<SourceSetup> Sources;
+  auto AddEventSources = [&](size_t NrOfSources, size_t NrOfEvents) {
+    for (size_t i = 0; i < NrOfSources; ++i) {
+      SourceSetup Setup{fmt::format("events_{}", i), "ev42", "{}", {}};
+      for (size_t j = 0; j < NrOfDistinctMessages; ++j) {
+        Setup.Messages.emplace_back(SyntheticMessages::createEventMessage(
+            Setup.Name, j, StartTime + j * 71428571, NrOfEvents));
+      }
+      Sources.emplace_back(std::move(Setup));
+    }
+  };
+  auto AddLogSources = [&](size_t NrOfSources) {
+    for (size_t i = 0; i < NrOfSources; ++i) {
+      SourceSetup Setup{fmt::format("pv_{}", i), "f142",
+                        R"({"type": "double"})", {}};
+      for (size_t j = 0; j < NrOfDistinctMessages; ++j) {
+        Setup.Messages.emplace_back(SyntheticMessages::createLogDataMessage(
+            Setup.Name, StartTime + j * 1000000, static_cast<double>(j)));
+      }
+      Sources.emplace_back(std::move(Setup));
+    }
+  };
+  auto AddImageSource = [&](size_t ImageSide) {
+    // The source name of NDAr messages is fixed.
+    SourceSetup Setup{
+        "ADPluginKafka", "NDAr",
+        fmt::format(R"({{"type": "uint16", "array_size": [{}, {}]}})",
+                    ImageSide, ImageSide),
+        {}};
+    for (size_t j = 0; j < NrOfDistinctMessages; ++j) {
+      Setup.Messages.emplace_back(SyntheticMessages::createAreaDetectorMessage(
+          static_cast<int32_t>(j), StartTime + j * 100000000, ImageSide,
+          ImageSide));
+    }
+    Sources.emplace_back(std::move(Setup));
+  };
+  switch (MixIndex) {
+  case 0:
+    AddEventSources(4, 10000);
+    break;
+  case 1:
+    AddLogSources(200);
+    break;
+  case 2:
+    AddImageSource(1024);
+    break;
+  default:
+    AddEventSources(2, 10000);
+    AddLogSources(100);
+    AddImageSource(512);
+    break;
+  }
+  return Sources;
+}
+
+/// \brief Returns the messages of its sources round-robin, as fast as
+/// possible.
+class SyntheticConsumer : public Kafka::ConsumerInterface {
+public:
+  SyntheticConsumer(std::vector<SourceSetup> const &AllSources,
+                    int NrOfPartitions)
+      : Sources(AllSources), Partitions(NrOfPartitions) {}
+  void addTopic(std::string const &) override {}
+  void addPartitionAtOffset(std::string const &, int PartitionId,
+                            int64_t Offset) override {
+    Partition = PartitionId;
+    NextOffset = Offset;
+    // Every source is produced to one partition only.
+    for (size_t i = 0; i < Sources.size(); ++i) {
+      if (static_cast<int>(i % Partitions) == Partition) {
+        UsedSources.push_back(&Sources[i]);
+      }
+    }
+    NextMessage.resize(UsedSources.size(), 0);
+  }
+  std::vector<int32_t> queryTopicPartitions(std::string const &) override {
+    return {};
+  }
+  std::pair<Kafka::PollStatus, FileWriter::Msg> poll() override {
+    if (UsedSources.empty()) {
+      std::this_thread::sleep_for(10ms);
+      return {Kafka::PollStatus::TimedOut, FileWriter::Msg()};
+    }
+    auto const &Buffer =
+        UsedSources[NextSource]->Messages[NextMessage[NextSource]];
+    NextMessage[NextSource] = (NextMessage[NextSource] + 1) %
+                              UsedSources[NextSource]->Messages.size();
+    NextSource = (NextSource + 1) % UsedSources.size();
+    auto const Now = system_clock::now();
+    FileWriter::MessageMetaData MetaData{
+        std::chrono::milliseconds(toMilliSeconds(Now)),
+        RdKafka::MessageTimestamp::MSG_TIMESTAMP_CREATE_TIME, NextOffset++,
+        Partition, Now};
+    FileWriter::Msg Message(Buffer.data(), Buffer.size(), MetaData);
+    return {Kafka::PollStatus::Message, std::move(Message)};
+  }
+
+private:
+  std::vector<SourceSetup> const &Sources;
+  std::vector<SourceSetup const *> UsedSources;
+  std::vector<size_t> NextMessage;
+  size_t NextSource{0};
+  size_t Partitions;
+  int Partition{0};
+  int64_t NextOffset{0};
+};
+
+class SyntheticConsumerFactory : public Kafka::ConsumerFactoryInterface {
+public:
+  SyntheticConsumerFactory(std::vector<SourceSetup> const &AllSources,
+                           int NrOfPartitions)
+      : Sources(AllSources), Partitions(NrOfPartitions) {}
+  std::unique_ptr<Kafka::ConsumerInterface>
+  createConsumer(Kafka::BrokerSettings const &) override {
+    return std::make_unique<SyntheticConsumer>(Sources, Partitions);
+  }
+
+private:
+  std::vector<SourceSetup> const &Sources;
+  int Partitions;
+};
+
+/// \brief Topic with a fixed number of partitions that does not do any
+/// metadata calls.
+class SyntheticTopic : public Stream::Topic {
+public:
+  SyntheticTopic(std::vector<SourceSetup> const &Sources, int NrOfPartitions,
+                 Stream::SrcToDst Map, Stream::MessageWriter *Writer,
+                 Metrics::Registrar &RegisterMetric)
+      : Stream::Topic({}, "synthetic_topic", std::move(Map), Writer,
+                      RegisterMetric, time_point{}, 0s, time_point::max(), 0s,
+                      std::make_unique<SyntheticConsumerFactory>(
+                          Sources, NrOfPartitions)),
+        Partitions(NrOfPartitions) {}
+
+protected:
+  std::vector<std::pair<int, int64_t>>
+  getOffsetForTimeInternal(std::string const &, std::string const &,
+                           std::vector<int> const &PartitionIds, time_point,
+                           duration) const override {
+    std::vector<std::pair<int, int64_t>> PartitionOffsets;
+    for (auto Id : PartitionIds) {
+      PartitionOffsets.emplace_back(Id, 0);
+    }
+    return PartitionOffsets;
+  }
+
+  std::vector<int> getPartitionsForTopicInternal(std::string const &,
+                                                 std::string const &,
+                                                 duration) const override {
+    std::vector<int> PartitionIds(Partitions);
+    std::iota(PartitionIds.begin(), PartitionIds.end(), 0);
+    return PartitionIds;
+  }
+
+  int Partitions;
+};
+
+/// \brief Message writer that records the latency from the poll time of the
+/// messages, around the unmodified queueing and writing.
+class InstrumentedMessageWriter : public Stream::MessageWriter {
+public:
+  using Stream::MessageWriter::BytesWritten;
+  using Stream::MessageWriter::MessageWriter;
+  using Stream::MessageWriter::QueueDepth;
+  using Stream::MessageWriter::QueueLatency;
+  using Stream::MessageWriter::WriteTime;
+
+  void addMessage(Stream::Message const &Msg) override {
+    ConsumeLatencyNs.add(
+        inNanoSeconds(system_clock::now() - Msg.FbMsg.getPollTime()));
+    Stream::MessageWriter::addMessage(Msg);
+  }
+
+  Metrics::Histogram ConsumeLatencyNs{"consume_latency_ns", ""};
+  Metrics::Histogram TotalLatencyNs{"total_latency_ns", ""};
+
+protected:
+  void writeMsgImpl(WriterModule::Base *ModulePtr,
+                    FileWriter::FlatbufferMessage const &Msg) override {
+    Stream::MessageWriter::writeMsgImpl(ModulePtr, Msg);
+    TotalLatencyNs.add(inNanoSeconds(system_clock::now() - Msg.getPollTime()));
+  }
+};
+
+/// \param UnitsPerMicroSecond 1000 for histograms of nanoseconds, 1 for
+/// histograms of microseconds.
+void setLatencyCounters(benchmark::State &State, std::string const &Stage,
+                        Metrics::HistogramSummary const &Latencies,
+                        double UnitsPerMicroSecond) {
+  auto InMicroSeconds = [&](std::int64_t Value) {
+    return double(Value) / UnitsPerMicroSecond;
+  };
+  State.counters[Stage + "_p50_us"] = InMicroSeconds(Latencies.P50);
+  State.counters[Stage + "_p99_us"] = InMicroSeconds(Latencies.P99);
+  State.counters[Stage + "_p999_us"] = InMicroSeconds(Latencies.P999);
+}
+
+void PipelineThroughput(benchmark::State &State) {
+  auto const NrOfPartitions = static_cast<int>(State.range(0));
+  auto const Sources = createMessageMix(static_cast<int>(State.range(1)));
+  auto &Accountant = FileWriter::MemoryAccountant::getInstance();
+  auto const OriginalLimit = Accountant.getLimit();
+  Accountant.setLimit(MaxBufferedBytes);
+
+  for (auto _ : State) {
+    Benchmark::BenchmarkFile File(Benchmark::FileLocation::Memory);
+    Metrics::Registrar Registrar("pipeline_benchmark", {});
+    std::vector<FileWriter::Source> WriterSources;
+    for (auto const &Setup : Sources) {
+      auto Group = File.root().create_group(Setup.Name);
+      WriterSources.emplace_back(
+          Setup.Name, Setup.FlatbufferId, Setup.FlatbufferId,
+          "synthetic_topic",
+          Benchmark::createWriter(Setup.FlatbufferId, Setup.Config, Group));
+    }
+    Stream::SrcToDst Map;
+    for (auto &Src : WriterSources) {
+      Map.push_back({Src.getSrcHash(), Src.getModuleHash(),
+                     Src.getWriterPtr(), Src.sourcename(), Src.flatbufferID(),
+                     Src.writerModuleID(),
+                     Src.getWriterPtr()->acceptsRepeatedTimestamps()});
+    }
+    auto Writer = std::make_unique<InstrumentedMessageWriter>(
+        [&File]() { File.flush(); }, 10s, Registrar);
+    auto CurrentTopic = std::make_unique<SyntheticTopic>(
+        Sources, NrOfPartitions, Map, Writer.get(), Registrar);
+    CurrentTopic->start();
+
+    std::this_thread::sleep_for(WarmUpTime);
+    auto const StartWrites = Writer->nrOfWritesDone();
+    auto const StartBytes = Writer->BytesWritten.value();
+    // Only the latencies of the measurement window are reported, not those
+    // of the warm up or of draining the queue when stopping.
+    auto ConsumeCounts = Writer->ConsumeLatencyNs.getBinCounts();
+    auto QueueCounts = Writer->QueueLatency.getBinCounts();
+    auto WriteCounts = Writer->WriteTime.getBinCounts();
+    auto TotalCounts = Writer->TotalLatencyNs.getBinCounts();
+    auto const StartTime = SteadyClock::now();
+    int64_t QueueDepthSum{0};
+    int64_t QueueDepthMax{0};
+    int64_t NrOfQueueSamples{0};
+    while (SteadyClock::now() - StartTime < MeasurementTime) {
+      std::this_thread::sleep_for(QueueSampleInterval);
+      auto const Depth = Writer->QueueDepth.value();
+      QueueDepthSum += Depth;
+      QueueDepthMax = std::max(QueueDepthMax, Depth);
+      ++NrOfQueueSamples;
+    }
+    auto const Elapsed =
+        std::chrono::duration<double>(SteadyClock::now() - StartTime);
+    auto const Writes = Writer->nrOfWritesDone() - StartWrites;
+    auto const Bytes = Writer->BytesWritten.value() - StartBytes;
+    auto const ConsumeLatencies =
+        Writer->ConsumeLatencyNs.summariseSince(ConsumeCounts);
+    auto const QueueLatencies =
+        Writer->QueueLatency.summariseSince(QueueCounts);
+    auto const WriteLatencies = Writer->WriteTime.summariseSince(WriteCounts);
+    auto const TotalLatencies =
+        Writer->TotalLatencyNs.summariseSince(TotalCounts);
+
+    CurrentTopic->stop();
+    CurrentTopic.reset();
+    Writer->stop();
+
+    State.SetIterationTime(Elapsed.count());
+    State.SetItemsProcessed(Writes);
+    State.SetBytesProcessed(static_cast<int64_t>(Bytes));
+    State.counters["queue_depth_mean"] =
+        double(QueueDepthSum) / double(std::max(NrOfQueueSamples, int64_t(1)));
+    State.counters["queue_depth_max"] = double(QueueDepthMax);
+    State.counters["write_errors"] = double(Writer->nrOfWriteErrors());
+    setLatencyCounters(State, "consume", ConsumeLatencies, 1000.0);
+    setLatencyCounters(State, "queue", QueueLatencies, 1.0);
+    setLatencyCounters(State, "write", WriteLatencies, 1.0);
+    setLatencyCounters(State, "total", TotalLatencies, 1000.0);
+  }
+  Accountant.setLimit(OriginalLimit);
+}
+BENCHMARK(PipelineThroughput)
+    ->ArgsProduct({{1, 4, 8}, {0, 1, 2, 3}})
+    ->Iterations(1)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
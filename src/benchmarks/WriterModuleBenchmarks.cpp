@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+/// \file
+/// \brief Throughput of the writer modules when writing synthetic flatbuffer
+/// messages to an in-memory (HDF5 core driver) or an on-disk file.
+///
+/// The first argument of every benchmark sets the message size, the second
+/// argument selects the file location (0 = memory, 1 = disk).
+
+#include "BenchmarkHelpers.h"
+#include "FlatbufferMessage.h"
+#include "WriterModule/hs00/WriterTyped.h"
+#include "json.h"
+#include "loadgen/SyntheticMessages.h"
+#include <benchmark/benchmark.h>
+#include <numeric>
+
+namespace {
+
+using Benchmark::BenchmarkFile;
+using Benchmark::FileLocation;
+
+/// \brief Write the messages (round robin) for as long as the benchmark runs.
+void writeMessages(benchmark::State &State, std::string const &ModuleName,
+                   std::string const &Config,
+                   std::vector<FileWriter::FlatbufferMessage> const &Messages) {
+  BenchmarkFile File(static_cast<FileLocation>(State.range(1)));
+  auto Group = File.root();
+  auto Writer = Benchmark::createWriter(ModuleName, Config, Group);
+  size_t MessageIndex{0};
+  size_t BytesWritten{0};
+  for (auto _ : State) {
+    auto const &CurrentMessage = Messages[MessageIndex];
+    Writer->write(CurrentMessage);
+    BytesWritten += CurrentMessage.size();
+    MessageIndex = (MessageIndex + 1) % Messages.size();
+  }
+  State.SetItemsProcessed(State.iterations());
+  State.SetBytesProcessed(BytesWritten);
+}
+
+size_t const NrOfDistinctMessages{16};
+
+void ev42Write(benchmark::State &State) {
+  auto const NrOfEvents = static_cast<size_t>(State.range(0));
+  std::vector<FileWriter::FlatbufferMessage> Messages;
+  for (size_t i = 0; i < NrOfDistinctMessages; ++i) {
+    auto Buffer = SyntheticMessages::createEventMessage(
+        "event_source", i, (i + 1) * 71428571, NrOfEvents);
+    Messages.emplace_back(Buffer.data(), Buffer.size());
+  }
+  writeMessages(State, "ev42", "{}", Messages);
+}
+BENCHMARK(ev42Write)
+    ->ArgsProduct({{100, 10000, 1000000}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+void f142WriteScalar(benchmark::State &State) {
+  std::vector<FileWriter::FlatbufferMessage> Messages;
+  for (size_t i = 0; i < NrOfDistinctMessages; ++i) {
+    auto Buffer = SyntheticMessages::createLogDataMessage(
+        "scalar_pv", (i + 1) * 1000000, static_cast<double>(i));
+    Messages.emplace_back(Buffer.data(), Buffer.size());
+  }
+  writeMessages(State, "f142", R"({"type": "double"})", Messages);
+}
+BENCHMARK(f142WriteScalar)->ArgsProduct({{1}, {0, 1}});
+
+void f142WriteArray(benchmark::State &State) {
+  auto const ArraySize = static_cast<size_t>(State.range(0));
+  std::vector<FileWriter::FlatbufferMessage> Messages;
+  for (size_t i = 0; i < NrOfDistinctMessages; ++i) {
+    auto Buffer = SyntheticMessages::createLogDataArrayMessage(
+        "array_pv", (i + 1) * 1000000, ArraySize);
+    Messages.emplace_back(Buffer.data(), Buffer.size());
+  }
+  writeMessages(
+      State, "f142",
+      fmt::format(R"({{"type": "double", "array_size": {}}})", ArraySize),
+      Messages);
+}
+BENCHMARK(f142WriteArray)->ArgsProduct({{16, 1024, 65536}, {0, 1}});
+
+void NDArWrite(benchmark::State &State) {
+  auto const ImageSide = static_cast<size_t>(State.range(0));
+  std::vector<FileWriter::FlatbufferMessage> Messages;
+  for (size_t i = 0; i < NrOfDistinctMessages; ++i) {
+    auto Buffer = SyntheticMessages::createAreaDetectorMessage(
+        static_cast<int32_t>(i), 1600000000000000000 + i * 100000000,
+        ImageSide, ImageSide);
+    Messages.emplace_back(Buffer.data(), Buffer.size());
+  }
+  writeMessages(State, "NDAr",
+                fmt::format(R"({{"type": "uint16", "array_size": [{}, {}]}})",
+                            ImageSide, ImageSide),
+                Messages);
+}
+BENCHMARK(NDArWrite)
+    ->ArgsProduct({{256, 1024, 2048}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+std::string createHistogramConfig(std::vector<uint32_t> const &DimLengths) {
+  nlohmann::json Config{{"data_type", "uint64"},
+                        {"error_type", "double"},
+                        {"edge_type", "double"},
+                        {"shape", nlohmann::json::array()}};
+  for (size_t i = 0; i < DimLengths.size(); ++i) {
+    std::vector<double> Edges(DimLengths[i] + 1);
+    std::iota(Edges.begin(), Edges.end(), 0.0);
+    Config["shape"].push_back({{"size", DimLengths[i]},
+                               {"label", fmt::format("dimension_{}", i)},
+                               {"unit", "mm"},
+                               {"edges", Edges},
+                               {"dataset_name", fmt::format("edges_{}", i)}});
+  }
+  return Config.dump();
+}
+
+/// \brief Create a message with one slice (along the first dimension) of a
+/// histogram.
+flatbuffers::DetachedBuffer
+createHistogramSlice(std::uint64_t Timestamp, uint32_t SliceIndex,
+                     std::vector<uint32_t> const &DimLengths) {
+  namespace hs00 = WriterModule::hs00;
+  flatbuffers::FlatBufferBuilder Builder;
+  std::vector<flatbuffers::Offset<hs00::DimensionMetaData>> DimMetaData;
+  for (auto Length : DimLengths) {
+    std::vector<double> Edges(Length + 1);
+    std::iota(Edges.begin(), Edges.end(), 0.0);
+    auto EdgesOffset = Builder.CreateVector(Edges);
+    hs00::ArrayDoubleBuilder EdgesBuilder(Builder);
+    EdgesBuilder.add_value(EdgesOffset);
+    auto BinBoundaries = EdgesBuilder.Finish().Union();
+    hs00::DimensionMetaDataBuilder DimBuilder(Builder);
+    DimBuilder.add_length(Length);
+    DimBuilder.add_bin_boundaries_type(hs00::Array::ArrayDouble);
+    DimBuilder.add_bin_boundaries(BinBoundaries);
+    DimMetaData.push_back(DimBuilder.Finish());
+  }
+  auto DimMetaDataOffset = Builder.CreateVector(DimMetaData);
+
+  std::vector<uint32_t> SliceShape(DimLengths);
+  SliceShape.at(0) = 1;
+  std::vector<uint32_t> SliceOffset(DimLengths.size(), 0);
+  SliceOffset.at(0) = SliceIndex;
+  auto SliceShapeOffset = Builder.CreateVector(SliceShape);
+  auto SliceOffsetOffset = Builder.CreateVector(SliceOffset);
+  auto const NrOfElements =
+      std::accumulate(SliceShape.begin(), SliceShape.end(), size_t(1),
+                      std::multiplies<>());
+
+  std::uint64_t *Counts{nullptr};
+  auto CountsOffset = Builder.CreateUninitializedVector(NrOfElements, &Counts);
+  for (size_t i = 0; i < NrOfElements; ++i) {
+    Counts[i] = (i * 7 + SliceIndex) % 1000;
+  }
+  hs00::ArrayULongBuilder CountsBuilder(Builder);
+  CountsBuilder.add_value(CountsOffset);
+  auto Data = CountsBuilder.Finish().Union();
+
+  double *Errors{nullptr};
+  auto ErrorsOffset = Builder.CreateUninitializedVector(NrOfElements, &Errors);
+  for (size_t i = 0; i < NrOfElements; ++i) {
+    Errors[i] = 1e-5 * static_cast<double>(i);
+  }
+  hs00::ArrayDoubleBuilder ErrorsBuilder(Builder);
+  ErrorsBuilder.add_value(ErrorsOffset);
+  auto ErrorData = ErrorsBuilder.Finish().Union();
+
+  hs00::EventHistogramBuilder HistogramBuilder(Builder);
+  HistogramBuilder.add_timestamp(Timestamp);
+  HistogramBuilder.add_dim_metadata(DimMetaDataOffset);
+  HistogramBuilder.add_current_shape(SliceShapeOffset);
+  HistogramBuilder.add_offset(SliceOffsetOffset);
+  HistogramBuilder.add_data_type(hs00::Array::ArrayULong);
+  HistogramBuilder.add_data(Data);
+  HistogramBuilder.add_errors_type(hs00::Array::ArrayDouble);
+  HistogramBuilder.add_errors(ErrorData);
+  hs00::FinishEventHistogramBuffer(Builder, HistogramBuilder.Finish());
+  return Builder.Release();
+}
+
+void hs00Write(benchmark::State &State) {
+  auto const SliceSide = static_cast<uint32_t>(State.range(0));
+  std::vector<uint32_t> const DimLengths{4, SliceSide, SliceSide};
+  // Cycle through more histograms than are kept in memory by the writer.
+  size_t const NrOfHistograms{8};
+  std::vector<FileWriter::FlatbufferMessage> Messages;
+  for (size_t i = 0; i < NrOfHistograms; ++i) {
+    for (uint32_t Slice = 0; Slice < DimLengths.at(0); ++Slice) {
+      auto Buffer =
+          createHistogramSlice((i + 1) * 1000000000, Slice, DimLengths);
+      Messages.emplace_back(Buffer.data(), Buffer.size());
+    }
+  }
+  writeMessages(State, "hs00", createHistogramConfig(DimLengths), Messages);
+}
+BENCHMARK(hs00Write)
+    ->ArgsProduct({{32, 256}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
@@ -45,3 +45,10 @@ std::chrono::duration<long long int, std::milli> getCurrentTimeStampMS() {
   return std::chrono::duration_cast<std::chrono::milliseconds>(
       std::chrono::system_clock::now().time_since_epoch());
 }
+
+std::string prefixPath(std::string const &Prefix, std::string const &Name) {
+  if (Prefix.empty()) {
+    return Name;
+  }
+  return Prefix + "/" + Name;
+}
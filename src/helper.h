@@ -20,3 +20,6 @@ std::string getHostName();
 std::string randomHexString(size_t Length);
 
 std::chrono::duration<long long int, std::milli> getCurrentTimeStampMS();
+
+/// \brief Prepend a directory to a file name, unless the directory is empty.
+std::string prefixPath(std::string const &Prefix, std::string const &Name);
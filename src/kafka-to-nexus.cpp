@@ -7,6 +7,7 @@
 //
 // Screaming Udder!                              https://esss.se
 
+#include "BufferPool.h"
 #include "CLIOptions.h"
 #include "CommandListener.h"
 #include "FlatbufferReader.h"
@@ -16,12 +17,14 @@
 #include "Kafka/MetadataException.h"
 #include "MainOpt.h"
 #include "Master.h"
+#include "MemoryAccountant.h"
 #include "Metrics/CarbonSink.h"
 #include "Metrics/LogSink.h"
 #include "Metrics/Registrar.h"
 #include "Metrics/Reporter.h"
 #include "Status/StatusInfo.h"
 #include "Status/StatusReporter.h"
+#include "Tracing.h"
 #include "Version.h"
 #include "WriterRegistrar.h"
 #include "logger.h"
@@ -31,12 +34,24 @@
 
 // These should only be visible in this translation unit
 static std::atomic_bool Running{true};
+static std::atomic_bool WriteTrace{false};
 
 void signal_handler(int Signal) {
   Running = false;
   LOG_DEBUG("Got SIGNAL {}", Signal);
 }
 
+void trace_signal_handler(int) { WriteTrace = true; }
+
+void writeTrace(std::string const &TraceFilename) {
+  try {
+    Tracing::writeChromeTrace(TraceFilename);
+    LOG_INFO("Wrote trace to \"{}\".", TraceFilename);
+  } catch (std::runtime_error const &E) {
+    LOG_ERROR("{}", E.what());
+  }
+}
+
 std::unique_ptr<Status::StatusReporter>
 createStatusReporter(MainOpt const &MainConfig,
                      std::string const &ApplicationName,
@@ -109,6 +124,7 @@ int main(int argc, char **argv) {
   auto Logger = getLogger();
   if (not versionOfHDF5IsOk()) {
     Logger->error("Failed HDF5 version check. Exiting.");
+    spdlog::shutdown();
     return EXIT_FAILURE;
   }
 
@@ -132,15 +148,33 @@ int main(int argc, char **argv) {
   if (not Options->GrafanaCarbonAddress.HostPort.empty()) {
     auto HostName = Options->GrafanaCarbonAddress.Host;
     auto Port = Options->GrafanaCarbonAddress.Port;
+    auto StatisticsPrefix = fmt::format("{}.{}.carbon_reporter",
+                                        ApplicationName, Options->ServiceID);
     MetricsReporters.push_back(std::make_shared<Metrics::Reporter>(
-        std::make_unique<Metrics::CarbonSink>(HostName, Port), 500ms));
+        std::make_unique<Metrics::CarbonSink>(HostName, Port), 500ms,
+        StatisticsPrefix));
   }
 
   Metrics::Registrar MainRegistrar(ApplicationName, MetricsReporters);
   auto UsedRegistrar = MainRegistrar.getNewRegistrar(Options->ServiceID);
+  FileWriter::MemoryAccountant::getInstance().setLimit(
+      Options->MaxBufferedBytes);
+  FileWriter::MemoryAccountant::getInstance().registerMetrics(
+      UsedRegistrar.getNewRegistrar("memory"));
+  FileWriter::BufferPool::getInstance().registerMetrics(
+      UsedRegistrar.getNewRegistrar("buffer_pool"));
 
   std::signal(SIGINT, signal_handler);
   std::signal(SIGTERM, signal_handler);
+  auto const &TraceFilename = Options->TraceFilename;
+  if (not TraceFilename.empty()) {
+    if (Tracing::isEnabled()) {
+      std::signal(SIGUSR1, trace_signal_handler);
+    } else {
+      LOG_WARN("Ignoring --trace-file as tracing is not enabled in this "
+               "build. Re-build with -DENABLE_TRACING=ON.");
+    }
+  }
 
   std::unique_ptr<FileWriter::Master> MasterPtr;
 
@@ -152,7 +186,15 @@ int main(int argc, char **argv) {
         UsedRegistrar);
   };
 
-  bool FindTopicMode{true};
+  auto const IsReplaying =
+      not Options->StreamerConfiguration.ReplayDirectory.empty();
+  bool HasStartedReplayJob{false};
+  bool FindTopicMode{not IsReplaying};
+  if (IsReplaying) {
+    LOG_INFO("Replaying recorded messages from \"{}\".",
+             Options->StreamerConfiguration.ReplayDirectory);
+    MasterPtr = GenerateMaster();
+  }
   duration CMetaDataTimeout{
       Options->StreamerConfiguration.BrokerSettings.MinMetadataTimeout};
   auto CommandTopic = Options->CommandBrokerURI.Topic;
@@ -160,6 +202,9 @@ int main(int argc, char **argv) {
   LOG_DEBUG("Starting run loop.");
   LOG_DEBUG("Retrieving topic names from broker.");
   while (Running) {
+    if (WriteTrace.exchange(false)) {
+      writeTrace(TraceFilename);
+    }
     try {
       if (FindTopicMode) {
         if (tryToFindTopics(CommandTopic, StatusTopic,
@@ -186,6 +231,14 @@ int main(int argc, char **argv) {
         }
       } else {
         MasterPtr->run();
+        if (IsReplaying) {
+          if (MasterPtr->isWriting()) {
+            HasStartedReplayJob = true;
+          } else if (HasStartedReplayJob) {
+            LOG_INFO("Done replaying recorded messages.");
+            break;
+          }
+        }
       }
     } catch (std::system_error const &e) {
       Logger->critical(
@@ -201,7 +254,14 @@ int main(int argc, char **argv) {
       break;
     }
   }
+  // Stop the jobs (which log) before the logger is shut down.
+  MasterPtr.reset();
+  if (Tracing::isEnabled() and not TraceFilename.empty()) {
+    writeTrace(TraceFilename);
+  }
   Logger->debug("Exiting.");
-  Logger->flush();
+  // Unlike flush(), also waits for the queued messages to be written when
+  // logging asynchronously.
+  spdlog::shutdown();
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "LoadGenerator.h"
+#include "SyntheticMessages.h"
+#include "json.h"
+#include <algorithm>
+#include <cmath>
+#include <fmt/format.h>
+
+namespace LoadGen {
+
+namespace {
+std::uint64_t toNanoSeconds(time_point Time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Time.time_since_epoch())
+      .count();
+}
+
+nlohmann::json createStreamGroup(std::string const &Name,
+                                 nlohmann::json Stream) {
+  return {{"type", "group"},
+          {"name", Name},
+          {"children", {{{"type", "stream"}, {"stream", std::move(Stream)}}}}};
+}
+} // namespace
+
+std::string createNexusStructure(LoadSettings const &Settings,
+                                 std::string const &Topic) {
+  auto Groups = nlohmann::json::array();
+  for (int i = 0; i < Settings.EventSources; ++i) {
+    auto SourceName = fmt::format("event_source_{}", i);
+    Groups.push_back(createStreamGroup(
+        SourceName,
+        {{"topic", Topic}, {"source", SourceName}, {"writer_module", "ev42"}}));
+  }
+  for (int i = 0; i < Settings.PVCount; ++i) {
+    auto SourceName = fmt::format("pv_{}", i);
+    Groups.push_back(createStreamGroup(SourceName, {{"topic", Topic},
+                                                    {"source", SourceName},
+                                                    {"writer_module", "f142"},
+                                                    {"dtype", "double"}}));
+  }
+  if (Settings.CameraCount > 0) {
+    // The NDAr messages do not contain a source name, the images of all
+    // cameras end up in the same dataset.
+    auto const ImageSide = Settings.ImageSide;
+    Groups.push_back(createStreamGroup(
+        "camera", {{"topic", Topic},
+                   {"source", "ADPluginKafka"},
+                   {"writer_module", "NDAr"},
+                   {"dtype", "uint16"},
+                   {"array_size", {ImageSide, ImageSide}}}));
+  }
+  nlohmann::json Entry{
+      {"type", "group"},
+      {"name", "entry"},
+      {"children", std::move(Groups)},
+      {"attributes", {{{"name", "NX_class"}, {"values", "NXentry"}}}}};
+  return nlohmann::json{{"children", {std::move(Entry)}}}.dump();
+}
+
+LoadGenerator::LoadGenerator(LoadSettings const &Settings, MessageSink &Sink,
+                             time_point StartTime)
+    : Sink(Sink) {
+  for (int i = 0; i < Settings.EventSources; ++i) {
+    auto SourceName = fmt::format("event_source_{}", i);
+    auto EventsPerPulse = Settings.EventsPerPulse;
+    std::uint64_t MessageId{0};
+    addStream(Settings.PulseRate, StartTime,
+              [=](time_point Now) mutable {
+                send(SourceName, SyntheticMessages::createEventMessage(
+                                     SourceName, MessageId++,
+                                     toNanoSeconds(Now), EventsPerPulse));
+              });
+  }
+  if (Settings.PVCount > 0) {
+    auto PVCount = Settings.PVCount;
+    int PVIndex{0};
+    addStream(Settings.PVRate * PVCount, StartTime,
+              [=](time_point Now) mutable {
+                auto SourceName = fmt::format("pv_{}", PVIndex);
+                auto Reading = std::sin(toNanoSeconds(Now) * 1e-9 + PVIndex);
+                send(SourceName, SyntheticMessages::createLogDataMessage(
+                                     SourceName, toNanoSeconds(Now), Reading));
+                PVIndex = (PVIndex + 1) % PVCount;
+              });
+  }
+  for (int i = 0; i < Settings.CameraCount; ++i) {
+    auto SourceName = fmt::format("camera_{}", i);
+    auto ImageSide = Settings.ImageSide;
+    std::int32_t ImageId{0};
+    addStream(Settings.CameraFrameRate, StartTime,
+              [=](time_point Now) mutable {
+                send(SourceName, SyntheticMessages::createAreaDetectorMessage(
+                                     ImageId++, toNanoSeconds(Now), ImageSide,
+                                     ImageSide));
+              });
+  }
+}
+
+void LoadGenerator::addStream(double Rate, time_point StartTime,
+                              std::function<void(time_point)> Generate) {
+  if (Rate <= 0.0) {
+    return;
+  }
+  auto Period = std::chrono::duration_cast<duration>(
+      std::chrono::duration<double>(1.0 / Rate));
+  Streams.push_back({std::max(Period, duration(1)), StartTime,
+                     std::move(Generate)});
+}
+
+void LoadGenerator::send(std::string const &SourceName,
+                         flatbuffers::DetachedBuffer const &Message) {
+  if (Sink.send(SourceName, Message)) {
+    ++MessagesSent;
+    BytesSent += Message.size();
+  } else {
+    ++SendErrors;
+  }
+}
+
+void LoadGenerator::generate(time_point Now) {
+  auto const MaxLag = std::chrono::seconds(1);
+  for (auto &CurrentStream : Streams) {
+    if (Now - CurrentStream.NextTime > MaxLag) {
+      CurrentStream.NextTime = Now;
+      ++LateCount;
+    }
+    while (CurrentStream.NextTime <= Now) {
+      CurrentStream.Generate(CurrentStream.NextTime);
+      CurrentStream.NextTime += CurrentStream.Period;
+    }
+  }
+}
+
+time_point LoadGenerator::nextTime() const {
+  auto Result = time_point::max();
+  for (auto const &CurrentStream : Streams) {
+    Result = std::min(Result, CurrentStream.NextTime);
+  }
+  return Result;
+}
+
+} // namespace LoadGen
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#pragma once
+
+#include "MessageSink.h"
+#include "TimeUtility.h"
+#include <functional>
+#include <vector>
+
+namespace LoadGen {
+
+struct LoadSettings {
+  int EventSources{1};
+  size_t EventsPerPulse{10000};
+  double PulseRate{14.0};
+  int PVCount{1000};
+  double PVRate{1.0};
+  int CameraCount{0};
+  double CameraFrameRate{10.0};
+  size_t ImageSide{1024};
+};
+
+/// \brief Create a NeXus structure (for the run start command) that writes
+/// all sources of the given settings.
+std::string createNexusStructure(LoadSettings const &Settings,
+                                 std::string const &Topic);
+
+/// \brief Generates messages that simulate the load of an instrument.
+///
+/// Every source publishes messages at a fixed rate. All f142 sources are
+/// combined into one stream to avoid having thousands of (slow) timers.
+class LoadGenerator {
+public:
+  LoadGenerator(LoadSettings const &Settings, MessageSink &Sink,
+                time_point StartTime);
+
+  /// \brief Publish all messages that are due at the given time.
+  void generate(time_point Now);
+
+  /// \brief Time when the next message is due.
+  time_point nextTime() const;
+
+  size_t messagesSent() const { return MessagesSent; }
+  size_t bytesSent() const { return BytesSent; }
+  size_t sendErrors() const { return SendErrors; }
+
+  /// \brief Number of times the generator was too slow to keep up and had to
+  /// skip messages.
+  size_t lateCount() const { return LateCount; }
+
+private:
+  struct Stream {
+    duration Period;
+    time_point NextTime;
+    std::function<void(time_point)> Generate;
+  };
+  void addStream(double Rate, time_point StartTime,
+                 std::function<void(time_point)> Generate);
+  void send(std::string const &SourceName,
+            flatbuffers::DetachedBuffer const &Message);
+  MessageSink &Sink;
+  std::vector<Stream> Streams;
+  size_t MessagesSent{0};
+  size_t BytesSent{0};
+  size_t SendErrors{0};
+  size_t LateCount{0};
+};
+
+} // namespace LoadGen
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "MessageSink.h"
+#include "Msg.h"
+#include "TimeUtility.h"
+#include <functional>
+
+namespace LoadGen {
+
+KafkaSink::KafkaSink(Kafka::BrokerSettings Settings, std::string const &Topic,
+                     std::string const &CommandTopic)
+    : ProducerSettings(std::move(Settings)),
+      Producer(std::make_shared<Kafka::Producer>(ProducerSettings)),
+      Topic(std::make_unique<Kafka::ProducerTopic>(Producer, Topic)),
+      CommandTopic(
+          std::make_unique<Kafka::ProducerTopic>(Producer, CommandTopic)) {}
+
+bool KafkaSink::send(std::string const &SourceName,
+                     flatbuffers::DetachedBuffer const &Message) {
+  return Topic->produce(Message, SourceName) == 0;
+}
+
+bool KafkaSink::sendCommand(flatbuffers::DetachedBuffer const &Message) {
+  return CommandTopic->produce(Message) == 0;
+}
+
+void KafkaSink::poll() { Producer->poll(); }
+
+RecordingSink::RecordingSink(std::string const &RecordDirectory,
+                             std::string const &Topic,
+                             std::string const &CommandTopic,
+                             int NrOfPartitions)
+    : Recorder(RecordDirectory, Topic),
+      CommandRecorder(RecordDirectory, CommandTopic),
+      Partitions(NrOfPartitions) {}
+
+bool RecordingSink::send(std::string const &SourceName,
+                         flatbuffers::DetachedBuffer const &Message) {
+  auto const Partition =
+      static_cast<int>(std::hash<std::string>{}(SourceName) % Partitions);
+  record(Recorder, Partition, NextOffset[Partition]++, Message);
+  return true;
+}
+
+bool RecordingSink::sendCommand(flatbuffers::DetachedBuffer const &Message) {
+  record(CommandRecorder, 0, NextCommandOffset++, Message);
+  return true;
+}
+
+void RecordingSink::record(Kafka::MessageRecorder &UsedRecorder, int Partition,
+                           int64_t Offset,
+                           flatbuffers::DetachedBuffer const &Message) {
+  FileWriter::MessageMetaData MetaData{
+      std::chrono::milliseconds(toMilliSeconds(system_clock::now())),
+      RdKafka::MessageTimestamp::MSG_TIMESTAMP_CREATE_TIME, Offset, Partition};
+  UsedRecorder.record(
+      FileWriter::Msg(Message.data(), Message.size(), MetaData));
+}
+
+} // namespace LoadGen
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#pragma once
+
+#include "Kafka/BrokerSettings.h"
+#include "Kafka/Producer.h"
+#include "Kafka/ProducerTopic.h"
+#include "Kafka/RecordingConsumer.h"
+#include <flatbuffers/flatbuffers.h>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace LoadGen {
+
+/// \brief Destination of the generated messages.
+class MessageSink {
+public:
+  virtual ~MessageSink() = default;
+
+  /// \brief Publish a message.
+  ///
+  /// \param SourceName Used for distributing messages over partitions.
+  /// \return true if the message was published.
+  virtual bool send(std::string const &SourceName,
+                    flatbuffers::DetachedBuffer const &Message) = 0;
+
+  /// \brief Publish a (run start or stop) command for the file-writer.
+  ///
+  /// \return true if the command was published.
+  virtual bool sendCommand(flatbuffers::DetachedBuffer const &Message) = 0;
+
+  /// \brief Called periodically to allow the sink to do house keeping.
+  virtual void poll(){};
+};
+
+/// \brief Publishes messages to a Kafka topic.
+class KafkaSink : public MessageSink {
+public:
+  KafkaSink(Kafka::BrokerSettings Settings, std::string const &Topic,
+            std::string const &CommandTopic);
+  /// The source name is used as the key of the message.
+  bool send(std::string const &SourceName,
+            flatbuffers::DetachedBuffer const &Message) override;
+  bool sendCommand(flatbuffers::DetachedBuffer const &Message) override;
+  void poll() override;
+
+private:
+  Kafka::BrokerSettings ProducerSettings;
+  std::shared_ptr<Kafka::Producer> Producer;
+  std::unique_ptr<Kafka::ProducerTopic> Topic;
+  std::unique_ptr<Kafka::ProducerTopic> CommandTopic;
+};
+
+/// \brief Records messages in the format read by the file-writer when using
+/// `--replay`.
+///
+/// Commands are recorded in (the single partition of) the command topic.
+class RecordingSink : public MessageSink {
+public:
+  RecordingSink(std::string const &RecordDirectory, std::string const &Topic,
+                std::string const &CommandTopic, int NrOfPartitions);
+  bool send(std::string const &SourceName,
+            flatbuffers::DetachedBuffer const &Message) override;
+  bool sendCommand(flatbuffers::DetachedBuffer const &Message) override;
+
+private:
+  void record(Kafka::MessageRecorder &UsedRecorder, int Partition,
+              int64_t Offset, flatbuffers::DetachedBuffer const &Message);
+  Kafka::MessageRecorder Recorder;
+  Kafka::MessageRecorder CommandRecorder;
+  int Partitions;
+  std::map<int, int64_t> NextOffset;
+  int64_t NextCommandOffset{0};
+};
+
+} // namespace LoadGen
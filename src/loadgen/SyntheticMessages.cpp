@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "SyntheticMessages.h"
+#include <6s4t_run_stop_generated.h>
+#include <NDAr_NDArray_schema_generated.h>
+#include <ev42_events_generated.h>
+#include <cstring>
+#include <f142_logdata_generated.h>
+#include <pl72_run_start_generated.h>
+#include <vector>
+
+namespace SyntheticMessages {
+
+flatbuffers::DetachedBuffer createEventMessage(std::string const &SourceName,
+                                               std::uint64_t MessageId,
+                                               std::uint64_t PulseTime,
+                                               size_t NrOfEvents) {
+  flatbuffers::FlatBufferBuilder Builder(NrOfEvents * 2 * sizeof(uint32_t) +
+                                         1024);
+  std::uint32_t *TimeOfFlight{nullptr};
+  std::uint32_t *DetectorId{nullptr};
+  auto SourceNameOffset = Builder.CreateString(SourceName);
+  auto TimeOfFlightOffset =
+      Builder.CreateUninitializedVector(NrOfEvents, &TimeOfFlight);
+  for (size_t i = 0; i < NrOfEvents; ++i) {
+    // Roughly uniformly distributed over a 71 ms (14 Hz) frame.
+    TimeOfFlight[i] = static_cast<std::uint32_t>((i * 7919) % 71000000);
+  }
+  auto DetectorIdOffset =
+      Builder.CreateUninitializedVector(NrOfEvents, &DetectorId);
+  for (size_t i = 0; i < NrOfEvents; ++i) {
+    DetectorId[i] = static_cast<std::uint32_t>((i * 104729) % 1000000);
+  }
+  EventMessageBuilder MessageBuilder(Builder);
+  MessageBuilder.add_source_name(SourceNameOffset);
+  MessageBuilder.add_message_id(MessageId);
+  MessageBuilder.add_pulse_time(PulseTime);
+  MessageBuilder.add_time_of_flight(TimeOfFlightOffset);
+  MessageBuilder.add_detector_id(DetectorIdOffset);
+  Builder.Finish(MessageBuilder.Finish(), EventMessageIdentifier());
+  return Builder.Release();
+}
+
+namespace {
+template <class ValueFuncType>
+flatbuffers::DetachedBuffer createLogData(std::string const &SourceName,
+                                          std::uint64_t Timestamp,
+                                          Value ValueType,
+                                          ValueFuncType ValueFunc) {
+  flatbuffers::FlatBufferBuilder Builder;
+  auto SourceNameOffset = Builder.CreateString(SourceName);
+  auto ValueOffset = ValueFunc(Builder);
+  LogDataBuilder MessageBuilder(Builder);
+  MessageBuilder.add_source_name(SourceNameOffset);
+  MessageBuilder.add_value_type(ValueType);
+  MessageBuilder.add_value(ValueOffset);
+  MessageBuilder.add_timestamp(Timestamp);
+  FinishLogDataBuffer(Builder, MessageBuilder.Finish());
+  return Builder.Release();
+}
+} // namespace
+
+flatbuffers::DetachedBuffer createLogDataMessage(std::string const &SourceName,
+                                                 std::uint64_t Timestamp,
+                                                 double Reading) {
+  return createLogData(SourceName, Timestamp, Value::Double,
+                       [Reading](auto &Builder) {
+                         DoubleBuilder ValueBuilder(Builder);
+                         ValueBuilder.add_value(Reading);
+                         return ValueBuilder.Finish().Union();
+                       });
+}
+
+flatbuffers::DetachedBuffer
+createLogDataArrayMessage(std::string const &SourceName,
+                          std::uint64_t Timestamp, size_t NrOfElements) {
+  return createLogData(
+      SourceName, Timestamp, Value::ArrayDouble,
+      [NrOfElements](auto &Builder) {
+        double *Elements{nullptr};
+        auto ElementsOffset =
+            Builder.CreateUninitializedVector(NrOfElements, &Elements);
+        for (size_t i = 0; i < NrOfElements; ++i) {
+          Elements[i] = static_cast<double>(i) * 0.5;
+        }
+        ArrayDoubleBuilder ValueBuilder(Builder);
+        ValueBuilder.add_value(ElementsOffset);
+        return ValueBuilder.Finish().Union();
+      });
+}
+
+flatbuffers::DetachedBuffer createAreaDetectorMessage(std::int32_t Id,
+                                                      std::uint64_t Timestamp,
+                                                      size_t Width,
+                                                      size_t Height) {
+  // NDAr time stamps are relative to the EPICS epoch.
+  std::uint64_t const TimeDiffUNIXtoEPICSepoch{631152000};
+  std::uint64_t const NSecMultiplier{1000000000};
+  auto const NrOfPixels = Width * Height;
+  flatbuffers::FlatBufferBuilder Builder(NrOfPixels * sizeof(std::uint16_t) +
+                                         1024);
+  auto DimsOffset =
+      Builder.CreateVector(std::vector<std::uint64_t>{Height, Width});
+  std::uint8_t *PixelData{nullptr};
+  auto PixelDataOffset = Builder.CreateUninitializedVector(
+      NrOfPixels * sizeof(std::uint16_t), &PixelData);
+  for (size_t i = 0; i < NrOfPixels; ++i) {
+    auto PixelValue = static_cast<std::uint16_t>((i * 31 + Id) % 4096);
+    std::memcpy(PixelData + i * sizeof(PixelValue), &PixelValue,
+                sizeof(PixelValue));
+  }
+  FB_Tables::epicsTimeStamp EpicsTimestamp(
+      static_cast<std::int32_t>(Timestamp / NSecMultiplier -
+                                TimeDiffUNIXtoEPICSepoch),
+      static_cast<std::int32_t>(Timestamp % NSecMultiplier));
+  FB_Tables::NDArrayBuilder MessageBuilder(Builder);
+  MessageBuilder.add_id(Id);
+  MessageBuilder.add_timeStamp(static_cast<double>(Timestamp) * 1e-9);
+  MessageBuilder.add_epicsTS(&EpicsTimestamp);
+  MessageBuilder.add_dims(DimsOffset);
+  MessageBuilder.add_dataType(FB_Tables::DType::Uint16);
+  MessageBuilder.add_pData(PixelDataOffset);
+  FB_Tables::FinishNDArrayBuffer(Builder, MessageBuilder.Finish());
+  return Builder.Release();
+}
+
+flatbuffers::DetachedBuffer createRunStartMessage(
+    std::string const &JobID, std::string const &Filename,
+    std::string const &NexusStructure, std::string const &Broker,
+    std::uint64_t StartTime, std::uint64_t StopTime) {
+  flatbuffers::FlatBufferBuilder Builder(NexusStructure.size() + 1024);
+  auto JobIDOffset = Builder.CreateString(JobID);
+  auto FilenameOffset = Builder.CreateString(Filename);
+  auto NexusStructureOffset = Builder.CreateString(NexusStructure);
+  auto BrokerOffset = Builder.CreateString(Broker);
+  RunStartBuilder MessageBuilder(Builder);
+  MessageBuilder.add_start_time(StartTime);
+  MessageBuilder.add_stop_time(StopTime);
+  MessageBuilder.add_job_id(JobIDOffset);
+  MessageBuilder.add_filename(FilenameOffset);
+  MessageBuilder.add_nexus_structure(NexusStructureOffset);
+  MessageBuilder.add_broker(BrokerOffset);
+  FinishRunStartBuffer(Builder, MessageBuilder.Finish());
+  return Builder.Release();
+}
+
+flatbuffers::DetachedBuffer createRunStopMessage(std::string const &JobID,
+                                                 std::uint64_t StopTime) {
+  flatbuffers::FlatBufferBuilder Builder;
+  auto JobIDOffset = Builder.CreateString(JobID);
+  RunStopBuilder MessageBuilder(Builder);
+  MessageBuilder.add_stop_time(StopTime);
+  MessageBuilder.add_job_id(JobIDOffset);
+  FinishRunStopBuffer(Builder, MessageBuilder.Finish());
+  return Builder.Release();
+}
+
+} // namespace SyntheticMessages
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+/// \file
+/// \brief Generators of synthetic (but realistically sized) flatbuffer
+/// messages for benchmarking and load generation.
+
+#pragma once
+
+#include <cstdint>
+#include <flatbuffers/flatbuffers.h>
+#include <string>
+
+namespace SyntheticMessages {
+
+/// \brief Create an ev42 event message.
+///
+/// \param NrOfEvents Number of events (time of flight and detector id pairs)
+/// in the message.
+flatbuffers::DetachedBuffer createEventMessage(std::string const &SourceName,
+                                               std::uint64_t MessageId,
+                                               std::uint64_t PulseTime,
+                                               size_t NrOfEvents);
+
+/// \brief Create an f142 log data message with a scalar (double) value.
+flatbuffers::DetachedBuffer createLogDataMessage(std::string const &SourceName,
+                                                 std::uint64_t Timestamp,
+                                                 double Reading);
+
+/// \brief Create an f142 log data message with an array (double) value.
+flatbuffers::DetachedBuffer
+createLogDataArrayMessage(std::string const &SourceName,
+                          std::uint64_t Timestamp, size_t NrOfElements);
+
+/// \brief Create an NDAr area detector message with a 16 bit image.
+///
+/// \param Timestamp Time of the image in ns since the UNIX epoch.
+flatbuffers::DetachedBuffer createAreaDetectorMessage(std::int32_t Id,
+                                                      std::uint64_t Timestamp,
+                                                      size_t Width,
+                                                      size_t Height);
+
+/// \brief Create a pl72 run start command.
+///
+/// \param StartTime Start time in ms since the UNIX epoch.
+/// \param StopTime Stop time in ms since the UNIX epoch, 0 if not known.
+flatbuffers::DetachedBuffer createRunStartMessage(
+    std::string const &JobID, std::string const &Filename,
+    std::string const &NexusStructure, std::string const &Broker,
+    std::uint64_t StartTime, std::uint64_t StopTime = 0);
+
+/// \brief Create a 6s4t run stop command.
+///
+/// \param StopTime Stop time in ms since the UNIX epoch.
+flatbuffers::DetachedBuffer createRunStopMessage(std::string const &JobID,
+                                                 std::uint64_t StopTime);
+
+} // namespace SyntheticMessages
@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+/// \file
+/// \brief Publishes synthetic ev42, f142 and NDAr messages at configurable
+/// rates for load testing the file-writer.
+
+#include "LoadGenerator.h"
+#include "MessageSink.h"
+#include "SyntheticMessages.h"
+#include "URI.h"
+#include "logger.h"
+#include <CLI/CLI.hpp>
+#include <atomic>
+#include <csignal>
+#include <thread>
+
+// These should only be visible in this translation unit
+static std::atomic_bool Running{true};
+
+void signal_handler(int Signal) {
+  Running = false;
+  LOG_DEBUG("Got SIGNAL {}", Signal);
+}
+
+int main(int argc, char **argv) {
+  CLI::App App{"Generates synthetic instrument data (ev42, f142 and NDAr "
+               "messages) for load testing kafka-to-nexus."};
+  LoadGen::LoadSettings Settings;
+  std::string BrokerURIString;
+  std::string RecordDirectory;
+  std::string Topic{"loadgen_data"};
+  std::string CommandTopic;
+  std::string Filename{"loadgen.nxs"};
+  int Partitions{1};
+  int DurationSeconds{0};
+  auto BrokerOption = App.add_option(
+      "--broker", BrokerURIString,
+      "Publish to this broker and topic (e.g. \"localhost:9092/topic\")");
+  auto RecordOption = App.add_option(
+      "--record", RecordDirectory,
+      "Write the messages to this directory in the format used by the "
+      "file-writer --replay option");
+  BrokerOption->excludes(RecordOption);
+  App.add_option("--topic", Topic, "Topic name when using --record", true);
+  App.add_option(
+      "--command-topic", CommandTopic,
+      "Publish run start and stop commands for writing the generated data to "
+      "this topic. The commands are always recorded when using --record "
+      "(default topic \"kafka-to-nexus.command\")");
+  App.add_option("--filename", Filename,
+                 "File name in the run start command", true);
+  App.add_option("--partitions", Partitions,
+                 "Number of partitions when using --record", true)
+      ->check(CLI::Range(1, 1024));
+  App.add_option("--event-sources", Settings.EventSources,
+                 "Number of ev42 sources", true);
+  App.add_option("--events-per-pulse", Settings.EventsPerPulse,
+                 "Number of events in every ev42 message", true);
+  App.add_option("--pulse-rate", Settings.PulseRate,
+                 "Rate (Hz) of ev42 messages per source", true);
+  App.add_option("--pv-count", Settings.PVCount, "Number of f142 sources",
+                 true);
+  App.add_option("--pv-rate", Settings.PVRate,
+                 "Rate (Hz) of f142 messages per source", true);
+  App.add_option("--camera-count", Settings.CameraCount,
+                 "Number of NDAr sources", true);
+  App.add_option("--camera-fps", Settings.CameraFrameRate,
+                 "Frame rate (Hz) of every NDAr source", true);
+  App.add_option("--image-size", Settings.ImageSide,
+                 "Width and height of the (16 bit) NDAr images", true);
+  App.add_option("--duration", DurationSeconds,
+                 "Run time in seconds (0 means until interrupted)", true);
+  CLI11_PARSE(App, argc, argv);
+  setUpLogging(spdlog::level::info, "", "", uri::URI());
+
+  std::unique_ptr<LoadGen::MessageSink> Sink;
+  auto const SendCommands =
+      not RecordDirectory.empty() or not CommandTopic.empty();
+  if (CommandTopic.empty()) {
+    CommandTopic = "kafka-to-nexus.command";
+  }
+  // Required in the run start command, not used when replaying.
+  std::string Broker{"localhost:9092"};
+  try {
+    if (not RecordDirectory.empty()) {
+      LOG_INFO("Recording messages to \"{}\".", RecordDirectory);
+      Sink = std::make_unique<LoadGen::RecordingSink>(
+          RecordDirectory, Topic, CommandTopic, Partitions);
+    } else if (not BrokerURIString.empty()) {
+      uri::URI BrokerURI(BrokerURIString);
+      Kafka::BrokerSettings BrokerSettings;
+      BrokerSettings.Address = BrokerURI.HostPort;
+      Broker = BrokerURI.HostPort;
+      Topic = BrokerURI.Topic;
+      LOG_INFO("Publishing messages to topic \"{}\" on broker \"{}\".",
+               BrokerURI.Topic, BrokerURI.HostPort);
+      Sink = std::make_unique<LoadGen::KafkaSink>(
+          BrokerSettings, BrokerURI.Topic, CommandTopic);
+    } else {
+      fmt::print("Either --broker or --record must be given.\n");
+      return EXIT_FAILURE;
+    }
+  } catch (std::exception &E) {
+    LOG_CRITICAL("Unable to set up the message sink: {}", E.what());
+    return EXIT_FAILURE;
+  }
+
+  std::signal(SIGINT, signal_handler);
+  std::signal(SIGTERM, signal_handler);
+
+  auto const StartTime = system_clock::now();
+  auto const StopTime = DurationSeconds > 0
+                            ? StartTime + std::chrono::seconds(DurationSeconds)
+                            : time_point::max();
+  auto const JobID = fmt::format("loadgen-{}", toMilliSeconds(StartTime));
+  if (SendCommands) {
+    LOG_INFO("Sending run start command for job \"{}\" to topic \"{}\".",
+             JobID, CommandTopic);
+    auto StartCommand = SyntheticMessages::createRunStartMessage(
+        JobID, Filename, LoadGen::createNexusStructure(Settings, Topic),
+        Broker, toMilliSeconds(StartTime));
+    if (not Sink->sendCommand(StartCommand)) {
+      LOG_CRITICAL("Unable to send the run start command.");
+      return EXIT_FAILURE;
+    }
+  }
+  LoadGen::LoadGenerator Generator(Settings, *Sink, StartTime);
+  auto const ReportInterval = std::chrono::seconds(1);
+  auto const MaxSleepTime = std::chrono::milliseconds(100);
+  auto NextReportTime = StartTime + ReportInterval;
+  size_t LastMessages{0};
+  size_t LastBytes{0};
+  auto LastGenerateTime = StartTime;
+  while (Running) {
+    auto Now = system_clock::now();
+    if (Now >= StopTime) {
+      break;
+    }
+    Generator.generate(Now);
+    LastGenerateTime = Now;
+    Sink->poll();
+    if (Now >= NextReportTime) {
+      LOG_INFO("{} msgs/s, {:.1f} MB/s ({} messages, {} send errors, {} "
+               "times behind schedule)",
+               Generator.messagesSent() - LastMessages,
+               (Generator.bytesSent() - LastBytes) / 1e6,
+               Generator.messagesSent(), Generator.sendErrors(),
+               Generator.lateCount());
+      LastMessages = Generator.messagesSent();
+      LastBytes = Generator.bytesSent();
+      NextReportTime += ReportInterval;
+    }
+    auto WakeUpTime =
+        std::min({Generator.nextTime(), NextReportTime, Now + MaxSleepTime});
+    std::this_thread::sleep_until(WakeUpTime);
+  }
+  if (SendCommands) {
+    auto StopCommand = SyntheticMessages::createRunStopMessage(
+        JobID, toMilliSeconds(LastGenerateTime));
+    if (not Sink->sendCommand(StopCommand)) {
+      LOG_ERROR("Unable to send the run stop command.");
+    }
+    Sink->poll();
+  }
+  LOG_INFO("Sent {} messages ({:.1f} MB) in total.", Generator.messagesSent(),
+           Generator.bytesSent() / 1e6);
+  return EXIT_SUCCESS;
+}
@@ -9,6 +9,7 @@
 
 #include "logger.h"
 #include "URI.h"
+#include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <string>
@@ -17,11 +18,16 @@
 #include <spdlog/sinks/graylog_sink.h>
 #endif
 
+namespace {
+/// Number of messages that can be queued up for the logging thread.
+size_t const AsyncQueueSize{8192};
+} // namespace
+
 SharedLogger getLogger() { return spdlog::get("filewriterlogger"); }
 
 void setUpLogging(const spdlog::level::level_enum &LoggingLevel,
                   const std::string & /*ServiceID*/, const std::string &LogFile,
-                  const uri::URI &GraylogURI) {
+                  const uri::URI &GraylogURI, bool Async) {
   std::vector<spdlog::sink_ptr> sinks;
   if (!LogFile.empty()) {
     auto FileSink =
@@ -47,8 +53,16 @@ void setUpLogging(const spdlog::level::level_enum &LoggingLevel,
   auto ConsoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
   ConsoleSink->set_pattern("[%H:%M:%S.%f] [%l] [processID: %P]: %v");
   sinks.push_back(ConsoleSink);
-  auto combined_logger = std::make_shared<spdlog::logger>(
-      "filewriterlogger", cbegin(sinks), cend(sinks));
+  SharedLogger combined_logger;
+  if (Async) {
+    spdlog::init_thread_pool(AsyncQueueSize, 1);
+    combined_logger = std::make_shared<spdlog::async_logger>(
+        "filewriterlogger", cbegin(sinks), cend(sinks), spdlog::thread_pool(),
+        spdlog::async_overflow_policy::overrun_oldest);
+  } else {
+    combined_logger = std::make_shared<spdlog::logger>(
+        "filewriterlogger", cbegin(sinks), cend(sinks));
+  }
   spdlog::register_logger(combined_logger);
   combined_logger->set_level(LoggingLevel);
   combined_logger->flush_on(spdlog::level::err);
@@ -9,7 +9,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <numeric>
+#include <optional>
 #include <spdlog/spdlog.h>
 #include <string>
 #include <vector>
@@ -52,9 +55,14 @@ using SharedLogger = std::shared_ptr<spdlog::logger>;
 
 SharedLogger getLogger();
 
+/// \brief Set up the application logger.
+///
+/// \param Async If true, messages are passed to the sinks by a background
+/// thread. The oldest messages are dropped if the queue of that thread is
+/// full, so that the caller never blocks on a slow sink.
 void setUpLogging(const spdlog::level::level_enum &LoggingLevel,
                   const std::string &ServiceID, const std::string &LogFile,
-                  const uri::URI &GraylogURI);
+                  const uri::URI &GraylogURI, bool Async = false);
 
 template <typename... Args>
 void LOG_ERROR(spdlog::string_view_t fmt, const Args &... args) {
@@ -79,3 +87,63 @@ void LOG_DEBUG(spdlog::string_view_t fmt, const Args &... args) {
   getLogger()->log(spdlog::source_loc{}, spdlog::level::level_enum::debug, fmt,
                    args...);
 }
+
+/// \brief Decides which messages of a repeated log message to emit.
+///
+/// The first FirstN messages are logged, after that only one in every OneInM.
+class LogRateLimiter {
+public:
+  LogRateLimiter(std::uint64_t FirstN, std::uint64_t OneInM)
+      : FirstN(FirstN), OneInM(OneInM > 0 ? OneInM : 1) {}
+
+  /// \brief Count a message.
+  ///
+  /// \return The number of messages suppressed since the previous logged
+  /// message if this message should be logged, otherwise nothing.
+  std::optional<std::uint64_t> next() {
+    auto const MessageNr = Count.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (MessageNr <= FirstN) {
+      return 0;
+    }
+    if ((MessageNr - FirstN) % OneInM == 0) {
+      return OneInM - 1;
+    }
+    return {};
+  }
+
+private:
+  std::uint64_t const FirstN;
+  std::uint64_t const OneInM;
+  std::atomic<std::uint64_t> Count{0};
+};
+
+template <typename... Args>
+void logRateLimited(spdlog::logger &Logger, LogRateLimiter &Limiter,
+                    spdlog::level::level_enum Level, spdlog::string_view_t fmt,
+                    const Args &... args) {
+  if (not Logger.should_log(Level)) {
+    return;
+  }
+  auto const Suppressed = Limiter.next();
+  if (not Suppressed) {
+    return;
+  }
+  if (*Suppressed == 0) {
+    Logger.log(spdlog::source_loc{}, Level, fmt, args...);
+    return;
+  }
+  Logger.log(spdlog::source_loc{}, Level,
+             "{} ({} similar messages were suppressed)",
+             fmt::vformat(fmt, fmt::make_format_args(args...)), *Suppressed);
+}
+
+/// \brief Log at most the first 10 and then one in 1000 of the messages from
+/// this line.
+///
+/// Use for messages that can be triggered for every (Kafka) message on the
+/// consumer and writer threads.
+#define LOG_RATE_LIMITED(Logger, Level, ...)                                   \
+  do {                                                                         \
+    static LogRateLimiter RateLimiterOfThisLine{10, 1000};                     \
+    logRateLimited(*(Logger), RateLimiterOfThisLine, Level, __VA_ARGS__);      \
+  } while (false)
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "BufferPool.h"
+#include "MemoryAccountant.h"
+#include "Msg.h"
+#include <gtest/gtest.h>
+
+using FileWriter::BufferPool;
+
+TEST(BufferPoolTest, SizeClassFitsRequestedSize) {
+  EXPECT_EQ(BufferPool::getSizeClass(0), 0u);
+  EXPECT_EQ(BufferPool::getSizeClass(64), 0u);
+  EXPECT_EQ(BufferPool::getSizeClass(65), 1u);
+  EXPECT_EQ(BufferPool::getSizeClassCapacity(1), 128u);
+  for (size_t Size : {1ul, 100ul, 4097ul, 1000000ul}) {
+    EXPECT_GE(BufferPool::getSizeClassCapacity(BufferPool::getSizeClass(Size)),
+              Size);
+  }
+}
+
+TEST(BufferPoolTest, TooLargeSizeIsNotPooled) {
+  auto TooLarge =
+      BufferPool::getSizeClassCapacity(BufferPool::NrOfSizeClasses - 1) + 1;
+  EXPECT_EQ(BufferPool::getSizeClass(TooLarge), BufferPool::NrOfSizeClasses);
+  BufferPool UnderTest;
+  { auto Buffer = UnderTest.allocate(TooLarge); }
+  EXPECT_EQ(UnderTest.getBytesHeld(), 0u);
+  EXPECT_EQ(UnderTest.nrOfMisses(), 1);
+}
+
+TEST(BufferPoolTest, ReleasedBufferIsReused) {
+  BufferPool UnderTest;
+  std::uint8_t *FirstBuffer{nullptr};
+  {
+    auto Buffer = UnderTest.allocate(100);
+    FirstBuffer = Buffer.get();
+  }
+  EXPECT_EQ(UnderTest.getBytesHeld(), 128u);
+  auto Buffer = UnderTest.allocate(120);
+  EXPECT_EQ(Buffer.get(), FirstBuffer);
+  EXPECT_EQ(UnderTest.nrOfHits(), 1);
+  EXPECT_EQ(UnderTest.nrOfMisses(), 1);
+  EXPECT_EQ(UnderTest.getBytesHeld(), 0u);
+}
+
+TEST(BufferPoolTest, RequestedSizeIsAccountedFor) {
+  auto &Accountant = FileWriter::MemoryAccountant::getInstance();
+  auto const BytesInUse = Accountant.getBytesInUse();
+  BufferPool UnderTest;
+  {
+    auto Buffer = UnderTest.allocate(100);
+    EXPECT_EQ(Accountant.getBytesInUse(), BytesInUse + 100);
+  }
+  EXPECT_EQ(Accountant.getBytesInUse(), BytesInUse);
+}
+
+TEST(BufferPoolTest, BytesHeldIsCapped) {
+  BufferPool UnderTest(200);
+  {
+    auto Buffer1 = UnderTest.allocate(128);
+    auto Buffer2 = UnderTest.allocate(128);
+  }
+  EXPECT_EQ(UnderTest.getBytesHeld(), 128u);
+}
+
+TEST(BufferPoolTest, ClearFreesBuffers) {
+  BufferPool UnderTest;
+  { auto Buffer = UnderTest.allocate(1000); }
+  EXPECT_GT(UnderTest.getBytesHeld(), 0u);
+  UnderTest.clear();
+  EXPECT_EQ(UnderTest.getBytesHeld(), 0u);
+}
+
+TEST(BufferPoolTest, MessageCopyKeepsData) {
+  std::string const TestData{"Some test data"};
+  FileWriter::Msg Original(TestData.c_str(), TestData.size());
+  FileWriter::Msg Copy;
+  Copy = Original;
+  ASSERT_EQ(Copy.size(), TestData.size());
+  EXPECT_NE(Copy.data(), Original.data());
+  EXPECT_EQ(std::string(reinterpret_cast<char const *>(Copy.data()),
+                        Copy.size()),
+            TestData);
+}
@@ -16,7 +16,7 @@ TEST(ExtractStreamSettings, IfStreamNotDefinedThenThrows) {
   })"""};
 
   StreamHDFInfo Info;
-  Info.ConfigStream = Command;
+  Info.ConfigStream = nlohmann::json::parse(Command);
 
   ASSERT_THROW(FileWriter::extractStreamInformationFromJsonForSource(Info),
                std::runtime_error);
@@ -33,7 +33,7 @@ TEST(ExtractStreamSettings, IfSourceNotDefinedThenThrows) {
   })"""};
 
   StreamHDFInfo Info;
-  Info.ConfigStream = Command;
+  Info.ConfigStream = nlohmann::json::parse(Command);
 
   ASSERT_THROW(FileWriter::extractStreamInformationFromJsonForSource(Info),
                std::runtime_error);
@@ -50,7 +50,7 @@ TEST(ExtractStreamSettings, IfTopicNotDefinedThenThrows) {
   })"""};
 
   StreamHDFInfo Info;
-  Info.ConfigStream = Command;
+  Info.ConfigStream = nlohmann::json::parse(Command);
 
   ASSERT_THROW(FileWriter::extractStreamInformationFromJsonForSource(Info),
                std::runtime_error);
@@ -67,7 +67,7 @@ TEST(ExtractStreamSettings, IfWriterModuleNotDefinedThenThrows) {
   })"""};
 
   StreamHDFInfo Info;
-  Info.ConfigStream = Command;
+  Info.ConfigStream = nlohmann::json::parse(Command);
 
   ASSERT_THROW(FileWriter::extractStreamInformationFromJsonForSource(Info),
                std::runtime_error);
@@ -85,7 +85,7 @@ TEST(ExtractStreamSettings, IfValidThenBasicStreamSettingsExtracted) {
   })"""};
 
   StreamHDFInfo Info;
-  Info.ConfigStream = Command;
+  Info.ConfigStream = nlohmann::json::parse(Command);
 
   auto Settings = FileWriter::extractStreamInformationFromJsonForSource(Info);
 
@@ -109,9 +109,9 @@ TEST(ExtractStreamSettings, IfAttributesDefinedThenExtracted) {
   })"""};
 
   StreamHDFInfo Info;
-  Info.ConfigStream = Command;
+  Info.ConfigStream = nlohmann::json::parse(Command);
 
   auto Settings = FileWriter::extractStreamInformationFromJsonForSource(Info);
 
-  ASSERT_EQ("{\"NX_class\":\"NXlog\"}", Settings.Attributes);
+  ASSERT_EQ("{\"NX_class\":\"NXlog\"}", Settings.Attributes.dump());
 }
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "FileAccessProfile.h"
+#include <gtest/gtest.h>
+
+using namespace FileWriter;
+using nlohmann::json;
+
+TEST(FileAccessProfile, UnknownProfileThrows) {
+  EXPECT_THROW(getFileAccessProfile("no_such_profile"), std::runtime_error);
+}
+
+TEST(FileAccessProfile, DefaultProfileUsesHDF5Defaults) {
+  auto Profile = getFileAccessProfile("default");
+  EXPECT_EQ(Profile.Alignment, 0u);
+  EXPECT_EQ(Profile.MetaBlockSize, 0u);
+  EXPECT_EQ(Profile.SieveBufferSize, 0u);
+}
+
+TEST(FileAccessProfile, SettingsAreAppliedOnTopOfProfile) {
+  auto Profile = applyFileAccessSettings(
+      json::parse(R"({"profile": "parallel_filesystem", "alignment": 4096})"),
+      getFileAccessProfile("default"));
+  EXPECT_EQ(Profile.Alignment, 4096u);
+  EXPECT_EQ(Profile.MetaBlockSize,
+            getFileAccessProfile("parallel_filesystem").MetaBlockSize);
+}
+
+TEST(FileAccessProfile, UnknownSettingThrows) {
+  EXPECT_THROW(applyFileAccessSettings(json::parse(R"({"alignmnet": 4096})"),
+                                       FileAccessProfile()),
+               std::runtime_error);
+}
+
+TEST(FileAccessProfile, InvalidValueThrows) {
+  EXPECT_THROW(
+      applyFileAccessSettings(json::parse(R"({"alignment": "large"})"),
+                              FileAccessProfile()),
+      std::runtime_error);
+  EXPECT_THROW(applyFileAccessSettings(
+                   json::parse(R"({"library_version_low_bound": "v18"})"),
+                   FileAccessProfile()),
+               std::runtime_error);
+}
+
+TEST(FileAccessProfile, SettingsAreSetOnFileAccessList) {
+  FileAccessProfile Profile;
+  Profile.AlignmentThreshold = 1024;
+  Profile.Alignment = 4096;
+  Profile.MetaBlockSize = 8192;
+  Profile.SieveBufferSize = 16384;
+  auto AccessList = Profile.createFileAccessList();
+  auto Id = static_cast<hid_t>(AccessList);
+
+  hsize_t Threshold{0};
+  hsize_t Alignment{0};
+  ASSERT_GE(H5Pget_alignment(Id, &Threshold, &Alignment), 0);
+  EXPECT_EQ(Threshold, 1024u);
+  EXPECT_EQ(Alignment, 4096u);
+  hsize_t MetaBlockSize{0};
+  ASSERT_GE(H5Pget_meta_block_size(Id, &MetaBlockSize), 0);
+  EXPECT_EQ(MetaBlockSize, 8192u);
+  size_t SieveBufferSize{0};
+  ASSERT_GE(H5Pget_sieve_buf_size(Id, &SieveBufferSize), 0);
+  EXPECT_EQ(SieveBufferSize, 16384u);
+}
+
+TEST(FileAccessProfile, MetadataCacheSizesAreConsistent) {
+  FileAccessProfile Profile;
+  Profile.MetadataCacheInitialSize = 128 * 1024 * 1024;
+  auto AccessList = Profile.createFileAccessList();
+  H5AC_cache_config_t CacheConfig;
+  CacheConfig.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+  ASSERT_GE(H5Pget_mdc_config(static_cast<hid_t>(AccessList), &CacheConfig),
+            0);
+  EXPECT_EQ(CacheConfig.initial_size, 128u * 1024u * 1024u);
+  EXPECT_GE(CacheConfig.max_size, CacheConfig.initial_size);
+}
+
+TEST(FileAccessProfile, UnknownDriverThrows) {
+  EXPECT_THROW(applyFileAccessSettings(json::parse(R"({"driver": "mpio"})"),
+                                       FileAccessProfile()),
+               std::runtime_error);
+}
+
+TEST(FileAccessProfile, CoreDriverSettingsAreApplied) {
+  auto Profile = applyFileAccessSettings(
+      json::parse(R"({"driver": "core", "core_increment": 1048576,
+                      "core_page_size": 65536,
+                      "core_memory_limit": 16777216})"),
+      FileAccessProfile());
+  EXPECT_TRUE(Profile.inMemory());
+  EXPECT_EQ(Profile.CoreIncrement, 1048576u);
+  EXPECT_EQ(Profile.CorePageSize, 65536u);
+  EXPECT_EQ(Profile.CoreMemoryLimit, 16777216u);
+  EXPECT_FALSE(getFileAccessProfile("default").inMemory());
+  EXPECT_TRUE(getFileAccessProfile("in_memory").inMemory());
+}
+
+TEST(FileAccessProfile, CoreDriverIsSetOnFileAccessList) {
+  FileAccessProfile Profile;
+  Profile.Driver = "core";
+  Profile.CoreIncrement = 1024 * 1024;
+  auto AccessList = Profile.createFileAccessList();
+  auto Id = static_cast<hid_t>(AccessList);
+  EXPECT_EQ(H5Pget_driver(Id), H5FD_CORE);
+  size_t Increment{0};
+  hbool_t BackingStore{false};
+  ASSERT_GE(H5Pget_fapl_core(Id, &Increment, &BackingStore), 0);
+  EXPECT_EQ(Increment, 1024u * 1024u);
+  EXPECT_TRUE(BackingStore);
+}
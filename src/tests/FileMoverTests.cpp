@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "FileMover.h"
+#include "Filesystem.h"
+#include "helpers/TemporaryDirectory.h"
+#include <fstream>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace FileWriter;
+
+class FileMoverTests : public ::testing::Test {
+public:
+  void SetUp() override {
+    fs::create_directories(ScratchDirectory);
+    fs::create_directories(OutputDirectory);
+  }
+
+  std::string createFile(std::string const &Name, std::size_t Size) {
+    auto FileName = (ScratchDirectory / Name).string();
+    std::ofstream File(FileName, std::ios::binary);
+    for (std::size_t i = 0; i < Size; ++i) {
+      File.put(static_cast<char>(i % 251));
+    }
+    return FileName;
+  }
+
+  static Status::FileMoveInfo waitForMove(FileMover const &Mover) {
+    for (int i = 0; i < 1000; ++i) {
+      auto Moves = Mover.getMoveInfo();
+      if (Moves.size() == 1 and
+          (Moves[0].State == "done" or Moves[0].State == "failed")) {
+        return Moves[0];
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    throw std::runtime_error("Timed out waiting for the move.");
+  }
+
+  TemporaryDirectory Directory{"file_mover_tests"};
+  fs::path ScratchDirectory{Directory.path() / "scratch"};
+  fs::path OutputDirectory{Directory.path() / "output"};
+};
+
+TEST_F(FileMoverTests, FileIsMovedToDestination) {
+  std::size_t const Size{5 * 1024 * 1024 + 17};
+  auto Source = createFile("file.nxs", Size);
+  auto const Checksum = calculateFileChecksum(Source);
+  auto Destination = (OutputDirectory / "file.nxs").string();
+  FileMover Mover;
+  Mover.moveFile(Source, Destination);
+  auto Move = waitForMove(Mover);
+  EXPECT_EQ(Move.State, "done");
+  EXPECT_EQ(Move.BytesMoved, Size);
+  EXPECT_EQ(Move.Size, Size);
+  EXPECT_FALSE(fs::exists(Source));
+  EXPECT_FALSE(fs::exists(Destination + ".part"));
+  ASSERT_TRUE(fs::exists(Destination));
+  EXPECT_EQ(calculateFileChecksum(Destination), Checksum);
+}
+
+TEST_F(FileMoverTests, SourceIsKeptIfMoveFails) {
+  auto Source = createFile("file.nxs", 1024);
+  auto Destination = (OutputDirectory / "missing" / "file.nxs").string();
+  FileMover Mover;
+  Mover.moveFile(Source, Destination);
+  auto Move = waitForMove(Mover);
+  EXPECT_EQ(Move.State, "failed");
+  EXPECT_FALSE(Move.Error.empty());
+  EXPECT_TRUE(fs::exists(Source));
+}
+
+TEST_F(FileMoverTests, ExistingDestinationIsNotOverwritten) {
+  auto Source = createFile("file.nxs", 1024);
+  auto Destination = (OutputDirectory / "file.nxs").string();
+  std::ofstream(Destination) << "existing";
+  FileMover Mover;
+  Mover.moveFile(Source, Destination);
+  auto Move = waitForMove(Mover);
+  EXPECT_EQ(Move.State, "failed");
+  // The file is not copied.
+  EXPECT_EQ(Move.Size, 0u);
+  EXPECT_FALSE(fs::exists(Destination + ".part"));
+  EXPECT_TRUE(fs::exists(Source));
+  EXPECT_EQ(fs::file_size(Destination), 8u);
+}
+
+TEST_F(FileMoverTests, OnlyTheMostRecentFinishedMovesAreKept) {
+  FileMover Mover(2);
+  for (int i = 0; i < 4; ++i) {
+    auto Name = "file_" + std::to_string(i) + ".nxs";
+    Mover.moveFile(createFile(Name, 16), (OutputDirectory / Name).string());
+  }
+  // The moves are done in order.
+  auto LastMoveIsDone = [&Mover]() {
+    auto Moves = Mover.getMoveInfo();
+    return Moves.back().State == "done" and
+           fs::path(Moves.back().Destination).filename() == "file_3.nxs";
+  };
+  for (int i = 0; i < 1000 and not LastMoveIsDone(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  auto Moves = Mover.getMoveInfo();
+  ASSERT_EQ(Moves.size(), 2u);
+  EXPECT_EQ(fs::path(Moves[0].Destination).filename(), "file_2.nxs");
+  EXPECT_EQ(fs::path(Moves[1].Destination).filename(), "file_3.nxs");
+}
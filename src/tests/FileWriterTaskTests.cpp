@@ -8,7 +8,10 @@
 // Screaming Udder!                              https://esss.se
 
 #include "FileWriterTask.h"
+#include "HDFOperations.h"
 #include "Source.h"
+#include "helpers/StubWriterModule.h"
+#include "helpers/TemporaryDirectory.h"
 #include <gtest/gtest.h>
 
 TEST(FileWriterTask, WithPrefixFullFileNameIsCorrect) {
@@ -44,3 +47,46 @@ TEST(FileWriterTask, SettingJobIdSetsID) {
 
   ASSERT_EQ(NewId, Task.jobID());
 }
+
+namespace {
+class FailingReopenWriterModule : public StubWriterModule {
+public:
+  InitResult reopen(hdf5::node::Group & /*HDFGroup*/) override {
+    return InitResult::ERROR;
+  }
+};
+} // namespace
+
+TEST(FileWriterTask, DatasetsToFlushAreClearedIfReopeningFailsAfterSwitch) {
+  TemporaryDirectory Directory{"file_writer_task_test"};
+  FileWriter::FileWriterTask Task("SomeID");
+  Task.setFilename("", Directory.filePath("file.nxs"));
+  FileWriter::FileAccessProfile Profile;
+  Profile.Driver = "core";
+  Profile.CoreIncrement = 64 * 1024;
+  // The file is switched to the default driver at the first check.
+  Profile.CoreMemoryLimit = Profile.CoreIncrement;
+  Task.setFileAccessProfile(Profile);
+  std::vector<FileWriter::StreamHDFInfo> StreamHDFInfoList;
+  Task.InitialiseHdf(nlohmann::json::parse(R"({
+    "children": [{
+      "type": "group",
+      "name": "entry",
+      "children": [{"type": "dataset", "name": "values", "values": [1, 2]}]
+    }]
+  })"),
+                     StreamHDFInfoList);
+  auto Writer = std::make_unique<FailingReopenWriterModule>();
+  auto *const WriterPtr = Writer.get();
+  WriterPtr->setDatasetsToFlush(HDFOperations::findDatasets(
+      hdf5::node::get_group(Task.hdfGroup(), "/entry")));
+  ASSERT_TRUE(WriterPtr->flushDatasets());
+  Task.addSource(FileWriter::Source("Src1", "Id1", "Id2", "Topic1",
+                                    std::move(Writer), "/entry"));
+
+  Task.checkMemoryLimit();
+
+  EXPECT_FALSE(Task.inMemory());
+  // The datasets were closed by the switch, the file is flushed instead.
+  EXPECT_FALSE(WriterPtr->flushDatasets());
+}
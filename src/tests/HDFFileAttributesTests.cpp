@@ -522,4 +522,32 @@ TEST(HDFFileAttributesTest, EmptyStringArrayAttributeWithoutType) {
   EXPECT_EQ(AttrValue, ExpectedAttr);
 }
 
+TEST(HDFFileAttributesTest, MultiDimensionalNumericDatasetIsWrittenToFile) {
+  auto TestFile =
+      HDFFileTestHelper::createInMemoryTestFile("test-2d-dataset.nxs");
+
+  std::string CommandWith2DDataset = R""({
+      "children": [
+        {
+          "type": "dataset",
+          "name": "pixel_offsets",
+          "dataset": {
+            "type": "int32",
+            "size": [2, 3]
+          },
+          "values": [[1, 2, 3], [4, 5.0, 6]]
+        }
+      ]
+    })"";
+  std::vector<StreamHDFInfo> EmptyStreamHDFInfo;
+  TestFile->init(CommandWith2DDataset, EmptyStreamHDFInfo);
+
+  auto Dataset =
+      hdf5::node::get_dataset(TestFile->hdfGroup(), "/pixel_offsets");
+  std::vector<int32_t> Values(6);
+  Dataset.read(Values);
+  std::vector<int32_t> ExpectedValues{1, 2, 3, 4, 5, 6};
+  EXPECT_EQ(Values, ExpectedValues);
+}
+
 // Add empty string value test
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "HDFFile.h"
+#include "helpers/HDFFileTestHelper.h"
+#include "helpers/TemporaryDirectory.h"
+#include <gtest/gtest.h>
+#include <h5cpp/hdf5.hpp>
+
+class HDFFileCopyTest : public ::testing::Test {
+public:
+  void SetUp() override {
+    auto TemplateFile = hdf5::file::create(
+        TemplateFileName, hdf5::file::AccessFlags::EXCLUSIVE);
+    auto Detector = TemplateFile.root().create_group("detector");
+    Detector.attributes.create_from("NX_class", std::string("NXdetector"));
+    std::vector<int32_t> DetectorIds{1, 2, 3, 4};
+    auto Dataset = Detector.create_dataset(
+        "detector_number", hdf5::datatype::create<int32_t>(),
+        hdf5::dataspace::Simple({DetectorIds.size()}));
+    Dataset.write(DetectorIds);
+  }
+  TemporaryDirectory Directory{"hdf_file_copy_test"};
+  std::string TemplateFileName{Directory.filePath("template.nxs")};
+};
+
+TEST_F(HDFFileCopyTest, GroupIsCopiedFromTemplateFile) {
+  auto TestFile = HDFFileTestHelper::createInMemoryTestFile("test-copy.nxs");
+  auto Command = fmt::format(R""({{
+      "children": [
+        {{
+          "type": "copy",
+          "source_file": "{}",
+          "source_path": "/detector"
+        }}
+      ]
+    }})"",
+                             TemplateFileName);
+  std::vector<StreamHDFInfo> EmptyStreamHDFInfo;
+  TestFile->init(Command, EmptyStreamHDFInfo);
+
+  auto Detector = hdf5::node::get_group(TestFile->hdfGroup(), "/detector");
+  std::string NXClass;
+  Detector.attributes["NX_class"].read(NXClass);
+  EXPECT_EQ(NXClass, "NXdetector");
+  std::vector<int32_t> DetectorIds(4);
+  hdf5::node::get_dataset(Detector, "detector_number").read(DetectorIds);
+  std::vector<int32_t> ExpectedIds{1, 2, 3, 4};
+  EXPECT_EQ(DetectorIds, ExpectedIds);
+}
+
+TEST_F(HDFFileCopyTest, CopiedObjectCanBeRenamed) {
+  auto TestFile =
+      HDFFileTestHelper::createInMemoryTestFile("test-copy-rename.nxs");
+  auto Command = fmt::format(R""({{
+      "children": [
+        {{
+          "type": "copy",
+          "name": "ids",
+          "source_file": "{}",
+          "source_path": "/detector/detector_number"
+        }}
+      ]
+    }})"",
+                             TemplateFileName);
+  std::vector<StreamHDFInfo> EmptyStreamHDFInfo;
+  TestFile->init(Command, EmptyStreamHDFInfo);
+
+  EXPECT_TRUE(TestFile->hdfGroup().has_dataset("ids"));
+}
+
+TEST_F(HDFFileCopyTest, MissingSourceFileDoesNotStopStructureCreation) {
+  auto TestFile =
+      HDFFileTestHelper::createInMemoryTestFile("test-copy-missing.nxs");
+  std::string Command = R""({
+      "children": [
+        {
+          "type": "copy",
+          "source_file": "this_file_does_not_exist.nxs",
+          "source_path": "/detector"
+        },
+        {
+          "type": "group",
+          "name": "entry"
+        }
+      ]
+    })"";
+  std::vector<StreamHDFInfo> EmptyStreamHDFInfo;
+  TestFile->init(Command, EmptyStreamHDFInfo);
+
+  EXPECT_FALSE(TestFile->hdfGroup().has_group("detector"));
+  EXPECT_TRUE(TestFile->hdfGroup().has_group("entry"));
+}
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "HDFFile.h"
+#include "helpers/TemporaryDirectory.h"
+#include <gtest/gtest.h>
+#include <h5cpp/hdf5.hpp>
+#include <limits>
+
+using namespace FileWriter;
+
+class HDFFileCoreDriverTest : public ::testing::Test {
+public:
+  void SetUp() override {
+    Profile.Driver = "core";
+    Profile.CoreIncrement = 64 * 1024;
+  }
+
+  std::unique_ptr<HDFFile> createFile() {
+    auto NexusStructure = nlohmann::json::parse(
+        R"({"children": [{"type": "group", "name": "entry"}]})");
+    return std::make_unique<HDFFile>(FileName, std::move(NexusStructure),
+                                     StreamHDFInfoList, Profile);
+  }
+
+  TemporaryDirectory Directory{"hdf_file_core_driver_test"};
+  std::string FileName{Directory.filePath("file.nxs")};
+  FileAccessProfile Profile;
+  std::vector<StreamHDFInfo> StreamHDFInfoList;
+};
+
+TEST_F(HDFFileCoreDriverTest, FileIsWrittenToDiskWhenClosed) {
+  {
+    auto File = createFile();
+    File->startSWMRWrite();
+    EXPECT_TRUE(File->inMemory());
+    EXPECT_FALSE(File->wouldExceedMemoryLimit());
+  }
+  auto File = hdf5::file::open(FileName, hdf5::file::AccessFlags::READONLY);
+  EXPECT_TRUE(File.root().has_group("entry"));
+}
+
+TEST_F(HDFFileCoreDriverTest, FileIsSwitchedToDefaultDriverAtMemoryLimit) {
+  Profile.CoreMemoryLimit = Profile.CoreIncrement;
+  auto File = createFile();
+  EXPECT_TRUE(File->wouldExceedMemoryLimit());
+  File->startSWMRWrite();
+  EXPECT_FALSE(File->inMemory());
+  EXPECT_FALSE(File->wouldExceedMemoryLimit());
+  EXPECT_TRUE(File->hdfGroup().has_group("entry"));
+  File->flush();
+}
+
+TEST_F(HDFFileCoreDriverTest, FileBelowMemoryLimitIsKeptInMemory) {
+  Profile.CoreMemoryLimit = 16 * 1024 * 1024;
+  auto File = createFile();
+  File->startSWMRWrite();
+  EXPECT_TRUE(File->inMemory());
+}
+
+TEST_F(HDFFileCoreDriverTest, HeadroomIsLeftUntilMemoryLimit) {
+  Profile.CoreMemoryLimit = 16 * 1024 * 1024;
+  auto File = createFile();
+  auto const FileSize = File->fileSize();
+  EXPECT_GT(FileSize, 0u);
+  EXPECT_EQ(File->memoryHeadroom(),
+            Profile.CoreMemoryLimit - FileSize - Profile.CoreIncrement);
+}
+
+TEST_F(HDFFileCoreDriverTest, NoMemoryLimitMeansUnlimitedHeadroom) {
+  auto File = createFile();
+  EXPECT_EQ(File->memoryHeadroom(), std::numeric_limits<std::size_t>::max());
+}
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "HDFFile.h"
+#include "helpers/TemporaryDirectory.h"
+#include <gtest/gtest.h>
+#include <h5cpp/hdf5.hpp>
+
+using namespace FileWriter;
+
+class HDFFileSWMRTest : public ::testing::Test {
+public:
+  std::unique_ptr<HDFFile> createFile() {
+    auto NexusStructure = nlohmann::json::parse(R"({
+      "children": [{
+        "type": "group",
+        "name": "entry",
+        "children": [
+          {"type": "group", "name": "instrument"},
+          {"type": "link", "name": "instrument_link", "target": "instrument"}
+        ]
+      }]
+    })");
+    return std::make_unique<HDFFile>(FileName, std::move(NexusStructure),
+                                     StreamHDFInfoList);
+  }
+
+  static bool hasLink(hdf5::node::Group Root) {
+    return Root.get_group("entry").has_group("instrument_link");
+  }
+
+  static bool isInSWMRMode(HDFFile &File) {
+    auto FileId = H5Iget_file_id(static_cast<hid_t>(File.hdfGroup()));
+    unsigned Intent{0};
+    auto Status = H5Fget_intent(FileId, &Intent);
+    H5Fclose(FileId);
+    return Status >= 0 and (Intent & H5F_ACC_SWMR_WRITE) != 0;
+  }
+
+  TemporaryDirectory Directory{"hdf_file_swmr_test"};
+  std::string FileName{Directory.filePath("file.nxs")};
+  std::vector<StreamHDFInfo> StreamHDFInfoList;
+};
+
+TEST_F(HDFFileSWMRTest, LinksAreAddedWhenStartingSWMRWrite) {
+  auto File = createFile();
+  EXPECT_FALSE(hasLink(File->hdfGroup()));
+  File->startSWMRWrite();
+  EXPECT_TRUE(hasLink(File->hdfGroup()));
+}
+
+TEST_F(HDFFileSWMRTest, FileIsInSWMRModeAfterStartingSWMRWrite) {
+  auto File = createFile();
+  EXPECT_FALSE(isInSWMRMode(*File));
+  File->startSWMRWrite();
+  EXPECT_TRUE(isInSWMRMode(*File));
+}
+
+TEST_F(HDFFileSWMRTest, LinksAreAddedWhenClosingFileWithoutSWMRWrite) {
+  createFile().reset();
+  auto File = hdf5::file::open(FileName, hdf5::file::AccessFlags::READONLY);
+  EXPECT_TRUE(hasLink(File.root()));
+}
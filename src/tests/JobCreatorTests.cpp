@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "FileWriterTask.h"
+#include "JobCreator.h"
+#include "WriterRegistrar.h"
+#include "helpers/StubWriterModule.h"
+#include "helpers/TemporaryDirectory.h"
+#include <gtest/gtest.h>
+
+using namespace FileWriter;
+
+namespace {
+std::string const TrackingModuleName{"instance_tracking"};
+
+/// Writer module that records the instances that were initialised and
+/// re-opened.
+class InstanceTrackingWriterModule : public StubWriterModule {
+public:
+  InitResult init_hdf(hdf5::node::Group & /*HDFGroup*/) override {
+    InitialisedInstances.push_back(this);
+    return InitResult::OK;
+  }
+  InitResult reopen(hdf5::node::Group & /*HDFGroup*/) override {
+    ReopenedInstances.push_back(this);
+    return InitResult::OK;
+  }
+  static std::vector<WriterModule::Base *> InitialisedInstances;
+  static std::vector<WriterModule::Base *> ReopenedInstances;
+};
+
+std::vector<WriterModule::Base *>
+    InstanceTrackingWriterModule::InitialisedInstances;
+std::vector<WriterModule::Base *>
+    InstanceTrackingWriterModule::ReopenedInstances;
+} // namespace
+
+class JobCreatorTests : public ::testing::Test {
+public:
+  void SetUp() override {
+    try {
+      WriterModule::Registry::find(TrackingModuleName);
+    } catch (std::exception const &) {
+      WriterModule::Registry::Registrar<InstanceTrackingWriterModule>
+          RegisterIt("trk0", TrackingModuleName);
+    }
+    InstanceTrackingWriterModule::InitialisedInstances.clear();
+    InstanceTrackingWriterModule::ReopenedInstances.clear();
+  }
+
+  TemporaryDirectory Directory{"job_creator_tests"};
+  std::string FileName{Directory.filePath("file.nxs")};
+};
+
+TEST_F(JobCreatorTests, WriterModuleThatSetUpTheStreamIsUsedForWriting) {
+  auto NexusStructure = nlohmann::json::parse(R"({
+    "children": [{
+      "type": "group",
+      "name": "entry",
+      "children": [{
+        "type": "stream",
+        "stream": {
+          "topic": "some_topic",
+          "source": "some_source",
+          "writer_module": "instance_tracking"
+        }
+      }]
+    }]
+  })");
+  auto Task = std::make_unique<FileWriterTask>("some_service_id");
+  Task->setFilename("", FileName);
+  std::vector<StreamHDFInfo> StreamHDFInfoList;
+  Task->InitialiseHdf(std::move(NexusStructure), StreamHDFInfoList);
+  ASSERT_EQ(StreamHDFInfoList.size(), 1u);
+
+  std::vector<StreamSettings> StreamSettingsList{
+      extractStreamInformationFromJsonForSource(StreamHDFInfoList[0])};
+  setUpHdfStructure(StreamSettingsList[0], Task);
+  auto *const Instance = StreamSettingsList[0].HDFWriterModule.get();
+  ASSERT_NE(Instance, nullptr);
+  EXPECT_EQ(StreamSettingsList[0].FlatbufferID, "trk0");
+
+  Task->startSWMRWrite();
+  JobCreator::addStreamSourceToWriterModule(StreamSettingsList, Task);
+
+  EXPECT_EQ(InstanceTrackingWriterModule::InitialisedInstances,
+            std::vector<WriterModule::Base *>{Instance});
+  EXPECT_EQ(InstanceTrackingWriterModule::ReopenedInstances,
+            std::vector<WriterModule::Base *>{Instance});
+  ASSERT_EQ(Task->sources().size(), 1u);
+  EXPECT_EQ(Task->sources()[0].getWriterPtr(), Instance);
+  EXPECT_EQ(Task->sources()[0].flatbufferID(), "trk0");
+}
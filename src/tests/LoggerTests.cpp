@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "logger.h"
+#include <gtest/gtest.h>
+#include <spdlog/sinks/ostream_sink.h>
+#include <sstream>
+
+TEST(LogRateLimiter, FirstMessagesAreLogged) {
+  LogRateLimiter UnderTest(3, 10);
+  for (int i = 0; i < 3; ++i) {
+    auto Result = UnderTest.next();
+    ASSERT_TRUE(Result);
+    EXPECT_EQ(*Result, 0u);
+  }
+}
+
+TEST(LogRateLimiter, OneInMIsLoggedAfterFirstN) {
+  LogRateLimiter UnderTest(2, 5);
+  int NrOfLogged{0};
+  std::uint64_t NrOfSuppressed{0};
+  for (int i = 0; i < 22; ++i) {
+    if (auto Result = UnderTest.next()) {
+      ++NrOfLogged;
+      NrOfSuppressed += *Result;
+    }
+  }
+  EXPECT_EQ(NrOfLogged, 2 + 4);
+  EXPECT_EQ(NrOfSuppressed, 4u * 4u);
+}
+
+class LogRateLimitedTest : public ::testing::Test {
+public:
+  void SetUp() override {
+    auto Sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(Output);
+    Sink->set_pattern("%v");
+    TestLogger = std::make_shared<spdlog::logger>("rate_limited_test", Sink);
+    TestLogger->set_level(spdlog::level::info);
+  }
+  std::ostringstream Output;
+  SharedLogger TestLogger;
+};
+
+TEST_F(LogRateLimitedTest, SuppressedMessagesAreCounted) {
+  LogRateLimiter Limiter(1, 3);
+  for (int i = 0; i < 4; ++i) {
+    logRateLimited(*TestLogger, Limiter, spdlog::level::warn, "message {}", i);
+  }
+  EXPECT_EQ(Output.str(),
+            "message 0\nmessage 3 (2 similar messages were suppressed)\n");
+}
+
+TEST_F(LogRateLimitedTest, DisabledLevelIsNotCounted) {
+  LogRateLimiter Limiter(1, 100);
+  logRateLimited(*TestLogger, Limiter, spdlog::level::debug, "debug");
+  logRateLimited(*TestLogger, Limiter, spdlog::level::warn, "warning");
+  EXPECT_EQ(Output.str(), "warning\n");
+}
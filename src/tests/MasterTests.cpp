@@ -7,10 +7,12 @@
 //
 // Screaming Udder!                              https://esss.se
 
+#include <fstream>
 #include <gtest/gtest.h>
 #include <memory>
 
 #include "CommandListener.h"
+#include "Filesystem.h"
 #include "JobCreator.h"
 #include "Master.h"
 #include "Msg.h"
@@ -19,6 +21,7 @@
 #include "helpers/FakeStreamController.h"
 #include "helpers/RdKafkaMocks.h"
 #include "helpers/RunStartStopHelpers.h"
+#include "helpers/TemporaryDirectory.h"
 
 using namespace FileWriter;
 using namespace RunStartStopHelpers;
@@ -220,3 +223,68 @@ TEST_F(MasterTests, IfStoppedMessageContainsWrongJobIdThenIgnored) {
   Master->run();
   ASSERT_TRUE(Master->isWriting());
 }
+
+class MasterScratchDirectoryTests : public MasterTests {
+public:
+  void SetUp() override {
+    auto const &BaseDirectory = Directory.path();
+    fs::create_directories(BaseDirectory / "scratch");
+    fs::create_directories(BaseDirectory / "output");
+    MainOpts.ScratchDirectory = (BaseDirectory / "scratch").string();
+    MainOpts.HDFOutputPrefix = (BaseDirectory / "output").string();
+    ScratchFileName = BaseDirectory / "scratch" / "a-dummy-name-01.h5";
+    OutputFileName = BaseDirectory / "output" / "a-dummy-name-01.h5";
+    // Stands in for the file written by the (fake) job.
+    std::ofstream(ScratchFileName.string()) << "some data";
+    MasterTests::SetUp();
+  }
+
+  TemporaryDirectory Directory{"master_scratch_tests"};
+  fs::path ScratchFileName;
+  fs::path OutputFileName;
+};
+
+TEST_F(MasterScratchDirectoryTests, FileIsMovedWhenJobHasStopped) {
+  queueCommandMessage(CmdListener.get(), Kafka::PollStatus::Message,
+                      Msg(StartCommand.data(), StartCommand.size()));
+  queueCommandMessage(CmdListener.get(), Kafka::PollStatus::Message,
+                      Msg(StopCommand.data(), StopCommand.size()));
+  {
+    auto Master = std::make_unique<FileWriter::Master>(
+        MainOpts, std::move(CmdListener), std::move(Creator),
+        std::move(Reporter), Metrics::Registrar("some_reg", {}));
+    Master->run();
+    Master->run();
+    ASSERT_FALSE(Master->isWriting());
+  } // Blocks until the move is done.
+  EXPECT_FALSE(fs::exists(ScratchFileName));
+  EXPECT_TRUE(fs::exists(OutputFileName));
+}
+
+TEST_F(MasterScratchDirectoryTests, FileIsNotMovedIfStartingThrows) {
+  queueCommandMessage(CmdListener.get(), Kafka::PollStatus::Message,
+                      Msg(StartCommand.data(), StartCommand.size()));
+  {
+    auto Master = std::make_unique<FileWriter::Master>(
+        MainOpts, std::move(CmdListener), std::move(ThrowingCreator),
+        std::move(Reporter), Metrics::Registrar("some_reg", {}));
+    Master->run();
+    ASSERT_FALSE(Master->isWriting());
+  }
+  EXPECT_TRUE(fs::exists(ScratchFileName));
+  EXPECT_FALSE(fs::exists(OutputFileName));
+}
+
+TEST_F(MasterScratchDirectoryTests, FileOfRunningJobIsMovedOnDestruction) {
+  queueCommandMessage(CmdListener.get(), Kafka::PollStatus::Message,
+                      Msg(StartCommand.data(), StartCommand.size()));
+  {
+    auto Master = std::make_unique<FileWriter::Master>(
+        MainOpts, std::move(CmdListener), std::move(Creator),
+        std::move(Reporter), Metrics::Registrar("some_reg", {}));
+    Master->run();
+    ASSERT_TRUE(Master->isWriting());
+  }
+  EXPECT_FALSE(fs::exists(ScratchFileName));
+  EXPECT_TRUE(fs::exists(OutputFileName));
+}
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "MemoryAccountant.h"
+#include <gtest/gtest.h>
+
+using FileWriter::MemoryAccountant;
+
+class MemoryAccountantStandIn : public MemoryAccountant {
+public:
+  void setRates() {
+    auto Now = std::chrono::steady_clock::now();
+    LastRateUpdate = Now - std::chrono::seconds(1);
+    updateRates(Now);
+  }
+  void makeRateUpdateDue() {
+    LastRateUpdate = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+    NextRateUpdate = LastRateUpdate;
+  }
+};
+
+TEST(MemoryAccountantTest, AddAndRemove) {
+  MemoryAccountant UnderTest;
+  UnderTest.add(100);
+  UnderTest.add(50);
+  EXPECT_EQ(UnderTest.getBytesInUse(), 150u);
+  UnderTest.remove(100);
+  EXPECT_EQ(UnderTest.getBytesInUse(), 50u);
+}
+
+TEST(MemoryAccountantTest, NoLimitMeansNoThrottling) {
+  MemoryAccountant UnderTest;
+  auto Consumer = UnderTest.addConsumer();
+  UnderTest.add(1000000000);
+  EXPECT_FALSE(UnderTest.isOverBudget());
+  EXPECT_FALSE(UnderTest.shouldThrottle(*Consumer));
+}
+
+TEST(MemoryAccountantTest, BelowLimitMeansNoThrottling) {
+  MemoryAccountant UnderTest;
+  UnderTest.setLimit(1000);
+  auto Consumer = UnderTest.addConsumer();
+  UnderTest.add(999);
+  EXPECT_FALSE(UnderTest.isOverBudget());
+  EXPECT_FALSE(UnderTest.shouldThrottle(*Consumer));
+}
+
+TEST(MemoryAccountantTest, HighestRateIsThrottledFirst) {
+  MemoryAccountantStandIn UnderTest;
+  UnderTest.setLimit(1000);
+  auto SlowConsumer = UnderTest.addConsumer();
+  auto FastConsumer = UnderTest.addConsumer();
+  SlowConsumer->ConsumedBytes += 10;
+  FastConsumer->ConsumedBytes += 1000;
+  UnderTest.setRates();
+  UnderTest.add(1000);
+  EXPECT_TRUE(UnderTest.isOverBudget());
+  EXPECT_TRUE(UnderTest.shouldThrottle(*FastConsumer));
+  EXPECT_FALSE(UnderTest.shouldThrottle(*SlowConsumer));
+}
+
+TEST(MemoryAccountantTest, AllAreThrottledWhenFarAboveLimit) {
+  MemoryAccountantStandIn UnderTest;
+  UnderTest.setLimit(1000);
+  auto SlowConsumer = UnderTest.addConsumer();
+  auto FastConsumer = UnderTest.addConsumer();
+  SlowConsumer->ConsumedBytes += 10;
+  FastConsumer->ConsumedBytes += 1000;
+  UnderTest.setRates();
+  UnderTest.add(1100);
+  EXPECT_TRUE(UnderTest.shouldThrottle(*FastConsumer));
+  EXPECT_TRUE(UnderTest.shouldThrottle(*SlowConsumer));
+}
+
+TEST(MemoryAccountantTest, ReleasedConsumerIsNotCounted) {
+  MemoryAccountantStandIn UnderTest;
+  UnderTest.setLimit(1000);
+  auto SlowConsumer = UnderTest.addConsumer();
+  {
+    auto FastConsumer = UnderTest.addConsumer();
+    FastConsumer->ConsumedBytes += 1000;
+    UnderTest.setRates();
+  }
+  UnderTest.add(1000);
+  EXPECT_TRUE(UnderTest.shouldThrottle(*SlowConsumer));
+}
+
+TEST(MemoryAccountantTest, RatesAreUpdatedBelowLimit) {
+  MemoryAccountantStandIn UnderTest;
+  UnderTest.setLimit(1000);
+  auto Consumer = UnderTest.addConsumer();
+  Consumer->ConsumedBytes += 1000;
+  UnderTest.makeRateUpdateDue();
+  EXPECT_FALSE(UnderTest.shouldThrottle(*Consumer));
+  EXPECT_GT(Consumer->Rate, 0.0);
+}
+
+TEST(MemoryAccountantTest, ThrottledTimeIsNotCountedInRate) {
+  MemoryAccountantStandIn UnderTest;
+  auto Consumer = UnderTest.addConsumer();
+  Consumer->ConsumedBytes += 500;
+  Consumer->ThrottledTime += 500'000'000;
+  UnderTest.setRates();
+  EXPECT_DOUBLE_EQ(Consumer->Rate, 1000.0);
+}
+
+TEST(MemoryAccountantTest, RateIsKeptWhileThrottled) {
+  MemoryAccountantStandIn UnderTest;
+  UnderTest.setLimit(1000);
+  auto ThrottledConsumer = UnderTest.addConsumer();
+  auto OtherConsumer = UnderTest.addConsumer();
+  ThrottledConsumer->ConsumedBytes += 1000;
+  OtherConsumer->ConsumedBytes += 10;
+  UnderTest.setRates();
+  UnderTest.add(1000);
+  EXPECT_TRUE(UnderTest.shouldThrottle(*ThrottledConsumer));
+  // No data was consumed during the next interval as it was throttled.
+  ThrottledConsumer->ThrottledTime += 1'000'000'000;
+  OtherConsumer->ConsumedBytes += 10;
+  UnderTest.setRates();
+  EXPECT_TRUE(UnderTest.shouldThrottle(*ThrottledConsumer));
+  EXPECT_FALSE(UnderTest.shouldThrottle(*OtherConsumer));
+}
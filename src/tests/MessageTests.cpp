@@ -9,6 +9,7 @@
 
 #include "FlatbufferMessage.h"
 #include "FlatbufferReader.h"
+#include <flatbuffers/flatbuffers.h>
 #include <gtest/gtest.h>
 #include <map>
 
@@ -58,6 +59,42 @@ public:
   }
 };
 
+class InvalidReaderWithBoundsCheck : public InvalidReader {
+public:
+  bool verifyPacketInfo(FlatbufferMessage const & /*Message*/) const override {
+    return true;
+  }
+};
+
+/// Reads the source name from a string field of the root table.
+class StringFieldReader : public FlatbufferReader {
+public:
+  static flatbuffers::voffset_t const NameField{4};
+  static flatbuffers::Table const *getRoot(FlatbufferMessage const &Message) {
+    return flatbuffers::GetRoot<flatbuffers::Table>(Message.data());
+  }
+  bool verify(FlatbufferMessage const & /*Message*/) const override {
+    return false;
+  }
+  bool verifyPacketInfo(FlatbufferMessage const &Message) const override {
+    flatbuffers::Verifier Verifier(Message.data(), Message.size());
+    auto const Root = getRoot(Message);
+    return Root->VerifyTableStart(Verifier) and
+           Root->VerifyOffset(Verifier, NameField) and
+           Verifier.VerifyString(
+               Root->GetPointer<flatbuffers::String const *>(NameField));
+  }
+  std::string source_name(FlatbufferMessage const &Message) const override {
+    return getRoot(Message)
+        ->GetPointer<flatbuffers::String const *>(NameField)
+        ->str();
+  }
+  std::uint64_t
+  timestamp(FlatbufferMessage const & /*Message*/) const override {
+    return 42;
+  }
+};
+
 TEST_F(MessageClassTest, Success) {
   { FlatbufferReaderRegistry::Registrar<MsgDummyReader1> RegisterIt(TestKey); }
   std::memcpy(TestData.get() + 4, TestKey.c_str(), 4);
@@ -90,3 +127,84 @@ TEST_F(MessageClassTest, InvalidFlatbuffer) {
   ASSERT_THROW(FlatbufferMessage(TestData.get(), 8),
                FileWriter::NotValidFlatbuffer);
 }
+
+flatbuffers::DetachedBuffer createEmptyTableBuffer(std::string const &ID) {
+  flatbuffers::FlatBufferBuilder Builder;
+  auto TableStart = Builder.StartTable();
+  auto TableEnd = Builder.EndTable(TableStart);
+  Builder.Finish(flatbuffers::Offset<flatbuffers::Table>(TableEnd),
+                 ID.c_str());
+  return Builder.Release();
+}
+
+TEST_F(MessageClassTest, BoundsOnlyVerificationSkipsReaderVerifier) {
+  {
+    FlatbufferReaderRegistry::Registrar<InvalidReaderWithBoundsCheck>
+        RegisterIt(TestKey);
+  }
+  auto Buffer = createEmptyTableBuffer(TestKey);
+  auto CurrentMessage = FlatbufferMessage(Buffer.data(), Buffer.size(),
+                                          VerificationLevel::BOUNDS_ONLY);
+  EXPECT_TRUE(CurrentMessage.isValid());
+  EXPECT_EQ(CurrentMessage.getSourceName(), "SomeSourceName");
+}
+
+TEST_F(MessageClassTest, BoundsOnlyVerificationFailsOnBadRootOffset) {
+  { FlatbufferReaderRegistry::Registrar<MsgDummyReader1> RegisterIt(TestKey); }
+  auto Buffer = createEmptyTableBuffer(TestKey);
+  std::vector<uint8_t> BadBuffer(Buffer.data(), Buffer.data() + Buffer.size());
+  auto BadRootOffset = static_cast<flatbuffers::uoffset_t>(BadBuffer.size());
+  std::memcpy(BadBuffer.data(), &BadRootOffset, sizeof(BadRootOffset));
+  ASSERT_THROW(FlatbufferMessage(BadBuffer.data(), BadBuffer.size(),
+                                 VerificationLevel::BOUNDS_ONLY),
+               FileWriter::NotValidFlatbuffer);
+}
+
+TEST_F(MessageClassTest, BoundsOnlyVerificationFallsBackToReaderVerifier) {
+  { FlatbufferReaderRegistry::Registrar<InvalidReader> RegisterIt(TestKey); }
+  auto Buffer = createEmptyTableBuffer(TestKey);
+  ASSERT_THROW(FlatbufferMessage(Buffer.data(), Buffer.size(),
+                                 VerificationLevel::BOUNDS_ONLY),
+               FileWriter::NotValidFlatbuffer);
+}
+
+flatbuffers::DetachedBuffer createStringTableBuffer(std::string const &ID) {
+  flatbuffers::FlatBufferBuilder Builder;
+  auto Name = Builder.CreateString("SomeSourceName");
+  auto TableStart = Builder.StartTable();
+  Builder.AddOffset(StringFieldReader::NameField, Name);
+  auto TableEnd = Builder.EndTable(TableStart);
+  Builder.Finish(flatbuffers::Offset<flatbuffers::Table>(TableEnd),
+                 ID.c_str());
+  return Builder.Release();
+}
+
+TEST_F(MessageClassTest, BoundsOnlyVerificationReadsStringField) {
+  {
+    FlatbufferReaderRegistry::Registrar<StringFieldReader> RegisterIt(TestKey);
+  }
+  auto Buffer = createStringTableBuffer(TestKey);
+  auto CurrentMessage = FlatbufferMessage(Buffer.data(), Buffer.size(),
+                                          VerificationLevel::BOUNDS_ONLY);
+  EXPECT_EQ(CurrentMessage.getSourceName(), "SomeSourceName");
+}
+
+TEST_F(MessageClassTest, BoundsOnlyVerificationFailsOnBadStringLength) {
+  {
+    FlatbufferReaderRegistry::Registrar<StringFieldReader> RegisterIt(TestKey);
+  }
+  auto Buffer = createStringTableBuffer(TestKey);
+  std::vector<uint8_t> BadBuffer(Buffer.data(), Buffer.data() + Buffer.size());
+  auto const NamePtr =
+      flatbuffers::GetRoot<flatbuffers::Table>(BadBuffer.data())
+          ->GetPointer<flatbuffers::String const *>(
+              StringFieldReader::NameField);
+  // The length of a string is stored in front of its characters.
+  auto const LengthPosition =
+      reinterpret_cast<uint8_t const *>(NamePtr) - BadBuffer.data();
+  auto const BadLength = static_cast<flatbuffers::uoffset_t>(BadBuffer.size());
+  std::memcpy(BadBuffer.data() + LengthPosition, &BadLength, sizeof(BadLength));
+  ASSERT_THROW(FlatbufferMessage(BadBuffer.data(), BadBuffer.size(),
+                                 VerificationLevel::BOUNDS_ONLY),
+               FileWriter::NotValidFlatbuffer);
+}
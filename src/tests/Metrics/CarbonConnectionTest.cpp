@@ -172,7 +172,7 @@ TEST_F(DISABLED_MetricsCarbonConnectionTest, DISABLED_MultipleCloseConnection) {
 
 TEST_F(DISABLED_MetricsCarbonConnectionTest, SendUpdate) {
   auto TestName = std::string("SomeLongWindedName");
-  Metrics::CounterType Ctr{112233};
+  std::int64_t const Ctr{112233};
   auto Description = "A long description of a metric.";
   auto TestSink = std::unique_ptr<Metrics::Sink>(
       new Metrics::CarbonSink("localhost", UsedPort));
@@ -182,6 +182,7 @@ TEST_F(DISABLED_MetricsCarbonConnectionTest, SendUpdate) {
   auto TestRegistrar =
       std::make_shared<Metrics::Registrar>("Test", TestReporters);
   Metrics::Metric TestMetric(TestName, Description, Metrics::Severity::ERROR);
+  TestMetric = Ctr;
 
   TestRegistrar->registerMetric(TestMetric, {Metrics::LogTo::CARBON});
   std::this_thread::sleep_for(200ms);
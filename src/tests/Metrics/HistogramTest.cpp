@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "Metrics/Histogram.h"
+#include "Metrics/InternalMetric.h"
+#include <gtest/gtest.h>
+
+namespace Metrics {
+
+class HistogramTest : public ::testing::Test {
+public:
+  Histogram UnderTest{"test_name", "some_description"};
+};
+
+TEST_F(HistogramTest, EmptyHistogram) {
+  EXPECT_EQ(UnderTest.count(), 0u);
+  EXPECT_EQ(UnderTest.percentile(0.5), 0);
+  EXPECT_EQ(UnderTest.getHistogram(), &UnderTest);
+}
+
+TEST_F(HistogramTest, SmallValuesAreExact) {
+  for (int i = 0; i < 8; ++i) {
+    UnderTest.add(i);
+  }
+  EXPECT_EQ(UnderTest.count(), 8u);
+  EXPECT_EQ(UnderTest.value(), 8);
+  EXPECT_EQ(UnderTest.percentile(0.5), 3);
+  EXPECT_EQ(UnderTest.percentile(1.0), 7);
+}
+
+TEST_F(HistogramTest, NegativeValuesAreCountedAsZero) {
+  UnderTest.add(-100);
+  EXPECT_EQ(UnderTest.percentile(1.0), 0);
+}
+
+TEST_F(HistogramTest, RelativeErrorOfPercentiles) {
+  for (std::int64_t i = 1; i <= 100000; ++i) {
+    UnderTest.add(i);
+  }
+  auto Median = UnderTest.percentile(0.5);
+  EXPECT_GE(Median, 50000);
+  EXPECT_LE(Median, 50000 + 50000 / 8);
+  auto Max = UnderTest.percentile(1.0);
+  EXPECT_GE(Max, 100000);
+  EXPECT_LE(Max, 100000 + 100000 / 8);
+}
+
+TEST_F(HistogramTest, LargestValue) {
+  UnderTest.add(std::numeric_limits<std::int64_t>::max());
+  EXPECT_EQ(UnderTest.percentile(1.0),
+            std::numeric_limits<std::int64_t>::max());
+}
+
+TEST_F(HistogramTest, SummaryOnlyIncludesNewValues) {
+  Histogram::BinCounts LastCounts;
+  for (int i = 0; i < 100; ++i) {
+    UnderTest.add(1000000);
+  }
+  auto Summary = UnderTest.summariseSince(LastCounts);
+  EXPECT_EQ(Summary.Count, 100u);
+  EXPECT_GE(Summary.P50, 1000000);
+
+  UnderTest.add(10);
+  Summary = UnderTest.summariseSince(LastCounts);
+  EXPECT_EQ(Summary.Count, 1u);
+  EXPECT_EQ(Summary.P50, 10);
+  EXPECT_EQ(Summary.Max, 10);
+
+  Summary = UnderTest.summariseSince(LastCounts);
+  EXPECT_EQ(Summary.Count, 0u);
+  EXPECT_EQ(Summary.Max, 0);
+}
+
+TEST_F(HistogramTest, InternalMetricKnowsAboutHistogram) {
+  InternalMetric HistogramMetric(UnderTest, "prefix.test_name");
+  EXPECT_EQ(HistogramMetric.HistogramPtr, &UnderTest);
+  Metric Counter{"counter", "some_description"};
+  InternalMetric CounterMetric(Counter, "prefix.counter");
+  EXPECT_EQ(CounterMetric.HistogramPtr, nullptr);
+}
+
+} // namespace Metrics
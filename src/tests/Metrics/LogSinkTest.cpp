@@ -1,3 +1,4 @@
+#include "Metrics/Histogram.h"
 #include "Metrics/InternalMetric.h"
 #include "Metrics/LogSink.h"
 #include "Metrics/Metric.h"
@@ -75,4 +76,39 @@ TEST(LogSinkTest, LogsIfMetricHasIncremented) {
   TestLogSink.reportMetric(TestInternalMetric);
 }
 
+TEST(LogSinkTest, NothingIsLoggedIfHistogramHasNoNewValues) {
+  LogSink TestLogSink{};
+  TestLogSink.Logger = std::shared_ptr<spdlog::logger>(new MockLogger());
+  auto LoggerMock = dynamic_cast<MockLogger *>(TestLogSink.Logger.get());
+
+  std::string const TestMetricName = "some_histogram";
+  std::string const TestMetricDescription = "histogram description";
+  Histogram TestHistogram{TestMetricName, TestMetricDescription,
+                          Severity::INFO};
+  InternalMetric TestInternalMetric{TestHistogram, "prefix." + TestMetricName};
+
+  // Nothing has been added to the histogram, therefore nothing is logged
+  FORBID_CALL(*LoggerMock, sink_it_(_));
+  TestLogSink.reportMetric(TestInternalMetric);
+}
+
+TEST(LogSinkTest, LogsIfHistogramHasNewValues) {
+  LogSink TestLogSink{};
+  TestLogSink.Logger = std::shared_ptr<spdlog::logger>(new MockLogger());
+  auto LoggerMock = dynamic_cast<MockLogger *>(TestLogSink.Logger.get());
+
+  std::string const TestMetricName = "some_histogram";
+  std::string const TestMetricDescription = "histogram description";
+  Histogram TestHistogram{TestMetricName, TestMetricDescription,
+                          Severity::INFO};
+  InternalMetric TestInternalMetric{TestHistogram, "prefix." + TestMetricName};
+  TestHistogram.add(5);
+
+  REQUIRE_CALL(*LoggerMock, sink_it_(_))
+      .WITH(messageContainsSubstring(_1, TestMetricName) &&
+            messageContainsSubstring(_1, "p50 = 5"));
+
+  TestLogSink.reportMetric(TestInternalMetric);
+}
+
 } // namespace Metrics
@@ -3,6 +3,7 @@
 #include "MockReporter.h"
 #include "MockSink.h"
 #include <gtest/gtest.h>
+#include <thread>
 
 using namespace std::chrono_literals;
 
@@ -19,7 +20,7 @@ TEST(MetricTest, Init) {
   EXPECT_EQ(UnderTest.getName(), NameStr);
   EXPECT_EQ(UnderTest.getDescription(), DescStr);
   EXPECT_EQ(UnderTest.getSeverity(), TestSeverity);
-  EXPECT_EQ(*UnderTest.getCounterPtr(), 0);
+  EXPECT_EQ(UnderTest.value(), 0);
 }
 
 TEST(MetricTest, PreIncrement) {
@@ -27,9 +28,9 @@ TEST(MetricTest, PreIncrement) {
   auto DescStr = std::string("some_description");
   auto TestSeverity = Severity::ERROR;
   Metric UnderTest(NameStr, DescStr, TestSeverity);
-  EXPECT_EQ(*UnderTest.getCounterPtr(), 0);
-  EXPECT_EQ(++UnderTest, 1);
-  EXPECT_EQ(*UnderTest.getCounterPtr(), 1);
+  EXPECT_EQ(UnderTest.value(), 0);
+  ++UnderTest;
+  EXPECT_EQ(UnderTest.value(), 1);
 }
 
 TEST(MetricTest, PostIncrement) {
@@ -37,9 +38,9 @@ TEST(MetricTest, PostIncrement) {
   auto DescStr = std::string("some_description");
   auto TestSeverity = Severity::ERROR;
   Metric UnderTest(NameStr, DescStr, TestSeverity);
-  EXPECT_EQ(*UnderTest.getCounterPtr(), 0);
-  EXPECT_EQ(UnderTest++, 1);
-  EXPECT_EQ(*UnderTest.getCounterPtr(), 1);
+  EXPECT_EQ(UnderTest.value(), 0);
+  UnderTest++;
+  EXPECT_EQ(UnderTest.value(), 1);
 }
 
 TEST(MetricTest, SumValue) {
@@ -48,9 +49,9 @@ TEST(MetricTest, SumValue) {
   auto TestSeverity = Severity::ERROR;
   Metric UnderTest(NameStr, DescStr, TestSeverity);
   auto TestValue = 42;
-  EXPECT_EQ(*UnderTest.getCounterPtr(), 0);
-  EXPECT_EQ(UnderTest += TestValue, TestValue);
-  EXPECT_EQ(*UnderTest.getCounterPtr(), TestValue);
+  EXPECT_EQ(UnderTest.value(), 0);
+  UnderTest += TestValue;
+  EXPECT_EQ(UnderTest.value(), TestValue);
 }
 
 TEST(MetricTest, SetValue) {
@@ -59,9 +60,46 @@ TEST(MetricTest, SetValue) {
   auto TestSeverity = Severity::ERROR;
   Metric UnderTest(NameStr, DescStr, TestSeverity);
   auto TestValue = std::int64_t(42);
-  EXPECT_EQ(*UnderTest.getCounterPtr(), 0);
+  EXPECT_EQ(UnderTest.value(), 0);
   EXPECT_EQ(UnderTest = TestValue, TestValue);
-  EXPECT_EQ(*UnderTest.getCounterPtr(), TestValue);
+  EXPECT_EQ(UnderTest.value(), TestValue);
+}
+
+TEST(MetricTest, ConcurrentIncrementsAreNotLost) {
+  Metric UnderTest("test_name", "some_description");
+  // More threads than there are shards in order for some threads to share a
+  // shard
+  auto const NrOfThreads = 2 * ShardedCounter::NrOfShards;
+  int const NrOfIncrements{100000};
+  std::vector<std::thread> Threads;
+  for (size_t i = 0; i < NrOfThreads; ++i) {
+    Threads.emplace_back([&UnderTest]() {
+      for (int j = 0; j < NrOfIncrements; ++j) {
+        UnderTest++;
+      }
+    });
+  }
+  for (auto &CurrentThread : Threads) {
+    CurrentThread.join();
+  }
+  EXPECT_EQ(UnderTest.value(), int64_t(NrOfThreads * NrOfIncrements));
+}
+
+TEST(MetricTest, GaugeAddAndSubtractFromDifferentThreads) {
+  Gauge UnderTest("test_name", "some_description");
+  EXPECT_EQ(UnderTest.getType(), MetricType::GAUGE);
+  UnderTest += 10;
+  std::thread([&UnderTest]() { UnderTest -= 4; }).join();
+  EXPECT_EQ(UnderTest.value(), 6);
+  UnderTest = 3;
+  EXPECT_EQ(UnderTest.value(), 3);
+}
+
+TEST(MetricTest, RateType) {
+  Rate UnderTest("test_name", "some_description");
+  EXPECT_EQ(UnderTest.getType(), MetricType::RATE);
+  Metric Counter("test_name", "some_description");
+  EXPECT_EQ(Counter.getType(), MetricType::COUNTER);
 }
 
 TEST(MetricTest, Deregister) {
@@ -1,5 +1,6 @@
 #include "Metrics/Reporter.h"
 #include "MockSink.h"
+#include <algorithm>
 #include <chrono>
 #include <gtest/gtest.h>
 
@@ -22,6 +23,33 @@ private:
   LogTo SinkType;
 };
 
+/// Records the names and values of the reported metrics and when the sink was
+/// flushed.
+class RecordingSink : public Sink {
+public:
+  explicit RecordingSink(bool Healthy = true) : Healthy(Healthy){};
+  void reportMetric(InternalMetric &MetricToBeReported) override {
+    std::lock_guard<std::mutex> Lock(EventsMutex);
+    Events.push_back(MetricToBeReported.FullName + " " +
+                     std::to_string(MetricToBeReported.MetricPtr->value()));
+  };
+  void flush() override {
+    std::lock_guard<std::mutex> Lock(EventsMutex);
+    Events.emplace_back("flush");
+  };
+  LogTo getType() override { return LogTo::CARBON; };
+  bool isHealthy() override { return Healthy; };
+  std::vector<std::string> getEvents() {
+    std::lock_guard<std::mutex> Lock(EventsMutex);
+    return Events;
+  }
+  std::atomic_bool Healthy;
+
+private:
+  std::mutex EventsMutex;
+  std::vector<std::string> Events;
+};
+
 // cppcheck-suppress syntaxError
 TEST(MetricsReporterTest,
      MetricSuccessfullyAddedCanBeRemovedUsingSameFullName) {
@@ -101,4 +129,42 @@ TEST(MetricsReporterTest, DoesNotReportMetricsIfSinkIsNotHealthy) {
   TestReporter.tryRemoveMetric(FullName);
 }
 
+TEST(MetricsReporterTest, SinkIsFlushedOncePerReportPeriod) {
+  Metric TestMetric("some_name", "Description", Severity::INFO);
+  auto TestSink = std::make_unique<RecordingSink>();
+  auto TestRecordingSink = TestSink.get();
+  Reporter TestReporter(std::move(TestSink), 10ms);
+
+  std::string const FullName = "some_prefix.some_name";
+  TestReporter.addMetric(TestMetric, FullName);
+  std::this_thread::sleep_for(100ms);
+  TestReporter.tryRemoveMetric(FullName);
+
+  auto Events = TestRecordingSink->getEvents();
+  auto NrOfFlushes = std::count(Events.begin(), Events.end(), "flush");
+  EXPECT_GE(NrOfFlushes, 2);
+  for (size_t i = 1; i < Events.size(); ++i) {
+    EXPECT_FALSE(Events[i] != "flush" and Events[i - 1] != "flush")
+        << "Metric reported twice without a flush in between.";
+  }
+}
+
+TEST(MetricsReporterTest, DroppedBatchesAreReportedWithStatisticsPrefix) {
+  auto TestSink = std::make_unique<RecordingSink>(false);
+  auto TestRecordingSink = TestSink.get();
+  Reporter TestReporter(std::move(TestSink), 10ms, "test.reporter");
+
+  std::this_thread::sleep_for(50ms);
+  EXPECT_TRUE(TestRecordingSink->getEvents().empty());
+  TestRecordingSink->Healthy = true;
+  std::this_thread::sleep_for(50ms);
+
+  auto Events = TestRecordingSink->getEvents();
+  ASSERT_FALSE(Events.empty());
+  auto const &Reported = Events.front();
+  std::string const ExpectedName = "test.reporter.dropped_batches ";
+  ASSERT_EQ(Reported.substr(0, ExpectedName.size()), ExpectedName);
+  EXPECT_GT(std::stol(Reported.substr(ExpectedName.size())), 0);
+}
+
 } // namespace Metrics
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "Kafka/RecordingConsumer.h"
+#include "Kafka/ReplayConsumer.h"
+#include "helpers/TemporaryDirectory.h"
+#include <gtest/gtest.h>
+
+namespace {
+/// Returns messages with offsets 0 - 9 (partition 2) with the offset as the
+/// message content.
+class FakeConsumer : public Kafka::StubConsumer {
+public:
+  std::pair<Kafka::PollStatus, FileWriter::Msg> poll() override {
+    if (NextOffset == 10) {
+      return {Kafka::PollStatus::TimedOut, FileWriter::Msg()};
+    }
+    FileWriter::MessageMetaData MetaData{
+        std::chrono::milliseconds(1000 + NextOffset * 10),
+        RdKafka::MessageTimestamp::MSG_TIMESTAMP_CREATE_TIME, NextOffset, 2};
+    auto Data = static_cast<std::uint8_t>(NextOffset++);
+    return {Kafka::PollStatus::Message, FileWriter::Msg(&Data, 1, MetaData)};
+  }
+  int64_t NextOffset{0};
+};
+} // namespace
+
+class ReplayConsumerTest : public ::testing::Test {
+public:
+  void SetUp() override {
+    Kafka::RecordingConsumer Recorder(std::make_unique<FakeConsumer>(),
+                                      RecordDirectory, 128);
+    Recorder.addTopic(TopicName);
+    for (int i = 0; i < 11; ++i) {
+      Recorder.poll();
+    }
+  }
+  TemporaryDirectory Directory{"replay_consumer_test"};
+  std::string RecordDirectory{Directory.filePath("recording")};
+  std::string const TopicName{"some_topic"};
+};
+
+TEST_F(ReplayConsumerTest, RecordedTopicsAndPartitions) {
+  EXPECT_EQ(Kafka::getRecordedTopics(RecordDirectory),
+            std::set<std::string>{TopicName});
+  EXPECT_EQ(Kafka::getRecordedPartitions(RecordDirectory, TopicName),
+            std::vector<int>{2});
+  EXPECT_GT(Kafka::getRecordedSegments(
+                Kafka::getRecordingDirectory(RecordDirectory, TopicName, 2))
+                .size(),
+            1u);
+}
+
+TEST_F(ReplayConsumerTest, ReplayAllMessages) {
+  Kafka::ReplayConsumer UnderTest(RecordDirectory);
+  UnderTest.addTopic(TopicName);
+  for (int64_t i = 0; i < 10; ++i) {
+    auto Result = UnderTest.poll();
+    ASSERT_EQ(Result.first, Kafka::PollStatus::Message);
+    auto const &MetaData = Result.second.getMetaData();
+    EXPECT_EQ(MetaData.Offset, i);
+    EXPECT_EQ(MetaData.Partition, 2);
+    EXPECT_EQ(MetaData.Timestamp.count(), 1000 + i * 10);
+    ASSERT_EQ(Result.second.size(), 1u);
+    EXPECT_EQ(Result.second.data()[0], i);
+  }
+  EXPECT_EQ(UnderTest.poll().first, Kafka::PollStatus::TimedOut);
+}
+
+TEST_F(ReplayConsumerTest, ReplayFromOffset) {
+  Kafka::ReplayConsumer UnderTest(RecordDirectory);
+  UnderTest.addPartitionAtOffset(TopicName, 2, 7);
+  for (int64_t i = 7; i < 10; ++i) {
+    auto Result = UnderTest.poll();
+    ASSERT_EQ(Result.first, Kafka::PollStatus::Message);
+    EXPECT_EQ(Result.second.getMetaData().Offset, i);
+  }
+  EXPECT_EQ(UnderTest.poll().first, Kafka::PollStatus::TimedOut);
+}
+
+TEST_F(ReplayConsumerTest, OffsetForTime) {
+  auto Offsets = Kafka::getRecordedOffsetsForTime(
+      RecordDirectory, TopicName, {2}, time_point(std::chrono::seconds(1)));
+  EXPECT_EQ(Offsets, (std::vector<std::pair<int, int64_t>>{{2, 0}}));
+  Offsets = Kafka::getRecordedOffsetsForTime(
+      RecordDirectory, TopicName, {2}, time_point(1045ms));
+  EXPECT_EQ(Offsets, (std::vector<std::pair<int, int64_t>>{{2, 5}}));
+  Offsets = Kafka::getRecordedOffsetsForTime(RecordDirectory, TopicName, {2},
+                                             time_point(10s));
+  EXPECT_EQ(Offsets, (std::vector<std::pair<int, int64_t>>{{2, 10}}));
+}
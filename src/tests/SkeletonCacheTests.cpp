@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "Filesystem.h"
+#include "SkeletonCache.h"
+#include "helpers/TemporaryDirectory.h"
+#include <fstream>
+#include <gtest/gtest.h>
+#include <h5cpp/hdf5.hpp>
+
+using FileWriter::SkeletonCache;
+using nlohmann::json;
+
+namespace {
+json createStructure(std::string const &Title, std::string const &NXClass) {
+  return json::parse(fmt::format(R""({{
+      "children": [
+        {{
+          "type": "group",
+          "name": "entry",
+          "attributes": {{"title": "{}", "NX_class": "{}"}}
+        }}
+      ]
+    }})"",
+                                 Title, NXClass));
+}
+} // namespace
+
+TEST(SkeletonCacheKey, KeyIsIndependentOfVolatileAttributes) {
+  SkeletonCache UnderTest("", {"title"});
+  EXPECT_EQ(UnderTest.getKey(createStructure("run 1", "NXentry")),
+            UnderTest.getKey(createStructure("run 2", "NXentry")));
+}
+
+TEST(SkeletonCacheKey, KeyDependsOnOtherAttributes) {
+  SkeletonCache UnderTest("", {"title"});
+  EXPECT_NE(UnderTest.getKey(createStructure("run 1", "NXentry")),
+            UnderTest.getKey(createStructure("run 1", "NXsubentry")));
+}
+
+TEST(SkeletonCacheKey, KeyDependsOnAttributesThatAreNotVolatile) {
+  SkeletonCache UnderTest("", {});
+  EXPECT_NE(UnderTest.getKey(createStructure("run 1", "NXentry")),
+            UnderTest.getKey(createStructure("run 2", "NXentry")));
+}
+
+TEST(SkeletonCacheKey, VolatileAttributesInArrayAreIgnored) {
+  SkeletonCache UnderTest("", {"title"});
+  auto createArrayStructure = [](std::string const &Title) {
+    return json::parse(fmt::format(R""({{
+        "children": [
+          {{
+            "type": "group",
+            "name": "entry",
+            "attributes": [
+              {{"name": "title", "values": "{}"}},
+              {{"name": "NX_class", "values": "NXentry"}}
+            ]
+          }}
+        ]
+      }})"",
+                                   Title));
+  };
+  EXPECT_EQ(UnderTest.getKey(createArrayStructure("run 1")),
+            UnderTest.getKey(createArrayStructure("run 2")));
+}
+
+TEST(SkeletonCacheKey, KeyDependsOnFileLayout) {
+  SkeletonCache UnderTest("", {"title"});
+  FileWriter::FileAccessProfile AlignedProfile;
+  AlignedProfile.Alignment = 4 * 1024 * 1024;
+  auto Structure = createStructure("run 1", "NXentry");
+  EXPECT_NE(UnderTest.getKey(Structure),
+            UnderTest.getKey(Structure, AlignedProfile));
+}
+
+namespace {
+json createStructureWithDataset(std::string const &StartTime) {
+  return json::parse(fmt::format(R""({{
+      "children": [
+        {{
+          "type": "group",
+          "name": "entry",
+          "attributes": {{"title": "run 1", "NX_class": "NXentry"}},
+          "children": [
+            {{
+              "type": "dataset",
+              "name": "start_time",
+              "dataset": {{"type": "string"}},
+              "values": "{}"
+            }}
+          ]
+        }}
+      ]
+    }})"",
+                                 StartTime));
+}
+} // namespace
+
+TEST(SkeletonCacheKey, KeyIsIndependentOfVolatileDatasets) {
+  SkeletonCache UnderTest("", {}, {"/entry/start_time"});
+  EXPECT_EQ(UnderTest.getKey(createStructureWithDataset("2020-01-01")),
+            UnderTest.getKey(createStructureWithDataset("2020-01-02")));
+}
+
+TEST(SkeletonCacheStructure, VolatileNodesAreRemoved) {
+  SkeletonCache UnderTest("", {"title"}, {"/entry/start_time"});
+  auto Skeleton =
+      UnderTest.getSkeletonStructure(createStructureWithDataset("2020-01-01"));
+  auto const &Entry = Skeleton["children"][0];
+  EXPECT_EQ(Entry["attributes"], json::parse(R"({"NX_class": "NXentry"})"));
+  EXPECT_TRUE(Entry["children"].empty());
+}
+
+class SkeletonCacheTest : public ::testing::Test {
+public:
+  void createSkeletonFile(SkeletonCache const &Cache, std::string const &Key) {
+    auto File = hdf5::file::create(Cache.getSkeletonPath(Key),
+                                   hdf5::file::AccessFlags::TRUNCATE);
+    auto Entry = File.root().create_group("entry");
+    Entry.attributes.create_from("title", std::string("run 1"));
+    Entry.attributes.create_from("NX_class", std::string("NXentry"));
+    File.root().attributes.create_from("file_name", std::string("skeleton"));
+  }
+
+  TemporaryDirectory Directory{"skeleton_cache_test"};
+  fs::path CacheDirectory{Directory.path()};
+  std::string FileName{Directory.filePath("file_from_skeleton.nxs")};
+};
+
+TEST_F(SkeletonCacheTest, KeyChangesWhenTemplateFileOfCopyNodeChanges) {
+  auto const TemplateFileName = (CacheDirectory / "template.nxs").string();
+  auto const Structure = json::parse(fmt::format(R""({{
+      "children": [
+        {{
+          "type": "copy",
+          "source_file": "{}",
+          "source_path": "/detector"
+        }}
+      ]
+    }})"",
+                                                 TemplateFileName));
+  SkeletonCache UnderTest(CacheDirectory.string(), {});
+  std::ofstream(TemplateFileName) << "geometry 1";
+  auto const KeyBefore = UnderTest.getKey(Structure);
+  EXPECT_EQ(UnderTest.getKey(Structure), KeyBefore);
+  std::ofstream(TemplateFileName) << "updated geometry 2";
+  EXPECT_NE(UnderTest.getKey(Structure), KeyBefore);
+}
+
+TEST_F(SkeletonCacheTest, FileIsCreatedWithVolatileAttributesOfStructure) {
+  SkeletonCache UnderTest(CacheDirectory.string(), {"title"});
+  auto Structure = createStructure("run 2", "NXentry");
+  auto Key = UnderTest.getKey(Structure);
+  EXPECT_FALSE(UnderTest.hasSkeleton(Key));
+  createSkeletonFile(UnderTest, Key);
+  EXPECT_TRUE(UnderTest.hasSkeleton(Key));
+
+  UnderTest.createFileFromSkeleton(Key, FileName, Structure);
+
+  auto File = hdf5::file::open(FileName, hdf5::file::AccessFlags::READONLY);
+  auto Entry = hdf5::node::get_group(File.root(), "entry");
+  std::string Title;
+  Entry.attributes["title"].read(Title);
+  EXPECT_EQ(Title, "run 2");
+  std::string NXClass;
+  Entry.attributes["NX_class"].read(NXClass);
+  EXPECT_EQ(NXClass, "NXentry");
+  std::string WrittenFileName;
+  File.root().attributes["file_name"].read(WrittenFileName);
+  EXPECT_NE(WrittenFileName, "skeleton");
+}
+
+TEST_F(SkeletonCacheTest, ExistingFileIsNotOverwritten) {
+  SkeletonCache UnderTest(CacheDirectory.string(), {"title"});
+  auto Structure = createStructure("run 2", "NXentry");
+  auto Key = UnderTest.getKey(Structure);
+  createSkeletonFile(UnderTest, Key);
+  UnderTest.createFileFromSkeleton(Key, FileName, Structure);
+  EXPECT_ANY_THROW(UnderTest.createFileFromSkeleton(Key, FileName, Structure));
+}
+
+TEST_F(SkeletonCacheTest, VolatileDatasetIsWrittenToFile) {
+  SkeletonCache UnderTest(CacheDirectory.string(), {}, {"/entry/start_time"});
+  auto Structure = createStructureWithDataset("2020-01-02");
+  auto Key = UnderTest.getKey(Structure);
+  createSkeletonFile(UnderTest, Key);
+
+  UnderTest.createFileFromSkeleton(Key, FileName, Structure);
+
+  auto File = hdf5::file::open(FileName, hdf5::file::AccessFlags::READONLY);
+  auto Entry = hdf5::node::get_group(File.root(), "entry");
+  ASSERT_TRUE(Entry.has_dataset("start_time"));
+  std::string StartTime;
+  hdf5::node::get_dataset(Entry, "start_time").read(StartTime);
+  EXPECT_EQ(StartTime, "2020-01-02");
+}
+
+TEST_F(SkeletonCacheTest, LeastRecentlyUsedSkeletonIsRemoved) {
+  SkeletonCache Unbounded(CacheDirectory.string(), {});
+  createSkeletonFile(Unbounded, "old");
+  createSkeletonFile(Unbounded, "new");
+  auto const SkeletonSize = fs::file_size(Unbounded.getSkeletonPath("new"));
+  fs::last_write_time(Unbounded.getSkeletonPath("old"),
+                      fs::file_time_type::clock::now() -
+                          std::chrono::hours(1));
+  SkeletonCache UnderTest(CacheDirectory.string(), {}, {}, SkeletonSize);
+  UnderTest.removeLeastRecentlyUsed("new");
+  EXPECT_FALSE(UnderTest.hasSkeleton("old"));
+  EXPECT_TRUE(UnderTest.hasSkeleton("new"));
+}
+
+TEST_F(SkeletonCacheTest, SkeletonToKeepIsNotRemoved) {
+  SkeletonCache Unbounded(CacheDirectory.string(), {});
+  createSkeletonFile(Unbounded, "only");
+  SkeletonCache UnderTest(CacheDirectory.string(), {}, {}, 1);
+  UnderTest.removeLeastRecentlyUsed("only");
+  EXPECT_TRUE(UnderTest.hasSkeleton("only"));
+}
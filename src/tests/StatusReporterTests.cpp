@@ -9,6 +9,7 @@
 
 #include "Status/StatusReporterBase.h"
 #include "helpers/StatusHelpers.h"
+#include "json.h"
 #include <flatbuffers/flatbuffers.h>
 #include <gtest/gtest.h>
 #include <memory>
@@ -120,3 +121,77 @@ TEST_F(StatusReporterTests, ResettingValuesClearsValuesSet) {
   ASSERT_EQ(StatusMsg.first.StartTime.count(), 0);
   ASSERT_EQ(toMilliSeconds(StatusMsg.first.StopTime), 0);
 }
+
+TEST_F(StatusReporterTests, ConsumerLagIsReportedInSeconds) {
+  Status::JobPerformanceInfo Info;
+  Info.ConsumerLag = 2500ms;
+  ReporterPtr->updatePerformanceInfo(Info);
+  auto JSONReport = nlohmann::json::parse(ReporterPtr->createJSONReport());
+  EXPECT_DOUBLE_EQ(
+      JSONReport["performance"]["seconds_behind"].get<double>(), 2.5);
+
+  ReporterPtr->resetStatusInfo();
+  JSONReport = nlohmann::json::parse(ReporterPtr->createJSONReport());
+  EXPECT_DOUBLE_EQ(
+      JSONReport["performance"]["seconds_behind"].get<double>(), 0.0);
+}
+
+TEST_F(StatusReporterTests, PerformanceInfoIsReported) {
+  Status::JobPerformanceInfo Info;
+  Info.QueueDepth = 12;
+  Info.WriteErrors = 3;
+  Info.WriteErrorsPerStream = {{"motor_f142", 2}, {"unknown", 1}};
+  Info.BytesOnDisk = 4096;
+  ReporterPtr->updatePerformanceInfo(Info);
+  auto JSONReport = nlohmann::json::parse(ReporterPtr->createJSONReport());
+  auto const &Performance = JSONReport["performance"];
+  EXPECT_EQ(Performance["queue_depth"].get<int64_t>(), 12);
+  EXPECT_EQ(Performance["write_errors"].get<int64_t>(), 3);
+  EXPECT_EQ(Performance["write_errors_per_stream"]["motor_f142"].get<int64_t>(),
+            2);
+  EXPECT_EQ(Performance["write_errors_per_stream"]["unknown"].get<int64_t>(),
+            1);
+  EXPECT_EQ(Performance["bytes_on_disk"].get<uint64_t>(), 4096u);
+}
+
+TEST_F(StatusReporterTests, WriteRatesAreCalculatedSincePreviousReport) {
+  Status::JobPerformanceInfo Info;
+  Info.MessagesWritten = 100;
+  Info.BytesWritten = 10000;
+  ReporterPtr->updatePerformanceInfo(Info);
+  ReporterPtr->createJSONReport();
+
+  ReporterPtr->updatePerformanceInfo(Info);
+  auto JSONReport = nlohmann::json::parse(ReporterPtr->createJSONReport());
+  EXPECT_DOUBLE_EQ(
+      JSONReport["performance"]["messages_per_second"].get<double>(), 0.0);
+  EXPECT_DOUBLE_EQ(JSONReport["performance"]["bytes_per_second"].get<double>(),
+                   0.0);
+
+  Info.MessagesWritten = 200;
+  Info.BytesWritten = 20000;
+  ReporterPtr->updatePerformanceInfo(Info);
+  JSONReport = nlohmann::json::parse(ReporterPtr->createJSONReport());
+  EXPECT_GT(JSONReport["performance"]["messages_per_second"].get<double>(),
+            0.0);
+  EXPECT_GT(JSONReport["performance"]["bytes_per_second"].get<double>(), 0.0);
+}
+
+TEST_F(StatusReporterTests, FileMovesAreReportedAfterReset) {
+  Status::FileMoveInfo Move;
+  Move.Source = "/scratch/file1.nxs";
+  Move.Destination = "/data/file1.nxs";
+  Move.State = "moving";
+  Move.BytesMoved = 1024;
+  Move.Size = 4096;
+  ReporterPtr->updateFileMoves({Move});
+  ReporterPtr->resetStatusInfo();
+  auto JSONReport = nlohmann::json::parse(ReporterPtr->createJSONReport());
+  ASSERT_EQ(JSONReport["file_moves"].size(), 1u);
+  auto const &MoveReport = JSONReport["file_moves"][0];
+  EXPECT_EQ(MoveReport["destination"].get<std::string>(), "/data/file1.nxs");
+  EXPECT_EQ(MoveReport["state"].get<std::string>(), "moving");
+  EXPECT_EQ(MoveReport["bytes_moved"].get<uint64_t>(), 1024u);
+  EXPECT_EQ(MoveReport["size"].get<uint64_t>(), 4096u);
+  EXPECT_EQ(MoveReport.find("error"), MoveReport.end());
+}
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "Filesystem.h"
+#include "Stream/MessageSpool.h"
+#include "helpers/SetExtractorModule.h"
+#include "helpers/TemporaryDirectory.h"
+#include <array>
+#include <gtest/gtest.h>
+
+namespace {
+class SpoolFbReader : public FileWriter::FlatbufferReader {
+  bool verify(FileWriter::FlatbufferMessage const &) const override {
+    return true;
+  }
+
+  std::string
+  source_name(FileWriter::FlatbufferMessage const &) const override {
+    return "some_name";
+  }
+
+  uint64_t timestamp(FileWriter::FlatbufferMessage const &Msg) const override {
+    return Msg.data()[8];
+  }
+};
+} // namespace
+
+class MessageSpoolTest : public ::testing::Test {
+public:
+  void SetUp() override { setExtractorModule<SpoolFbReader>("spoo"); }
+  Stream::Message createMessage(std::uint8_t Value) {
+    std::array<std::uint8_t, 9> Data{'x', 'x', 'x', 'x', 's',
+                                     'p', 'o', 'o', Value};
+    return {reinterpret_cast<Stream::Message::DestPtrType>(0x1234),
+            FileWriter::FlatbufferMessage(Data.data(), Data.size())};
+  }
+  TemporaryDirectory Directory{"message_spool_test"};
+  std::string SpoolDirectory{Directory.filePath("spool")};
+};
+
+TEST_F(MessageSpoolTest, EmptySpoolHasNoMessages) {
+  Stream::MessageSpool UnderTest(SpoolDirectory, 1024);
+  EXPECT_FALSE(UnderTest.readNext(
+      [](WriterModule::Base *, FileWriter::FlatbufferMessage const &,
+         time_point) {
+        FAIL() << "Handler should not be called.";
+      }));
+}
+
+TEST_F(MessageSpoolTest, MessagesAreReadBackInOrder) {
+  Stream::MessageSpool UnderTest(SpoolDirectory, 1024);
+  for (std::uint8_t i = 1; i < 10; ++i) {
+    EXPECT_TRUE(UnderTest.append(createMessage(i)));
+  }
+  std::uint64_t ExpectedTimestamp{1};
+  while (UnderTest.readNext(
+      [&ExpectedTimestamp](WriterModule::Base *Destination,
+                           FileWriter::FlatbufferMessage const &Msg,
+                           time_point) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(Destination), 0x1234u);
+        EXPECT_EQ(Msg.getSourceName(), "some_name");
+        EXPECT_EQ(Msg.size(), 9u);
+        EXPECT_EQ(Msg.getTimestamp(), ExpectedTimestamp);
+        ++ExpectedTimestamp;
+      })) {
+  }
+  EXPECT_EQ(ExpectedTimestamp, 10u);
+}
+
+TEST_F(MessageSpoolTest, AppendTimeIsReadBack) {
+  Stream::MessageSpool UnderTest(SpoolDirectory, 1024);
+  auto const Before = system_clock::now();
+  EXPECT_TRUE(UnderTest.append(createMessage(1)));
+  auto const After = system_clock::now();
+  time_point AppendTime;
+  EXPECT_TRUE(UnderTest.readNext(
+      [&AppendTime](WriterModule::Base *, FileWriter::FlatbufferMessage const &,
+                    time_point Time) { AppendTime = Time; }));
+  EXPECT_GE(AppendTime, Before);
+  EXPECT_LE(AppendTime, After);
+}
+
+TEST_F(MessageSpoolTest, ReadSegmentsAreRemoved) {
+  auto SegmentSize = Stream::SpoolSegment::recordSize(9) * 2;
+  Stream::MessageSpool UnderTest(SpoolDirectory, SegmentSize);
+  for (std::uint8_t i = 1; i < 7; ++i) {
+    EXPECT_TRUE(UnderTest.append(createMessage(i)));
+  }
+  EXPECT_EQ(UnderTest.nrOfSegments(), 3u);
+  auto Ignore = [](WriterModule::Base *,
+                   FileWriter::FlatbufferMessage const &, time_point) {};
+  while (UnderTest.readNext(Ignore)) {
+  }
+  EXPECT_EQ(UnderTest.nrOfSegments(), 1u);
+  EXPECT_EQ(std::distance(fs::directory_iterator(SpoolDirectory),
+                          fs::directory_iterator()),
+            1);
+}
+
+TEST_F(MessageSpoolTest, LargeMessageGetsLargerSegment) {
+  Stream::MessageSpool UnderTest(SpoolDirectory, 16);
+  EXPECT_TRUE(UnderTest.append(createMessage(1)));
+  int NrOfMessages{0};
+  while (UnderTest.readNext(
+      [&NrOfMessages](WriterModule::Base *,
+                      FileWriter::FlatbufferMessage const &, time_point) {
+        ++NrOfMessages;
+      })) {
+  }
+  EXPECT_EQ(NrOfMessages, 1);
+}
+
+TEST_F(MessageSpoolTest, SpoolDirectoryIsRemovedOnDestruction) {
+  {
+    Stream::MessageSpool UnderTest(SpoolDirectory, 1024);
+    UnderTest.append(createMessage(1));
+    EXPECT_TRUE(fs::exists(SpoolDirectory));
+  }
+  EXPECT_FALSE(fs::exists(SpoolDirectory));
+}
+
+TEST_F(MessageSpoolTest, ZeroFilledEndOfUntruncatedSegmentIsNotRead) {
+  fs::create_directories(SpoolDirectory);
+  auto const SegmentPath = (fs::path(SpoolDirectory) / "segment").string();
+  std::array<std::uint8_t, 9> Data{};
+  Stream::SpoolRecordHeader Header;
+  Header.Size = Data.size();
+  Stream::SpoolSegment Writer(SegmentPath, 4096, true);
+  ASSERT_TRUE(Writer.append(Header, Data.data()));
+  ASSERT_TRUE(Writer.append(Header, Data.data()));
+
+  // The writer has not truncated the file yet.
+  Stream::SpoolSegment Reader(SegmentPath);
+  EXPECT_EQ(Reader.capacity(), 4096u);
+  EXPECT_EQ(Reader.committedBytes(), 2 * Stream::SpoolSegment::recordSize(9));
+  size_t Position{0};
+  std::uint8_t const *ReadData{nullptr};
+  EXPECT_TRUE(Reader.readRecord(Position, Header, ReadData));
+  EXPECT_TRUE(Reader.readRecord(Position, Header, ReadData));
+  EXPECT_FALSE(Reader.readRecord(Position, Header, ReadData));
+}
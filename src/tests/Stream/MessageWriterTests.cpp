@@ -7,11 +7,14 @@
 //
 // Screaming Udder!                              https://esss.se
 
+#include "Filesystem.h"
 #include "Metrics/Registrar.h"
 #include "Stream/MessageWriter.h"
 #include "WriterModuleBase.h"
 #include "helpers/SetExtractorModule.h"
+#include "helpers/TemporaryDirectory.h"
 #include <array>
+#include <future>
 #include <gtest/gtest.h>
 #include <trompeloeil.hpp>
 
@@ -26,11 +29,33 @@ public:
 
 class DataMessageWriterStandIn : public Stream::MessageWriter {
 public:
-  explicit DataMessageWriterStandIn(Metrics::Registrar const &Registrar)
-      : MessageWriter([]() {}, 1s, Registrar) {}
+  explicit DataMessageWriterStandIn(
+      Metrics::Registrar const &Registrar,
+      Stream::SpoolSettings const &Spooling = {})
+      : MessageWriter([]() {}, 1s, Registrar, Spooling) {}
   using Stream::MessageWriter::WriteJobs;
 };
 
+class FlushCountingMessageWriter : public Stream::MessageWriter {
+public:
+  explicit FlushCountingMessageWriter(Metrics::Registrar const &Registrar)
+      : MessageWriter([this]() { ++NrOfFileFlushes; }, 1h, Registrar) {}
+  using Stream::MessageWriter::flushData;
+  using Stream::MessageWriter::SourceLatencies;
+  using Stream::MessageWriter::WriteJobs;
+  std::atomic<int> NrOfFileFlushes{0};
+
+  /// Run a job on the writer thread and wait for it to finish.
+  void runOnWriterThread(std::function<void()> Job) {
+    std::promise<void> Done;
+    WriteJobs.enqueue([&Job, &Done]() {
+      Job();
+      Done.set_value();
+    });
+    Done.get_future().wait();
+  }
+};
+
 class DataMessageWriterTest : public ::testing::Test {
 public:
   WriterModuleStandIn WriterModule;
@@ -112,3 +137,127 @@ TEST_F(DataMessageWriterTest, WriteMessageExceptionKnownFb) {
     });
   }
 }
+
+TEST_F(DataMessageWriterTest, WriteSpooledMessage) {
+  REQUIRE_CALL(WriterModule, write(_)).TIMES(1);
+  std::array<uint8_t, 9> SomeData{'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x'};
+  setExtractorModule<xxxFbReader>("xxxx");
+  FileWriter::FlatbufferMessage Msg(SomeData.data(), SomeData.size());
+  Stream::Message SomeMessage(
+      reinterpret_cast<Stream::Message::DestPtrType>(&WriterModule), Msg);
+  TemporaryDirectory Directory{"message_writer_test"};
+  auto const SpoolDirectory = Directory.filePath("spool");
+  {
+    Stream::MessageWriter Writer([]() {}, 1s, MetReg, {SpoolDirectory, 1024});
+    Writer.addMessage(SomeMessage);
+  }
+  EXPECT_FALSE(fs::exists(SpoolDirectory));
+}
+
+TEST_F(DataMessageWriterTest, SpooledMessageIsCountedInQueueDepth) {
+  REQUIRE_CALL(WriterModule, write(_)).TIMES(1);
+  std::array<uint8_t, 9> SomeData{'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x'};
+  setExtractorModule<xxxFbReader>("xxxx");
+  FileWriter::FlatbufferMessage Msg(SomeData.data(), SomeData.size());
+  Stream::Message SomeMessage(
+      reinterpret_cast<Stream::Message::DestPtrType>(&WriterModule), Msg);
+  TemporaryDirectory Directory{"message_writer_test"};
+  auto const SpoolDirectory = Directory.filePath("spool");
+  {
+    DataMessageWriterStandIn Writer{MetReg, {SpoolDirectory, 1024}};
+    std::promise<void> Blocked;
+    std::promise<void> Release;
+    Writer.WriteJobs.enqueue([&Blocked, &Release]() {
+      Blocked.set_value();
+      Release.get_future().wait();
+    });
+    Blocked.get_future().wait();
+    Writer.addMessage(SomeMessage);
+    EXPECT_EQ(Writer.queueDepth(), 1);
+    Release.set_value();
+    Writer.WriteJobs.enqueue([&Writer]() {
+      EXPECT_EQ(Writer.queueDepth(), 0);
+      EXPECT_EQ(Writer.nrOfWritesDone(), 1);
+    });
+  }
+}
+
+TEST_F(DataMessageWriterTest, MemoryLimitIsCheckedAfterReturnedNrOfBytes) {
+  REQUIRE_CALL(WriterModule, write(_)).TIMES(3);
+  std::array<uint8_t, 9> SomeData{'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x'};
+  setExtractorModule<xxxFbReader>("xxxx");
+  FileWriter::FlatbufferMessage Msg(SomeData.data(), SomeData.size());
+  Stream::Message SomeMessage(
+      reinterpret_cast<Stream::Message::DestPtrType>(&WriterModule), Msg);
+  int NrOfChecks{0};
+  {
+    Stream::MessageWriter Writer([]() {}, 1s, MetReg, {}, [&NrOfChecks]() {
+      ++NrOfChecks;
+      return std::size_t{10};
+    });
+    for (int i = 0; i < 3; ++i) {
+      Writer.addMessage(SomeMessage);
+    }
+  }
+  // Checked when writing the first message and when more than 10 bytes have
+  // been written since.
+  EXPECT_EQ(NrOfChecks, 2);
+}
+
+TEST_F(DataMessageWriterTest, LatencyIsAddedToHistogramOfSource) {
+  REQUIRE_CALL(WriterModule, write(_)).TIMES(3);
+  setExtractorModule<xxxFbReader>("xxxx");
+  FileWriter::FlatbufferReaderRegistry::Registrar<xxxFbReader> RegisterIt(
+      "xxxy");
+  std::array<uint8_t, 9> SomeData{'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x'};
+  std::array<uint8_t, 9> OtherData{'x', 'x', 'x', 'x', 'x', 'x', 'x', 'y', 'x'};
+  auto const KafkaTime = std::chrono::milliseconds(1);
+  FileWriter::FlatbufferMessage Msg(SomeData.data(), SomeData.size(),
+                                    FileWriter::VerificationLevel::FULL,
+                                    KafkaTime);
+  FileWriter::FlatbufferMessage OtherMsg(OtherData.data(), OtherData.size(),
+                                         FileWriter::VerificationLevel::FULL,
+                                         KafkaTime);
+  auto const DestPtr =
+      reinterpret_cast<Stream::Message::DestPtrType>(&WriterModule);
+  FlushCountingMessageWriter Writer{MetReg};
+  Writer.addMessage({DestPtr, Msg});
+  Writer.addMessage({DestPtr, Msg});
+  Writer.addMessage({DestPtr, OtherMsg});
+  Writer.runOnWriterThread([&]() {
+    EXPECT_EQ(Writer.SourceLatencies.size(), 2u);
+    EXPECT_EQ(Writer.SourceLatencies.count(Msg.getSourceHash()), 1u);
+    EXPECT_EQ(Writer.SourceLatencies.count(OtherMsg.getSourceHash()), 1u);
+  });
+}
+
+TEST_F(DataMessageWriterTest, FileIsOnlyFlushedAfterWrites) {
+  ALLOW_CALL(WriterModule, write(_));
+  FileWriter::FlatbufferMessage Msg;
+  Stream::Message SomeMessage(
+      reinterpret_cast<Stream::Message::DestPtrType>(&WriterModule), Msg);
+  FlushCountingMessageWriter Writer{MetReg};
+  Writer.runOnWriterThread([&Writer]() { Writer.flushData(); });
+  EXPECT_EQ(Writer.NrOfFileFlushes, 0);
+  Writer.addMessage(SomeMessage);
+  Writer.runOnWriterThread([&Writer]() {
+    Writer.flushData();
+    Writer.flushData();
+  });
+  EXPECT_EQ(Writer.NrOfFileFlushes, 1);
+}
+
+TEST_F(DataMessageWriterTest, ModuleWithFlushIntervalIsFlushedLessOften) {
+  ALLOW_CALL(WriterModule, config_post_processing());
+  ALLOW_CALL(WriterModule, write(_));
+  WriterModule.parse_config(R"({"flush_interval": 3600})");
+  FileWriter::FlatbufferMessage Msg;
+  Stream::Message SomeMessage(
+      reinterpret_cast<Stream::Message::DestPtrType>(&WriterModule), Msg);
+  FlushCountingMessageWriter Writer{MetReg};
+  Writer.addMessage(SomeMessage);
+  Writer.runOnWriterThread([&Writer]() { Writer.flushData(); });
+  Writer.addMessage(SomeMessage);
+  Writer.runOnWriterThread([&Writer]() { Writer.flushData(); });
+  EXPECT_EQ(Writer.NrOfFileFlushes, 1);
+}
@@ -8,6 +8,7 @@
 // Screaming Udder!                              https://esss.se
 
 #include "FlatbufferReader.h"
+#include "MemoryAccountant.h"
 #include "Metrics/Registrar.h"
 #include "Stream/MessageWriter.h"
 #include "Stream/Partition.h"
@@ -55,10 +56,11 @@ public:
                    Stream::SrcToDst const &Map, Stream::MessageWriter *Writer,
                    Metrics::Registrar RegisterMetric, time_point Start,
                    time_point Stop, duration StopLeeway,
-                   duration KafkaErrorTimeout)
+                   duration KafkaErrorTimeout,
+                   Stream::VerificationSettings const &Verification = {})
       : Stream::Partition(std::move(Consumer), Partition, std::move(TopicName),
                           Map, Writer, std::move(RegisterMetric), Start, Stop,
-                          StopLeeway, KafkaErrorTimeout) {}
+                          StopLeeway, KafkaErrorTimeout, Verification) {}
   void addPollTask() override {
     // Do nothing as don't want to automatically poll again
   }
@@ -68,6 +70,8 @@ public:
   using Partition::forceStop;
   using Partition::KafkaErrors;
   using Partition::KafkaTimeouts;
+  using Partition::LagMessages;
+  using Partition::LagUpdateInterval;
   using Partition::MessagesProcessed;
   using Partition::MessagesReceived;
   using Partition::MsgFilters;
@@ -75,6 +79,20 @@ public:
   using Partition::processMessage;
   using Partition::StopTime;
   using Partition::StopTimeLeeway;
+  using Partition::UnknownFlatbufferIdErrors;
+  using Partition::updateLag;
+  using Partition::VerificationReverts;
+  using Partition::Verifier;
+};
+
+class LaggingConsumer : public Kafka::MockConsumer {
+public:
+  explicit LaggingConsumer(int64_t HighWatermark)
+      : MockConsumer(Kafka::BrokerSettings()), HighWatermark(HighWatermark) {}
+  std::optional<int64_t> getHighWatermark(std::string const &, int) override {
+    return HighWatermark;
+  }
+  int64_t HighWatermark;
 };
 
 void waitUntilDoneProcessing(PartitionStandIn *UnderTest) {
@@ -100,12 +118,14 @@ protected:
 
 class PartitionTest : public ::testing::Test {
 public:
-  auto createTestedInstance(time_point StopTime = time_point::max()) {
+  auto createTestedInstance(
+      time_point StopTime = time_point::max(),
+      Stream::VerificationSettings const &Verification = {}) {
     Kafka::BrokerSettings BrokerSettingsForTest;
     auto Temp = std::make_unique<PartitionStandIn>(
         std::make_unique<Kafka::MockConsumer>(BrokerSettingsForTest),
         UsedPartitionId, TopicName, UsedMap, nullptr, Registrar, Start,
-        StopTime, StopLeeway, ErrorTimeout);
+        StopTime, StopLeeway, ErrorTimeout, Verification);
     Stop = StopTime;
     Consumer = dynamic_cast<Kafka::MockConsumer *>(Temp->ConsumerPtr.get());
     return Temp;
@@ -252,6 +272,19 @@ TEST_F(PartitionTest, ForceStopStops) {
   EXPECT_TRUE(UnderTest->hasFinished());
 }
 
+TEST_F(PartitionTest, StopTimeIsCheckedWhileThrottled) {
+  auto &Accountant = FileWriter::MemoryAccountant::getInstance();
+  auto const OldLimit = Accountant.getLimit();
+  Accountant.setLimit(1);
+  Accountant.add(10);
+  auto UnderTest = createTestedInstance(Start - StopLeeway - 1s);
+  FORBID_CALL(*Consumer, poll());
+  UnderTest->pollForMessage();
+  EXPECT_TRUE(UnderTest->hasFinished());
+  Accountant.remove(10);
+  Accountant.setLimit(OldLimit);
+}
+
 TEST_F(PartitionTest, FiltersAreInitialisedWithOriginalStoptime) {
   auto StopTime = Start + 100s;
   auto UnderTest = createTestedInstance(StopTime);
@@ -300,6 +333,29 @@ TEST_F(PartitionTest, IfSourceHashIsKnownThenItIsProcessed) {
   EXPECT_EQ(int(UnderTest->MessagesProcessed), 1);
 }
 
+TEST_F(PartitionTest, UnknownFlatbufferIdDoesNotRevertVerification) {
+  auto UnderTest = createTestedInstance(time_point::max(), {0, 4});
+  UnderTest->MsgFilters.clear();
+  setExtractorModule<zzzzFbReader>("zzzz");
+  std::array<char, 9> UnknownIdData{'z', 'z', 'z', 'z', 'y',
+                                    'y', 'y', 'y', 'y'};
+  FileWriter::Msg Msg(UnknownIdData.data(), UnknownIdData.size());
+  UnderTest->processMessage(Msg);
+  EXPECT_EQ(int(UnderTest->UnknownFlatbufferIdErrors), 1);
+  EXPECT_EQ(int(UnderTest->VerificationReverts), 0);
+  EXPECT_TRUE(UnderTest->Verifier.isSampling());
+}
+
+TEST_F(PartitionTest, TooSmallBufferRevertsVerification) {
+  auto UnderTest = createTestedInstance(time_point::max(), {0, 4});
+  UnderTest->MsgFilters.clear();
+  setExtractorModule<zzzzFbReader>("zzzz");
+  FileWriter::Msg Msg(SomeData.data(), 4);
+  UnderTest->processMessage(Msg);
+  EXPECT_EQ(int(UnderTest->VerificationReverts), 1);
+  EXPECT_FALSE(UnderTest->Verifier.isSampling());
+}
+
 TEST_F(PartitionTest, FilterNotRemovedIfNotDone) {
   auto UnderTest = createTestedInstance();
   auto TestFilter = std::make_unique<SourceFilterStandInAlt>();
@@ -479,3 +535,67 @@ TEST_F(PartitionTest, PartitionHasFinishedIfAllItsFiltersHaveFinished) {
   UnderTest->pollForMessage();
   EXPECT_TRUE(UnderTest->hasFinished());
 }
+
+class PartitionLagTest : public PartitionTest {
+public:
+  auto createLaggingInstance(int64_t HighWatermark) {
+    return std::make_unique<PartitionStandIn>(
+        std::make_unique<LaggingConsumer>(HighWatermark), UsedPartitionId,
+        TopicName, UsedMap, nullptr, Registrar, Start, Stop, StopLeeway,
+        ErrorTimeout);
+  }
+  void processMessageAtOffset(PartitionStandIn &UnderTest, int64_t Offset,
+                              time_point Timestamp) {
+    FileWriter::MessageMetaData MetaData{
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            Timestamp.time_since_epoch()),
+        RdKafka::MessageTimestamp::MSG_TIMESTAMP_CREATE_TIME, Offset, 0};
+    UnderTest.processMessage(
+        FileWriter::Msg{SomeData.data(), SomeData.size(), MetaData});
+  }
+};
+
+TEST_F(PartitionLagTest, NoLagBeforeFirstMessage) {
+  auto UnderTest = createLaggingInstance(100);
+  UnderTest->updateLag();
+  EXPECT_EQ(UnderTest->LagMessages.value(), 0);
+  EXPECT_EQ(UnderTest->getLagTime(), 0ms);
+}
+
+TEST_F(PartitionLagTest, LagIsMessagesAndAgeOfLastMessage) {
+  auto UnderTest = createLaggingInstance(100);
+  processMessageAtOffset(*UnderTest, 10,
+                         std::chrono::system_clock::now() - 5s);
+  UnderTest->updateLag();
+  EXPECT_EQ(UnderTest->LagMessages.value(), 89);
+  EXPECT_GE(UnderTest->getLagTime(), 5s);
+  EXPECT_LT(UnderTest->getLagTime(), 10s);
+}
+
+TEST_F(PartitionLagTest, SparsePartitionLagIsNotAgeOfLastMessage) {
+  auto Consumer = std::make_unique<LaggingConsumer>(11);
+  auto ConsumerPtr = Consumer.get();
+  auto UnderTest = std::make_unique<PartitionStandIn>(
+      std::move(Consumer), UsedPartitionId, TopicName, UsedMap, nullptr,
+      Registrar, Start, Stop, StopLeeway, ErrorTimeout);
+  UnderTest->LagUpdateInterval = 0s;
+  auto const HourAgo = std::chrono::system_clock::now() - std::chrono::hours(1);
+  processMessageAtOffset(*UnderTest, 10, HourAgo);
+  UnderTest->updateLag();
+  EXPECT_EQ(UnderTest->getLagTime(), 0ms);
+
+  // A new message after an hour of silence.
+  ConsumerPtr->HighWatermark = 12;
+  UnderTest->updateLag();
+  EXPECT_EQ(UnderTest->LagMessages.value(), 1);
+  EXPECT_LT(UnderTest->getLagTime(), 5s);
+}
+
+TEST_F(PartitionLagTest, NoLagWhenCaughtUp) {
+  auto UnderTest = createLaggingInstance(11);
+  processMessageAtOffset(*UnderTest, 10,
+                         std::chrono::system_clock::now() - 5s);
+  UnderTest->updateLag();
+  EXPECT_EQ(UnderTest->LagMessages.value(), 0);
+  EXPECT_EQ(UnderTest->getLagTime(), 0ms);
+}
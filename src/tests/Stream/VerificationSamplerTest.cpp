@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "Stream/VerificationSampler.h"
+#include <gtest/gtest.h>
+
+using FileWriter::VerificationLevel;
+
+TEST(VerificationSamplerTest, DefaultIsFullVerification) {
+  Stream::VerificationSampler UnderTest;
+  EXPECT_FALSE(UnderTest.isSampling());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(UnderTest.getNextLevel(), VerificationLevel::FULL);
+  }
+}
+
+TEST(VerificationSamplerTest, SampleIntervalOfOneIsFullVerification) {
+  Stream::VerificationSampler UnderTest({0, 1});
+  EXPECT_FALSE(UnderTest.isSampling());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(UnderTest.getNextLevel(), VerificationLevel::FULL);
+  }
+}
+
+TEST(VerificationSamplerTest, FirstMessagesAreFullyVerified) {
+  Stream::VerificationSampler UnderTest({3, 100});
+  EXPECT_TRUE(UnderTest.isSampling());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(UnderTest.getNextLevel(), VerificationLevel::FULL);
+  }
+  EXPECT_EQ(UnderTest.getNextLevel(), VerificationLevel::FULL);
+  EXPECT_EQ(UnderTest.getNextLevel(), VerificationLevel::BOUNDS_ONLY);
+}
+
+TEST(VerificationSamplerTest, OneInIntervalIsFullyVerified) {
+  Stream::VerificationSampler UnderTest({0, 4});
+  int FullVerifications{0};
+  for (int i = 0; i < 40; ++i) {
+    if (UnderTest.getNextLevel() == VerificationLevel::FULL) {
+      ++FullVerifications;
+    }
+  }
+  EXPECT_EQ(FullVerifications, 10);
+}
+
+TEST(VerificationSamplerTest, FailureRevertsToFullVerification) {
+  Stream::VerificationSampler UnderTest({0, 4});
+  EXPECT_TRUE(UnderTest.reportFailure());
+  EXPECT_FALSE(UnderTest.isSampling());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(UnderTest.getNextLevel(), VerificationLevel::FULL);
+  }
+}
+
+TEST(VerificationSamplerTest, FailureWhenNotSamplingIsNotReported) {
+  Stream::VerificationSampler UnderTest;
+  EXPECT_FALSE(UnderTest.reportFailure());
+}
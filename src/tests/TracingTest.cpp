@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "Tracing.h"
+#include "json.h"
+#include <algorithm>
+#include <future>
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace {
+size_t countEventsWithName(nlohmann::json const &Trace,
+                           std::string const &Name) {
+  return std::count_if(Trace["traceEvents"].begin(),
+                       Trace["traceEvents"].end(), [&Name](auto const &Event) {
+                         return Event["ph"] == "X" and Event["name"] == Name;
+                       });
+}
+
+size_t countThreads(nlohmann::json const &Trace) {
+  return std::count_if(
+      Trace["traceEvents"].begin(), Trace["traceEvents"].end(),
+      [](auto const &Event) { return Event["name"] == "thread_name"; });
+}
+} // namespace
+
+TEST(Tracing, ThreadBufferReturnsEventsInOrder) {
+  Tracing::ThreadBuffer UnderTest(0);
+  UnderTest.add("first", 10, 1);
+  UnderTest.add("second", 20, 2);
+  auto Events = UnderTest.getEvents();
+  ASSERT_EQ(Events.size(), 2u);
+  EXPECT_STREQ(Events[0].Name, "first");
+  EXPECT_EQ(Events[0].Start, 10);
+  EXPECT_EQ(Events[0].Duration, 1);
+  EXPECT_STREQ(Events[1].Name, "second");
+}
+
+TEST(Tracing, ThreadBufferKeepsOnlyTheMostRecentEvents) {
+  Tracing::ThreadBuffer UnderTest(0);
+  auto const NrOfEvents = Tracing::ThreadBuffer::Size + 10;
+  for (size_t i = 0; i < NrOfEvents; ++i) {
+    UnderTest.add("event", static_cast<std::int64_t>(i), 1);
+  }
+  auto Events = UnderTest.getEvents();
+  ASSERT_EQ(Events.size(), Tracing::ThreadBuffer::Size);
+  EXPECT_EQ(Events.front().Start, 10);
+  EXPECT_EQ(Events.back().Start, static_cast<std::int64_t>(NrOfEvents - 1));
+}
+
+TEST(Tracing, SpanIsRecordedWithItsDuration) {
+  auto const Before = Tracing::now();
+  { Tracing::Span TestSpan("span_is_recorded"); }
+  auto const After = Tracing::now();
+  auto Trace = nlohmann::json::parse(Tracing::toChromeTraceJSON());
+  auto const &Events = Trace["traceEvents"];
+  auto Span = std::find_if(Events.begin(), Events.end(), [](auto const &E) {
+    return E["name"] == "span_is_recorded";
+  });
+  ASSERT_NE(Span, Events.end());
+  EXPECT_EQ((*Span)["ph"], "X");
+  EXPECT_GE((*Span)["ts"].get<double>(), Before / 1000.0 - 0.001);
+  EXPECT_LE((*Span)["dur"].get<double>(), (After - Before) / 1000.0 + 0.001);
+}
+
+TEST(Tracing, SpansOfAllThreadsAreWritten) {
+  auto RecordSpans = []() {
+    for (int i = 0; i < 3; ++i) {
+      Tracing::Span TestSpan("spans_of_all_threads");
+    }
+  };
+  std::thread Thread1(RecordSpans);
+  std::thread Thread2(RecordSpans);
+  Thread1.join();
+  Thread2.join();
+  auto Trace = nlohmann::json::parse(Tracing::toChromeTraceJSON());
+  EXPECT_EQ(countEventsWithName(Trace, "spans_of_all_threads"), 6u);
+}
+
+TEST(Tracing, SpansOfExitedThreadAreWrittenOnce) {
+  std::thread([]() { Tracing::Span TestSpan("exited_thread"); }).join();
+  auto Trace = nlohmann::json::parse(Tracing::toChromeTraceJSON());
+  EXPECT_EQ(countEventsWithName(Trace, "exited_thread"), 1u);
+  Trace = nlohmann::json::parse(Tracing::toChromeTraceJSON());
+  EXPECT_EQ(countEventsWithName(Trace, "exited_thread"), 0u);
+}
+
+TEST(Tracing, NrOfThreadBuffersIsCapped) {
+  std::promise<void> Done;
+  std::shared_future<void> IsDone = Done.get_future();
+  std::vector<std::promise<void>> Recorded(Tracing::MaxNrOfThreadBuffers + 8);
+  std::vector<std::future<void>> IsRecorded;
+  std::vector<std::thread> Threads;
+  for (auto &CurrentRecorded : Recorded) {
+    IsRecorded.push_back(CurrentRecorded.get_future());
+    Threads.emplace_back([&CurrentRecorded, IsDone]() {
+      { Tracing::Span TestSpan("capped_buffers"); }
+      CurrentRecorded.set_value();
+      IsDone.wait();
+    });
+  }
+  for (auto &CurrentIsRecorded : IsRecorded) {
+    CurrentIsRecorded.wait();
+  }
+  auto Trace = nlohmann::json::parse(Tracing::toChromeTraceJSON());
+  Done.set_value();
+  for (auto &CurrentThread : Threads) {
+    CurrentThread.join();
+  }
+  EXPECT_LE(countThreads(Trace), Tracing::MaxNrOfThreadBuffers);
+  EXPECT_LT(countEventsWithName(Trace, "capped_buffers"), Recorded.size());
+}
@@ -23,6 +23,9 @@ public:
     IsRemovable = true;
   }
   bool isDoneWriting() override { return IsRemovable; }
+  Status::JobPerformanceInfo getPerformanceInfo() const override {
+    return {};
+  }
 
 private:
   std::string JobID;
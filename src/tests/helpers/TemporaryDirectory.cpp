@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#include "TemporaryDirectory.h"
+#include "helper.h"
+
+TemporaryDirectory::TemporaryDirectory(std::string const &Prefix)
+    : Path(fs::temp_directory_path() / (Prefix + "_" + randomHexString(8))) {
+  fs::create_directories(Path);
+}
+
+TemporaryDirectory::~TemporaryDirectory() {
+  std::error_code IgnoredError;
+  fs::remove_all(Path, IgnoredError);
+}
+
+std::string TemporaryDirectory::filePath(std::string const &Name) const {
+  return (Path / Name).string();
+}
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: BSD-2-Clause
+//
+// This code has been produced by the European Spallation Source
+// and its partner institutes under the BSD 2 Clause License.
+//
+// See LICENSE.md at the top level for license information.
+//
+// Screaming Udder!                              https://esss.se
+
+#pragma once
+
+#include "Filesystem.h"
+#include <string>
+
+/// \brief A uniquely named directory (in the temporary directory of the
+/// system) for the files of a test, removed with its contents on destruction.
+///
+/// Use as a member of a test fixture so that every test, also when tests run
+/// in parallel, gets its own directory.
+class TemporaryDirectory {
+public:
+  /// \param Prefix Prefix of the name of the directory, e.g. the name of the
+  /// tests.
+  explicit TemporaryDirectory(std::string const &Prefix);
+  ~TemporaryDirectory();
+  TemporaryDirectory(TemporaryDirectory const &) = delete;
+  TemporaryDirectory &operator=(TemporaryDirectory const &) = delete;
+
+  fs::path const &path() const { return Path; }
+
+  /// \brief The path of a file (which is not created) in the directory.
+  std::string filePath(std::string const &Name) const;
+
+private:
+  fs::path Path;
+};